@@ -0,0 +1,1403 @@
+/***************************************************************************
+*                      Numeric File Sort Using the Library
+*
+*   File    : numsort.c
+*   Purpose : This program sorts files of numbers with the sort library,
+*             as a faster alternative to "sort -n" for numeric data.  It
+*             reads newline delimited integers or floating point values,
+*             or binary records with a native numeric key, from files or
+*             stdin.  Files are memory mapped where possible, and anything
+*             else is read in large blocks.  Eight digits of an integer are
+*             parsed at a time using the bits of a 64-bit word, and
+*             integers are written with a table of digit pairs into a large
+*             output buffer.  The time spent reading, parsing, sorting, and
+*             writing may be reported.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* numsort: A numeric file sort built on the sort library
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+#ifndef _WIN32
+/* mmap, fstat, and clock_gettime are not declared in strict ANSI mode */
+#define _POSIX_C_SOURCE 200112L
+#define NUMSORT_MMAP
+#endif
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include "sort.h"
+#include "optlist/optlist.h"
+
+#ifdef NUMSORT_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* size of the blocks read from stdin and of the output buffer */
+#define READ_BLOCK_BYTES    (1UL << 20)
+#define WRITE_BUFFER_BYTES  (1UL << 20)
+
+/* room for the longest formatted value and its newline */
+#define MAX_VALUE_CHARS     32
+
+/* longest line of a floating point value that isn't newline terminated */
+#define MAX_LINE_CHARS      512
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) && \
+    (ULONG_MAX > 0xFFFFFFFFUL)
+/* 8 digits may be parsed at once in an unsigned long */
+#define PARSE_SWAR
+#endif
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+typedef enum
+{
+    ENGINE_AUTO,
+    ENGINE_RADIX,
+    ENGINE_QUICK,
+    ENGINE_QUICK_3WAY,
+    ENGINE_DUAL_PIVOT,
+    ENGINE_MERGE,
+    ENGINE_BLOCK_MERGE,
+    ENGINE_NATURAL_MERGE,
+    ENGINE_HEAP,
+    ENGINE_SHELL,
+    ENGINE_SAMPLE
+} engine_t;
+
+/* names of the engines on the command line */
+typedef struct
+{
+    const char *name;
+    engine_t engine;
+} engine_name_t;
+
+/* types of binary keys on the command line */
+typedef struct
+{
+    const char *name;
+    sort_key_t keyType;
+    size_t size;
+    int (*compareFunc)(const void *, const void *);
+} key_name_t;
+
+/* the contents of an input file */
+typedef struct
+{
+    char *data;
+    size_t size;
+    int mapped;                 /* non-zero if data is memory mapped */
+} input_t;
+
+/* values or records read from the inputs */
+typedef struct
+{
+    char *items;
+    size_t numItems;
+    size_t capacity;            /* number of items that fit in items */
+    size_t itemSize;
+} item_array_t;
+
+/* buffered output */
+typedef struct
+{
+    FILE *fp;
+    char *buffer;
+    size_t used;
+    int failed;                 /* non-zero after a write fails */
+} output_t;
+
+/* phases that are timed */
+typedef enum
+{
+    PHASE_READ,
+    PHASE_PARSE,
+    PHASE_SORT,
+    PHASE_WRITE,
+    NUM_PHASES
+} phase_t;
+
+/***************************************************************************
+*                                 MACROS
+***************************************************************************/
+/* define a comparison of keys of a type at keyOffset in each record */
+#define DEFINE_COMPARE(name, type)                                      \
+static int name(const void *a, const void *b)                           \
+{                                                                       \
+    type x, y;                                                          \
+                                                                        \
+    memcpy(&x, (const char *)a + keyOffset, sizeof(x));                 \
+    memcpy(&y, (const char *)b + keyOffset, sizeof(y));                 \
+    return (x > y) - (x < y);                                           \
+}
+
+/* define a comparison of floating point keys that orders them the way the
+ * radix engine does (by their bits with the sign flipped), so every engine
+ * agrees.  Negative NaNs come before -inf, positive NaNs after +inf, and -0
+ * before +0.  If the key isn't the size of bitsType, NaNs go last. */
+#define DEFINE_COMPARE_FLOAT(name, type, bitsType)                      \
+static int name(const void *a, const void *b)                           \
+{                                                                       \
+    type x, y;                                                          \
+    bitsType bx, by, sign;                                              \
+                                                                        \
+    memcpy(&x, (const char *)a + keyOffset, sizeof(x));                 \
+    memcpy(&y, (const char *)b + keyOffset, sizeof(y));                 \
+                                                                        \
+    if (sizeof(type) != sizeof(bitsType))                               \
+    {                                                                   \
+        return ((x > y) || ((x != x) && (y == y))) -                    \
+            ((x < y) || ((y != y) && (x == x)));                        \
+    }                                                                   \
+                                                                        \
+    memcpy(&bx, (const char *)a + keyOffset, sizeof(bx));               \
+    memcpy(&by, (const char *)b + keyOffset, sizeof(by));               \
+    sign = ~(~(bitsType)0 >> 1);                                        \
+    bx = (bx & sign) ? ~bx : (bx | sign);                               \
+    by = (by & sign) ? ~by : (by | sign);                               \
+    return (bx > by) - (bx < by);                                       \
+}
+
+/***************************************************************************
+*                            GLOBAL VARIABLES
+***************************************************************************/
+/* offset of the key in each record, used by the comparison functions */
+static size_t keyOffset = 0;
+
+static const char digitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233"
+    "34353637383940414243444546474849505152535455565758596061626364656667"
+    "6869707172737475767778798081828384858687888990919293949596979899";
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+DEFINE_COMPARE(CompareInt, int)
+DEFINE_COMPARE(CompareUInt, unsigned int)
+DEFINE_COMPARE(CompareLong, long)
+DEFINE_COMPARE(CompareULong, unsigned long)
+DEFINE_COMPARE_FLOAT(CompareFloat, float, unsigned int)
+DEFINE_COMPARE_FLOAT(CompareDouble, double, unsigned long)
+
+static const engine_name_t engineNames[] =
+{
+    {"auto", ENGINE_AUTO},
+    {"radix", ENGINE_RADIX},
+    {"quick", ENGINE_QUICK},
+    {"3way", ENGINE_QUICK_3WAY},
+    {"dual", ENGINE_DUAL_PIVOT},
+    {"merge", ENGINE_MERGE},
+    {"block", ENGINE_BLOCK_MERGE},
+    {"natural", ENGINE_NATURAL_MERGE},
+    {"heap", ENGINE_HEAP},
+    {"shell", ENGINE_SHELL},
+    {"sample", ENGINE_SAMPLE},
+    {NULL, ENGINE_AUTO}
+};
+
+static const key_name_t keyNames[] =
+{
+    {"int", SORT_KEY_INT, sizeof(int), CompareInt},
+    {"uint", SORT_KEY_UINT, sizeof(unsigned int), CompareUInt},
+    {"long", SORT_KEY_LONG, sizeof(long), CompareLong},
+    {"ulong", SORT_KEY_ULONG, sizeof(unsigned long), CompareULong},
+    {"float", SORT_KEY_FLOAT, sizeof(float), CompareFloat},
+    {"double", SORT_KEY_DOUBLE, sizeof(double), CompareDouble},
+    {NULL, SORT_KEY_NONE, 0, NULL}
+};
+
+static void ShowUsage(const char *progPath);
+static double Now(void);
+
+static int ReadInput(const char *fileName, input_t *input);
+static void FreeInput(input_t *input);
+static int ReadStream(FILE *fp, input_t *input);
+
+static int ReserveItems(item_array_t *array, size_t numItems);
+static int ParseIntegers(const input_t *input, item_array_t *array,
+    const char *name);
+static int ParseFloats(const input_t *input, item_array_t *array,
+    const char *name);
+static const char *ParseLong(const char *p, const char *end, long *value);
+#ifdef PARSE_SWAR
+static int IsEightDigits(unsigned long chunk);
+static unsigned long EightDigits(unsigned long chunk);
+#endif
+
+static sort_error_t SortItems(item_array_t *array, engine_t engine,
+    sort_key_t keyType, int (*compareFunc)(const void *, const void *),
+    unsigned int numThreads);
+static size_t RemoveDuplicates(item_array_t *array,
+    int (*compareFunc)(const void *, const void *));
+static void ReverseItems(item_array_t *array);
+
+static void OutputFlush(output_t *out);
+static char *FormatLong(char *out, long value);
+static char *FormatDouble(char *out, double value);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : main
+*   Description: This is the main function for this program.  It reads
+*                the inputs, sorts their values, and writes them out.
+*   Parameters : argc - number of parameters
+*                argv - parameter list
+*   Effects    : The sorted values are written to the output
+*   Returned   : EXIT_SUCCESS or EXIT_FAILURE
+***************************************************************************/
+int main(int argc, char *argv[])
+{
+    option_t *optList, *thisOpt;
+    const char *inputs[64];             /* input file names */
+    size_t numInputs, i;
+    const char *outName;                /* output file name, NULL stdout */
+    const key_name_t *binaryKey;        /* key of binary records */
+    size_t recordSize;                  /* size of binary records */
+    engine_t engine;
+    unsigned int numThreads;
+    int isFloat, unique, reverse, timings, ok;
+    double phaseTime[NUM_PHASES], start;
+    item_array_t array;
+    input_t input;
+    output_t out;
+    sort_key_t keyType;
+    int (*compareFunc)(const void *, const void *);
+    char *formatted;
+
+    /* initialize variables */
+    numInputs = 0;
+    outName = NULL;
+    binaryKey = NULL;
+    recordSize = 0;
+    engine = ENGINE_AUTO;
+    numThreads = 0;
+    isFloat = 0;
+    unique = 0;
+    reverse = 0;
+    timings = 0;
+    ok = 1;
+
+    /* parse command line */
+    optList = GetOptList(argc, argv, "i:o:b:s:k:e:t:p:gurv?");
+    thisOpt = optList;
+
+    while (thisOpt != NULL)
+    {
+        switch(thisOpt->option)
+        {
+            case 'i':       /* input file */
+                if (numInputs < (sizeof(inputs) / sizeof(inputs[0])))
+                {
+                    inputs[numInputs] = thisOpt->argument;
+                    numInputs++;
+                }
+                else
+                {
+                    fprintf(stderr, "numsort: too many input files\n");
+                    ok = 0;
+                }
+                break;
+
+            case 'o':       /* output file */
+                outName = thisOpt->argument;
+                break;
+
+            case 'b':       /* binary records with a numeric key */
+                for (i = 0; NULL != keyNames[i].name; i++)
+                {
+                    if (0 == strcmp(keyNames[i].name, thisOpt->argument))
+                    {
+                        binaryKey = &keyNames[i];
+                    }
+                }
+
+                if (NULL == binaryKey)
+                {
+                    fprintf(stderr, "numsort: unknown key type %s\n",
+                        thisOpt->argument);
+                    ok = 0;
+                }
+                break;
+
+            case 's':       /* record size */
+                recordSize = (size_t)atol(thisOpt->argument);
+                break;
+
+            case 'k':       /* key offset */
+                keyOffset = (size_t)atol(thisOpt->argument);
+                break;
+
+            case 'e':       /* sort engine */
+                for (i = 0; NULL != engineNames[i].name; i++)
+                {
+                    if (0 == strcmp(engineNames[i].name, thisOpt->argument))
+                    {
+                        engine = engineNames[i].engine;
+                        break;
+                    }
+                }
+
+                if (NULL == engineNames[i].name)
+                {
+                    fprintf(stderr, "numsort: unknown engine %s\n",
+                        thisOpt->argument);
+                    ok = 0;
+                }
+                break;
+
+            case 't':       /* number of threads */
+                numThreads = (unsigned int)atoi(thisOpt->argument);
+                break;
+
+            case 'p':       /* tuning profile */
+                if (!SortLoadTuning(thisOpt->argument))
+                {
+                    fprintf(stderr, "numsort: unable to read %s, "
+                        "using default thresholds\n", thisOpt->argument);
+                }
+                break;
+
+            case 'g':       /* floating point text */
+                isFloat = 1;
+                break;
+
+            case 'u':       /* remove duplicates */
+                unique = 1;
+                break;
+
+            case 'r':       /* descending order */
+                reverse = 1;
+                break;
+
+            case 'v':       /* report phase timings */
+                timings = 1;
+                break;
+
+            case '?':
+                ShowUsage(argv[0]);
+                FreeOptList(optList);
+                return EXIT_SUCCESS;
+        }
+
+        optList = thisOpt->next;
+        free(thisOpt);
+        thisOpt = optList;
+    }
+
+    if (NULL != binaryKey)
+    {
+        if (0 == recordSize)
+        {
+            recordSize = binaryKey->size;
+        }
+
+        if ((keyOffset > recordSize) ||
+            (binaryKey->size > recordSize - keyOffset))
+        {
+            fprintf(stderr, "numsort: the key doesn't fit in a record\n");
+            ok = 0;
+        }
+
+        keyType = binaryKey->keyType;
+        compareFunc = binaryKey->compareFunc;
+        array.itemSize = recordSize;
+    }
+    else if (isFloat)
+    {
+        keyType = SORT_KEY_DOUBLE;
+        compareFunc = CompareDouble;
+        array.itemSize = sizeof(double);
+    }
+    else
+    {
+        keyType = SORT_KEY_LONG;
+        compareFunc = CompareLong;
+        array.itemSize = sizeof(long);
+    }
+
+    if (!ok)
+    {
+        ShowUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (0 != numThreads)
+    {
+        SortPoolStart(numThreads, 0);
+    }
+
+    array.items = NULL;
+    array.numItems = 0;
+    array.capacity = 0;
+
+    for (i = 0; i < NUM_PHASES; i++)
+    {
+        phaseTime[i] = 0;
+    }
+
+    /* read and parse each input, stdin if there are none */
+    for (i = 0; ok && (i < ((0 == numInputs) ? 1 : numInputs)); i++)
+    {
+        start = Now();
+        ok = ReadInput((0 == numInputs) ? NULL : inputs[i], &input);
+        phaseTime[PHASE_READ] += Now() - start;
+
+        if (!ok)
+        {
+            break;
+        }
+
+        start = Now();
+
+        if (NULL != binaryKey)
+        {
+            if (0 != (input.size % recordSize))
+            {
+                fprintf(stderr, "numsort: %s isn't a whole number of "
+                    "records\n", (0 == numInputs) ? "stdin" : inputs[i]);
+                ok = 0;
+            }
+            else if (ReserveItems(&array, input.size / recordSize))
+            {
+                memcpy(array.items + (array.numItems * recordSize),
+                    input.data, input.size);
+                array.numItems += input.size / recordSize;
+            }
+            else
+            {
+                ok = 0;
+            }
+        }
+        else if (isFloat)
+        {
+            ok = ParseFloats(&input, &array,
+                (0 == numInputs) ? "stdin" : inputs[i]);
+        }
+        else
+        {
+            ok = ParseIntegers(&input, &array,
+                (0 == numInputs) ? "stdin" : inputs[i]);
+        }
+
+        phaseTime[PHASE_PARSE] += Now() - start;
+        FreeInput(&input);
+    }
+
+    if (ok)
+    {
+        start = Now();
+
+        if (SORT_OK != SortItems(&array, engine, keyType, compareFunc,
+            numThreads))
+        {
+            fprintf(stderr, "numsort: out of memory\n");
+            ok = 0;
+        }
+
+        if (unique)
+        {
+            array.numItems = RemoveDuplicates(&array, compareFunc);
+        }
+
+        if (reverse)
+        {
+            ReverseItems(&array);
+        }
+
+        phaseTime[PHASE_SORT] = Now() - start;
+    }
+
+    if (ok)
+    {
+        start = Now();
+        out.fp = (NULL == outName) ? stdout : fopen(outName, "wb");
+        out.buffer = (char *)malloc(WRITE_BUFFER_BYTES);
+        out.used = 0;
+        out.failed = 0;
+
+        if ((NULL == out.fp) || (NULL == out.buffer))
+        {
+            fprintf(stderr, "numsort: unable to open %s\n",
+                (NULL == outName) ? "stdout" : outName);
+            ok = 0;
+        }
+        else if (NULL != binaryKey)
+        {
+            OutputFlush(&out);
+
+            if (array.numItems != fwrite(array.items, recordSize,
+                array.numItems, out.fp))
+            {
+                out.failed = 1;
+            }
+        }
+        else
+        {
+            for (i = 0; i < array.numItems; i++)
+            {
+                if ((WRITE_BUFFER_BYTES - out.used) < MAX_VALUE_CHARS)
+                {
+                    OutputFlush(&out);
+                }
+
+                formatted = out.buffer + out.used;
+
+                if (isFloat)
+                {
+                    formatted = FormatDouble(formatted,
+                        ((double *)array.items)[i]);
+                }
+                else
+                {
+                    formatted = FormatLong(formatted,
+                        ((long *)array.items)[i]);
+                }
+
+                *formatted = '\n';
+                out.used = (formatted + 1) - out.buffer;
+            }
+        }
+
+        if (NULL != out.fp)
+        {
+            OutputFlush(&out);
+
+            if (0 != fflush(out.fp))
+            {
+                out.failed = 1;
+            }
+
+            if ((NULL != outName) && (0 != fclose(out.fp)))
+            {
+                out.failed = 1;
+            }
+
+            if (out.failed)
+            {
+                fprintf(stderr, "numsort: error writing %s\n",
+                    (NULL == outName) ? "stdout" : outName);
+                ok = 0;
+            }
+        }
+
+        free(out.buffer);
+        phaseTime[PHASE_WRITE] = Now() - start;
+    }
+
+    if (timings)
+    {
+        fprintf(stderr, "items: %lu\n", (unsigned long)array.numItems);
+        fprintf(stderr, "read:  %.3f s\n", phaseTime[PHASE_READ]);
+        fprintf(stderr, "parse: %.3f s\n", phaseTime[PHASE_PARSE]);
+        fprintf(stderr, "sort:  %.3f s\n", phaseTime[PHASE_SORT]);
+        fprintf(stderr, "write: %.3f s\n", phaseTime[PHASE_WRITE]);
+    }
+
+    free(array.items);
+    SortPoolStop();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***************************************************************************
+*   Function   : Now
+*   Description: This function returns the current time for timing the
+*                phases of the sort.  A monotonic wall clock is used where
+*                it's available, because the sort may use several threads.
+*   Parameters : NONE
+*   Effects    : NONE
+*   Returned   : The time in seconds from an arbitrary start.
+***************************************************************************/
+static double Now(void)
+{
+#if defined(NUMSORT_MMAP) && defined(CLOCK_MONOTONIC)
+    struct timespec now;
+
+    if (0 == clock_gettime(CLOCK_MONOTONIC, &now))
+    {
+        return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+    }
+#endif
+
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+/***************************************************************************
+*   Function   : ReadInput
+*   Description: This function reads the whole contents of an input.
+*                Regular files are memory mapped if possible; stdin and
+*                anything that can't be mapped are read in large blocks.
+*   Parameters : fileName - name of the file, NULL for stdin
+*                input - receives the contents
+*   Effects    : An error message is written if the input can't be read
+*   Returned   : Non-zero for success, 0 for failure.
+***************************************************************************/
+static int ReadInput(const char *fileName, input_t *input)
+{
+    FILE *fp;
+    int ok;
+#ifdef NUMSORT_MMAP
+    struct stat info;
+    void *mapped;
+    int fd;
+#endif
+
+    input->data = NULL;
+    input->size = 0;
+    input->mapped = 0;
+
+    if (NULL == fileName)
+    {
+        if (!ReadStream(stdin, input))
+        {
+            fprintf(stderr, "numsort: error reading stdin\n");
+            return 0;
+        }
+
+        return 1;
+    }
+
+#ifdef NUMSORT_MMAP
+    fd = open(fileName, O_RDONLY);
+
+    if (fd < 0)
+    {
+        fprintf(stderr, "numsort: unable to open %s\n", fileName);
+        return 0;
+    }
+
+    if ((0 == fstat(fd, &info)) && S_ISREG(info.st_mode) &&
+        (info.st_size > 0) && ((off_t)(size_t)info.st_size == info.st_size))
+    {
+        mapped = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE,
+            fd, 0);
+
+        if (MAP_FAILED != mapped)
+        {
+            /* the file is read once, from start to end */
+            posix_madvise(mapped, (size_t)info.st_size,
+                POSIX_MADV_SEQUENTIAL);
+            close(fd);
+
+            input->data = (char *)mapped;
+            input->size = (size_t)info.st_size;
+            input->mapped = 1;
+            return 1;
+        }
+    }
+
+    close(fd);
+#endif
+
+    fp = fopen(fileName, "rb");
+
+    if (NULL == fp)
+    {
+        fprintf(stderr, "numsort: unable to open %s\n", fileName);
+        return 0;
+    }
+
+    ok = ReadStream(fp, input);
+    fclose(fp);
+
+    if (!ok)
+    {
+        fprintf(stderr, "numsort: error reading %s\n", fileName);
+    }
+
+    return ok;
+}
+
+/***************************************************************************
+*   Function   : ReadStream
+*   Description: This function reads a stream into memory in large blocks,
+*                doubling the buffer as it fills.
+*   Parameters : fp - stream to read
+*                input - receives the contents
+*   Effects    : The stream is read to its end
+*   Returned   : Non-zero for success, 0 for failure.
+***************************************************************************/
+static int ReadStream(FILE *fp, input_t *input)
+{
+    size_t capacity, count;
+    char *grown;
+
+    capacity = 0;
+
+    for (;;)
+    {
+        if ((capacity - input->size) < READ_BLOCK_BYTES)
+        {
+            capacity = (0 == capacity) ? READ_BLOCK_BYTES : (2 * capacity);
+            grown = (char *)realloc(input->data, capacity);
+
+            if (NULL == grown)
+            {
+                FreeInput(input);
+                return 0;
+            }
+
+            input->data = grown;
+        }
+
+        count = fread(input->data + input->size, 1, capacity - input->size,
+            fp);
+        input->size += count;
+
+        if (0 == count)
+        {
+            break;
+        }
+    }
+
+    if (ferror(fp))
+    {
+        FreeInput(input);
+        return 0;
+    }
+
+    return 1;
+}
+
+/***************************************************************************
+*   Function   : FreeInput
+*   Description: This function releases the contents of an input.
+*   Parameters : input - the input to release
+*   Effects    : The input's memory is unmapped or freed
+*   Returned   : NONE
+***************************************************************************/
+static void FreeInput(input_t *input)
+{
+#ifdef NUMSORT_MMAP
+    if (input->mapped)
+    {
+        munmap(input->data, input->size);
+        input->data = NULL;
+        return;
+    }
+#endif
+
+    free(input->data);
+    input->data = NULL;
+}
+
+/***************************************************************************
+*   Function   : ReserveItems
+*   Description: This function makes room for more items in an array,
+*                at least doubling its capacity when it grows.
+*   Parameters : array - the array
+*                numItems - number of items to add
+*   Effects    : The array may be reallocated
+*   Returned   : Non-zero for success, 0 if memory isn't available.
+***************************************************************************/
+static int ReserveItems(item_array_t *array, size_t numItems)
+{
+    size_t capacity;
+    char *grown;
+
+    if ((array->capacity - array->numItems) >= numItems)
+    {
+        return 1;
+    }
+
+    capacity = 2 * array->capacity;
+
+    if (capacity < (array->numItems + numItems))
+    {
+        capacity = array->numItems + numItems;
+    }
+
+    grown = (char *)realloc(array->items, capacity * array->itemSize);
+
+    if (NULL == grown)
+    {
+        fprintf(stderr, "numsort: out of memory\n");
+        return 0;
+    }
+
+    array->items = grown;
+    array->capacity = capacity;
+    return 1;
+}
+
+/***************************************************************************
+*   Function   : ParseIntegers
+*   Description: This function parses an input of newline delimited
+*                integers, each with an optional sign and with optional
+*                spaces before or after it.  Blank lines are skipped.
+*   Parameters : input - the input to parse
+*                array - array of longs receiving the values
+*                name - name of the input for error messages
+*   Effects    : The values are appended to array
+*   Returned   : Non-zero for success, 0 for failure.
+***************************************************************************/
+static int ParseIntegers(const input_t *input, item_array_t *array,
+    const char *name)
+{
+    const char *p, *end;
+    unsigned long line;
+    long value;
+
+    p = input->data;
+    end = p + input->size;
+    line = 1;
+
+    while (p < end)
+    {
+        while ((p < end) && ((' ' == *p) || ('\t' == *p) || ('\r' == *p)))
+        {
+            p++;
+        }
+
+        if ((p < end) && ('\n' != *p))
+        {
+            p = ParseLong(p, end, &value);
+
+            while ((NULL != p) && (p < end) &&
+                ((' ' == *p) || ('\t' == *p) || ('\r' == *p)))
+            {
+                p++;
+            }
+
+            if ((NULL == p) || ((p < end) && ('\n' != *p)))
+            {
+                fprintf(stderr, "numsort: %s line %lu isn't a long integer\n",
+                    name, line);
+                return 0;
+            }
+
+            if ((array->numItems == array->capacity) &&
+                !ReserveItems(array, 1))
+            {
+                return 0;
+            }
+
+            ((long *)array->items)[array->numItems] = value;
+            array->numItems++;
+        }
+
+        /* step over the newline */
+        p++;
+        line++;
+    }
+
+    return 1;
+}
+
+/***************************************************************************
+*   Function   : ParseLong
+*   Description: This function parses an integer with an optional sign.
+*                Where an unsigned long has 64 bits, eight digits at a
+*                time are checked and converted with a few multiplies of
+*                the whole word.
+*   Parameters : p - first character of the integer
+*                end - end of the input
+*                value - receives the value
+*   Effects    : NONE
+*   Returned   : Pointer to the character after the integer, NULL if there
+*                aren't any digits or the value doesn't fit in a long.
+***************************************************************************/
+static const char *ParseLong(const char *p, const char *end, long *value)
+{
+    const char *first;
+    unsigned long magnitude, digit, limit;
+    int negative;
+#ifdef PARSE_SWAR
+    unsigned long chunk;
+#endif
+
+    negative = 0;
+
+    if (('-' == *p) || ('+' == *p))
+    {
+        negative = ('-' == *p);
+        p++;
+    }
+
+    first = p;
+    magnitude = 0;
+
+#ifdef PARSE_SWAR
+    while (((size_t)(end - p) >= sizeof(chunk)) &&
+        (magnitude <= ((ULONG_MAX - 99999999UL) / 100000000UL)))
+    {
+        memcpy(&chunk, p, sizeof(chunk));
+
+        if (!IsEightDigits(chunk))
+        {
+            break;
+        }
+
+        magnitude = (magnitude * 100000000UL) + EightDigits(chunk);
+        p += sizeof(chunk);
+    }
+#endif
+
+    for (; (p < end) && (*p >= '0') && (*p <= '9'); p++)
+    {
+        digit = (unsigned long)(*p - '0');
+
+        if (magnitude > ((ULONG_MAX - digit) / 10))
+        {
+            return NULL;
+        }
+
+        magnitude = (magnitude * 10) + digit;
+    }
+
+    /* the magnitude of LONG_MIN is one more than LONG_MAX */
+    limit = (unsigned long)LONG_MAX + (negative ? 1 : 0);
+
+    if ((p == first) || (magnitude > limit))
+    {
+        return NULL;
+    }
+
+    if (negative)
+    {
+        *value = (magnitude == limit) ? LONG_MIN :
+            -(long)magnitude;
+    }
+    else
+    {
+        *value = (long)magnitude;
+    }
+
+    return p;
+}
+
+#ifdef PARSE_SWAR
+/***************************************************************************
+*   Function   : IsEightDigits
+*   Description: This function checks if every byte of a word is an ASCII
+*                digit.  A digit's high nibble is 3, and adding 6 to its
+*                low nibble doesn't carry into the high nibble.
+*   Parameters : chunk - eight characters read as a little endian word
+*   Effects    : NONE
+*   Returned   : Non-zero if all eight characters are digits.
+***************************************************************************/
+static int IsEightDigits(unsigned long chunk)
+{
+    return (((chunk & 0xF0F0F0F0F0F0F0F0UL) |
+        (((chunk + 0x0606060606060606UL) & 0xF0F0F0F0F0F0F0F0UL) >> 4)) ==
+        0x3333333333333333UL);
+}
+
+/***************************************************************************
+*   Function   : EightDigits
+*   Description: This function converts eight ASCII digits to their value.
+*                Adjacent digits are combined into pairs, pairs into
+*                groups of four, and the groups into the result, each step
+*                with one multiply and shift of the whole word.
+*   Parameters : chunk - eight digits read as a little endian word
+*   Effects    : NONE
+*   Returned   : The value of the digits (0 to 99999999).
+***************************************************************************/
+static unsigned long EightDigits(unsigned long chunk)
+{
+    chunk = ((chunk & 0x0F0F0F0F0F0F0F0FUL) * 2561) >> 8;
+    chunk = ((chunk & 0x00FF00FF00FF00FFUL) * 6553601) >> 16;
+    return (((chunk & 0x0000FFFF0000FFFFUL) * 42949672960001UL) >> 32) &
+        0xFFFFFFFFUL;
+}
+#endif
+
+/***************************************************************************
+*   Function   : ParseFloats
+*   Description: This function parses an input of newline delimited
+*                floating point values with strtod.  Blank lines are
+*                skipped.  A last line without a newline is copied so that
+*                strtod doesn't read past the end of the input.
+*   Parameters : input - the input to parse
+*                array - array of doubles receiving the values
+*                name - name of the input for error messages
+*   Effects    : The values are appended to array
+*   Returned   : Non-zero for success, 0 for failure.
+***************************************************************************/
+static int ParseFloats(const input_t *input, item_array_t *array,
+    const char *name)
+{
+    const char *p, *end, *lineEnd;
+    char lastLine[MAX_LINE_CHARS];
+    char *parsed;
+    unsigned long line;
+    double value;
+
+    p = input->data;
+    end = p + input->size;
+    line = 1;
+
+    while (p < end)
+    {
+        lineEnd = (const char *)memchr(p, '\n', end - p);
+
+        if (NULL == lineEnd)
+        {
+            /* the last line isn't newline terminated */
+            if ((size_t)(end - p) >= sizeof(lastLine))
+            {
+                fprintf(stderr, "numsort: %s line %lu is too long\n", name,
+                    line);
+                return 0;
+            }
+
+            memcpy(lastLine, p, end - p);
+            lastLine[end - p] = '\0';
+            p = lastLine;
+            end = lastLine + strlen(lastLine);
+            lineEnd = end;
+        }
+
+        while ((p < lineEnd) && ((' ' == *p) || ('\t' == *p) || ('\r' == *p)))
+        {
+            p++;
+        }
+
+        if (p < lineEnd)
+        {
+            value = strtod(p, &parsed);
+
+            while ((parsed < lineEnd) &&
+                ((' ' == *parsed) || ('\t' == *parsed) || ('\r' == *parsed)))
+            {
+                parsed++;
+            }
+
+            if ((parsed == p) || (parsed != lineEnd))
+            {
+                fprintf(stderr, "numsort: %s line %lu isn't a number\n",
+                    name, line);
+                return 0;
+            }
+
+            if ((array->numItems == array->capacity) &&
+                !ReserveItems(array, 1))
+            {
+                return 0;
+            }
+
+            ((double *)array->items)[array->numItems] = value;
+            array->numItems++;
+        }
+
+        p = lineEnd + 1;
+        line++;
+    }
+
+    return 1;
+}
+
+/***************************************************************************
+*   Function   : SortItems
+*   Description: This function sorts the items with the chosen engine.
+*                Engines that need a numeric key at the start of each item
+*                fall back to a comparison sort for other records.
+*   Parameters : array - the items to sort
+*                engine - the engine to use
+*                keyType - type of each item's key
+*                compareFunc - function comparing items
+*                numThreads - threads for samplesort, 0 for one per
+*                             processor
+*   Effects    : The items are sorted in ascending order
+*   Returned   : SORT_OK for success, otherwise an error.
+***************************************************************************/
+static sort_error_t SortItems(item_array_t *array, engine_t engine,
+    sort_key_t keyType, int (*compareFunc)(const void *, const void *),
+    unsigned int numThreads)
+{
+    void *list;
+    size_t numItems, itemSize;
+
+    list = array->items;
+    numItems = array->numItems;
+    itemSize = array->itemSize;
+
+    switch (engine)
+    {
+        case ENGINE_RADIX:
+            return RadixSortNumericCtx(NULL, list, numItems, itemSize,
+                keyOffset, keyType);
+
+        case ENGINE_QUICK:
+            return QuickSortCtx(NULL, list, numItems, itemSize, compareFunc);
+
+        case ENGINE_QUICK_3WAY:
+            return QuickSort3WayCtx(NULL, list, numItems, itemSize,
+                compareFunc);
+
+        case ENGINE_DUAL_PIVOT:
+            return DualPivotQuickSortCtx(NULL, list, numItems, itemSize,
+                compareFunc);
+
+        case ENGINE_MERGE:
+            return MergeSortCtx(NULL, list, numItems, itemSize, compareFunc);
+
+        case ENGINE_BLOCK_MERGE:
+            return BlockMergeSortCtx(NULL, list, numItems, itemSize,
+                compareFunc);
+
+        case ENGINE_NATURAL_MERGE:
+            return NaturalMergeSortCtx(NULL, list, numItems, itemSize,
+                compareFunc);
+
+        case ENGINE_HEAP:
+            return HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+
+        case ENGINE_SHELL:
+            return ShellSortCtx(NULL, list, numItems, itemSize, compareFunc);
+
+        case ENGINE_SAMPLE:
+            return ParallelSampleSortCtx(NULL, list, numItems, itemSize,
+                compareFunc, numThreads);
+
+        default:
+            /* SortAuto can only radix sort keys at the start of items */
+            return SortAutoCtx(NULL, list, numItems, itemSize, compareFunc,
+                (0 == keyOffset) ? keyType : SORT_KEY_NONE, NULL);
+    }
+}
+
+/***************************************************************************
+*   Function   : RemoveDuplicates
+*   Description: This function removes all but the first of each run of
+*                equal items from a sorted array.
+*   Parameters : array - the sorted items
+*                compareFunc - function comparing items
+*   Effects    : The distinct items are moved to the start of the array
+*   Returned   : The number of distinct items
+***************************************************************************/
+static size_t RemoveDuplicates(item_array_t *array,
+    int (*compareFunc)(const void *, const void *))
+{
+    char *items;
+    size_t i, kept, itemSize;
+
+    if (0 == array->numItems)
+    {
+        return 0;
+    }
+
+    items = array->items;
+    itemSize = array->itemSize;
+    kept = 1;
+
+    for (i = 1; i < array->numItems; i++)
+    {
+        if (0 != compareFunc(items + ((kept - 1) * itemSize),
+            items + (i * itemSize)))
+        {
+            if (kept != i)
+            {
+                memcpy(items + (kept * itemSize), items + (i * itemSize),
+                    itemSize);
+            }
+
+            kept++;
+        }
+    }
+
+    return kept;
+}
+
+/***************************************************************************
+*   Function   : ReverseItems
+*   Description: This function reverses the order of the items in an
+*                array.
+*   Parameters : array - the items
+*   Effects    : The items are in the opposite order
+*   Returned   : NONE
+***************************************************************************/
+static void ReverseItems(item_array_t *array)
+{
+    char *low, *high;
+    char temp;
+    size_t i;
+
+    if (array->numItems < 2)
+    {
+        return;
+    }
+
+    low = array->items;
+    high = array->items + ((array->numItems - 1) * array->itemSize);
+
+    while (low < high)
+    {
+        for (i = 0; i < array->itemSize; i++)
+        {
+            temp = low[i];
+            low[i] = high[i];
+            high[i] = temp;
+        }
+
+        low += array->itemSize;
+        high -= array->itemSize;
+    }
+}
+
+/***************************************************************************
+*   Function   : OutputFlush
+*   Description: This function writes the contents of the output buffer.
+*   Parameters : out - the output
+*   Effects    : The buffer is written and emptied
+*   Returned   : NONE
+***************************************************************************/
+static void OutputFlush(output_t *out)
+{
+    if ((0 != out->used) &&
+        (out->used != fwrite(out->buffer, 1, out->used, out->fp)))
+    {
+        out->failed = 1;
+    }
+
+    out->used = 0;
+}
+
+/***************************************************************************
+*   Function   : FormatLong
+*   Description: This function formats an integer in decimal.  Digits are
+*                produced two at a time from a table of digit pairs, from
+*                the least significant end.
+*   Parameters : out - buffer with room for at least MAX_VALUE_CHARS
+*                value - the value to format
+*   Effects    : The digits are written to out
+*   Returned   : Pointer to the character after the last digit
+***************************************************************************/
+static char *FormatLong(char *out, long value)
+{
+    char digits[MAX_VALUE_CHARS];
+    unsigned long magnitude, pair;
+    size_t first;
+
+    if (value < 0)
+    {
+        *out = '-';
+        out++;
+        magnitude = 0UL - (unsigned long)value;
+    }
+    else
+    {
+        magnitude = (unsigned long)value;
+    }
+
+    first = sizeof(digits);
+
+    while (magnitude >= 100)
+    {
+        pair = magnitude % 100;
+        magnitude /= 100;
+        first -= 2;
+        memcpy(digits + first, digitPairs + (2 * pair), 2);
+    }
+
+    if (magnitude >= 10)
+    {
+        first -= 2;
+        memcpy(digits + first, digitPairs + (2 * magnitude), 2);
+    }
+    else
+    {
+        first--;
+        digits[first] = (char)('0' + magnitude);
+    }
+
+    memcpy(out, digits + first, sizeof(digits) - first);
+    return out + (sizeof(digits) - first);
+}
+
+/***************************************************************************
+*   Function   : FormatDouble
+*   Description: This function formats a floating point value with the
+*                fewest of 15 or 17 significant digits that reads back as
+*                the same value.
+*   Parameters : out - buffer with room for at least MAX_VALUE_CHARS
+*                value - the value to format
+*   Effects    : The value is written to out
+*   Returned   : Pointer to the character after the value
+***************************************************************************/
+static char *FormatDouble(char *out, double value)
+{
+    sprintf(out, "%.15g", value);
+
+    if (strtod(out, NULL) != value)
+    {
+        sprintf(out, "%.17g", value);
+    }
+
+    return out + strlen(out);
+}
+
+/***************************************************************************
+*   Function   : ShowUsage
+*   Description: This function provides usage instructions for this
+*                program.
+*   Parameters : progPath - the name + path to the executable version of
+*                           this program
+*   Effects    : Usage instructions are sent to stderr
+*   Returned   : NONE
+***************************************************************************/
+static void ShowUsage(const char *progPath)
+{
+    fprintf(stderr, "Usage: %s <options>\n\n", FindFileName(progPath));
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -i <file> : input file (repeat for more, default "
+        "stdin)\n");
+    fprintf(stderr, "  -o <file> : output file (default stdout)\n");
+    fprintf(stderr, "  -g : text values are floating point "
+        "(default integers)\n");
+    fprintf(stderr, "  -b <type> : binary records keyed by int, uint, "
+        "long, ulong, float, or double\n");
+    fprintf(stderr, "  -s <bytes> : size of binary records "
+        "(default the key size)\n");
+    fprintf(stderr, "  -k <bytes> : offset of the key in binary records "
+        "(default 0)\n");
+    fprintf(stderr, "  -e <engine> : auto, radix, quick, 3way, dual, "
+        "merge, block, natural,\n");
+    fprintf(stderr, "                heap, shell, or sample "
+        "(default auto)\n");
+    fprintf(stderr, "  -t <threads> : threads for the parallel sorts "
+        "(default all)\n");
+    fprintf(stderr, "  -p <profile> : use thresholds from profile\n");
+    fprintf(stderr, "  -u : output only the first of equal values\n");
+    fprintf(stderr, "  -r : sort in descending order\n");
+    fprintf(stderr, "  -v : report the time spent in each phase\n");
+    fprintf(stderr, "  -? : print out command line options\n\n");
+    fprintf(stderr, "Default: %s < input > output\n",
+        FindFileName(progPath));
+}
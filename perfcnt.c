@@ -0,0 +1,296 @@
+/***************************************************************************
+*                   Hardware Performance Counter Interface
+*
+*   File    : perfcnt.c
+*   Purpose : This module is used by the sort sample program to read
+*             hardware performance counters around each sort.  On Linux
+*             it uses perf_event_open.  Other systems, and Linux systems
+*             where counters are not permitted (containers, restrictive
+*             perf_event_paranoid settings, virtual machines), simply
+*             report the counters as unavailable.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* perfcnt: Hardware performance counters for the sort sample program
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/* syscall() is not declared in strict ANSI mode */
+#define _GNU_SOURCE
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <string.h>
+#include "perfcnt.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+static const char *counterNames[PERF_NUM_COUNTERS] =
+{
+    "cycles",
+    "instructions",
+    "branch misses",
+    "L1D misses",
+    "LLC misses",
+    "dTLB misses"
+};
+
+#ifdef __linux__
+/* perf_event_attr type and config for each of the counters */
+static const struct
+{
+    __u32 type;
+    __u64 config;
+} counterEvents[PERF_NUM_COUNTERS] =
+{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)}
+};
+#endif
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : PerfOpen
+*   Description: This function attempts to open each of the hardware
+*                counters for the calling process.  Counters that can't be
+*                opened are marked unavailable, and the remaining counters
+*                are still usable.  The counters are inherited by threads
+*                created after they're opened, so open them before the
+*                sort library's thread pool starts to count its work too.
+*   Parameters : counters - pointer to the counter set to initialize
+*   Effects    : Counter file descriptors are opened (disabled)
+*   Returned   : The number of counters that were successfully opened.
+*                0 if hardware counters aren't available at all.
+***************************************************************************/
+int PerfOpen(perf_counters_t *counters)
+{
+    int i;
+#ifdef __linux__
+    struct perf_event_attr attr;
+#endif
+
+    counters->numOpen = 0;
+
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+    {
+        counters->fd[i] = -1;
+        counters->value[i] = 0.0;
+
+#ifdef __linux__
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = counterEvents[i].type;
+        attr.config = counterEvents[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;    /* allowed with perf_event_paranoid 2 */
+        attr.exclude_hv = 1;
+        attr.inherit = 1;           /* include the pool's worker threads */
+
+        /* we need the running times to scale multiplexed counters */
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+            PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        counters->fd[i] = (int)syscall(__NR_perf_event_open, &attr, 0, -1,
+            -1, 0);
+
+        if (counters->fd[i] >= 0)
+        {
+            counters->numOpen++;
+        }
+        else
+        {
+            counters->fd[i] = -1;
+        }
+#endif
+    }
+
+    return counters->numOpen;
+}
+
+/***************************************************************************
+*   Function   : PerfStart
+*   Description: This function resets and enables all of the open
+*                counters.
+*   Parameters : counters - pointer to an opened counter set
+*   Effects    : Counting starts for the open counters
+*   Returned   : NONE
+***************************************************************************/
+void PerfStart(perf_counters_t *counters)
+{
+    int i;
+
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+    {
+        counters->value[i] = 0.0;
+
+#ifdef __linux__
+        if (counters->fd[i] >= 0)
+        {
+            ioctl(counters->fd[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(counters->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+}
+
+/***************************************************************************
+*   Function   : PerfStop
+*   Description: This function disables all of the open counters and
+*                reads their values.  If the kernel had to multiplex a
+*                counter, its value is scaled by the fraction of time that
+*                it was actually running.
+*   Parameters : counters - pointer to a started counter set
+*   Effects    : Counting stops and counters->value is updated
+*   Returned   : NONE
+***************************************************************************/
+void PerfStop(perf_counters_t *counters)
+{
+    int i;
+#ifdef __linux__
+    __u64 data[3];      /* value, time enabled, time running */
+
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+    {
+        if (counters->fd[i] >= 0)
+        {
+            ioctl(counters->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+    {
+        if (counters->fd[i] < 0)
+        {
+            continue;
+        }
+
+        if (read(counters->fd[i], data, sizeof(data)) != sizeof(data))
+        {
+            counters->value[i] = -1.0;      /* read failed */
+        }
+        else if (0 == data[2])
+        {
+            counters->value[i] = -1.0;      /* never got scheduled */
+        }
+        else
+        {
+            counters->value[i] = (double)data[0];
+
+            if (data[2] < data[1])
+            {
+                counters->value[i] *= (double)data[1] / (double)data[2];
+            }
+        }
+    }
+#else
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+    {
+        counters->value[i] = -1.0;
+    }
+#endif
+}
+
+/***************************************************************************
+*   Function   : PerfPrint
+*   Description: This function writes the values collected by the last
+*                PerfStop to a stream, along with instructions per cycle
+*                when both of those counters are available.
+*   Parameters : counters - pointer to a stopped counter set
+*                stream - stream to write results to
+*   Effects    : Counter values are written to stream
+*   Returned   : NONE
+***************************************************************************/
+void PerfPrint(const perf_counters_t *counters, FILE *stream)
+{
+    int i;
+
+    if (0 == counters->numOpen)
+    {
+        fprintf(stream, "Hardware counters unavailable on this system.\n");
+        return;
+    }
+
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+    {
+        if ((counters->fd[i] < 0) || (counters->value[i] < 0.0))
+        {
+            fprintf(stream, "  %-14s: n/a\n", counterNames[i]);
+        }
+        else
+        {
+            fprintf(stream, "  %-14s: %.0f\n", counterNames[i],
+                counters->value[i]);
+        }
+    }
+
+    if ((counters->value[PERF_CYCLES] > 0.0) &&
+        (counters->value[PERF_INSTRUCTIONS] >= 0.0) &&
+        (counters->fd[PERF_INSTRUCTIONS] >= 0))
+    {
+        fprintf(stream, "  %-14s: %.2f\n", "IPC",
+            counters->value[PERF_INSTRUCTIONS] / counters->value[PERF_CYCLES]);
+    }
+}
+
+/***************************************************************************
+*   Function   : PerfClose
+*   Description: This function closes all of the open counters.
+*   Parameters : counters - pointer to an opened counter set
+*   Effects    : Counter file descriptors are closed
+*   Returned   : NONE
+***************************************************************************/
+void PerfClose(perf_counters_t *counters)
+{
+    int i;
+
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+    {
+#ifdef __linux__
+        if (counters->fd[i] >= 0)
+        {
+            close(counters->fd[i]);
+        }
+#endif
+        counters->fd[i] = -1;
+    }
+
+    counters->numOpen = 0;
+}
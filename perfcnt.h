@@ -0,0 +1,79 @@
+/***************************************************************************
+*                   Hardware Performance Counter Interface
+*
+*   File    : perfcnt.h
+*   Purpose : This is the header for a small module used by the sort
+*             sample program to read hardware performance counters
+*             (cycles, instructions, cache and TLB misses) around a sort.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* perfcnt: Hardware performance counters for the sort sample program
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+#ifndef _PERFCNT_H_
+#define _PERFCNT_H_
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdio.h>
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+typedef enum
+{
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_NUM_COUNTERS
+} perf_counter_t;
+
+typedef struct
+{
+    int fd[PERF_NUM_COUNTERS];          /* counter handle, -1 if unavailable */
+    double value[PERF_NUM_COUNTERS];    /* last measured (scaled) value */
+    int numOpen;                        /* number of usable counters */
+} perf_counters_t;
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+/* open every counter supported by this host, returns number opened */
+int PerfOpen(perf_counters_t *counters);
+
+/* reset and enable all open counters */
+void PerfStart(perf_counters_t *counters);
+
+/* disable all open counters and collect their values */
+void PerfStop(perf_counters_t *counters);
+
+/* write the last collected values to a stream */
+void PerfPrint(const perf_counters_t *counters, FILE *stream);
+
+/* release all open counters */
+void PerfClose(perf_counters_t *counters);
+
+#endif /* _PERFCNT_H_ */
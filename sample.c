@@ -36,6 +36,7 @@
 #include <string.h>
 #include <time.h>
 #include "sort.h"
+#include "perfcnt.h"
 #include "optlist/optlist.h"
 
 /***************************************************************************
@@ -50,9 +51,42 @@ typedef enum
     METHOD_QUICK = 0x08,
     METHOD_MERGE = 0x10,
     METHOD_HEAP = 0x20,
-    METHOD_RADIX = 0x40
+    METHOD_RADIX = 0x40,
+    METHOD_NATURAL_MERGE = 0x80,
+    METHOD_AUTO = 0x100,
+    METHOD_QUICK_3WAY = 0x200,
+    METHOD_DUAL_PIVOT = 0x400,
+    METHOD_SAMPLE = 0x800,
+    METHOD_MERGE_K = 0x1000,
+    METHOD_SORTED_BUFFER = 0x2000,
+    METHOD_STREAM = 0x4000,
+    METHOD_SHELL_THREADED = 0x8000,
+    METHOD_BINARY_INSERTION = 0x10000,
+    METHOD_BLOCK_MERGE = 0x20000,
+    METHOD_RADIX_NUMERIC = 0x40000,
+    METHOD_MIN_COMPARE = 0x80000,
+    METHOD_AUTO_COMPARE = 0x100000
 } sort_method_t;
 
+/* order of the generated list */
+typedef enum
+{
+    ORDER_RANDOM,
+    ORDER_SORTED,
+    ORDER_REVERSED,
+    ORDER_SWAPPED           /* sorted with adjacent pairs swapped */
+} input_order_t;
+
+typedef void (*sort_func_t)(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+typedef struct
+{
+    sort_method_t method;       /* method flag that selects this sort */
+    const char *name;           /* name used when reporting results */
+    sort_func_t sortFunc;       /* function that sorts an array of ints */
+} sort_entry_t;
+
 /***************************************************************************
 *                            GLOBAL VARIABLES
 ***************************************************************************/
@@ -62,6 +96,75 @@ unsigned long comparisons;
 *                               PROTOTYPES
 ***************************************************************************/
 void ShowUsage(char *progPath);
+void RadixSortInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+void RadixSortNumericInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+void SortAutoInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+void SortAutoCompare(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+void SampleSortInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+void MergeShardsInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+void SortedBufferInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+void SortStreamInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+void ShellSortThreadedInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+void PrintStats(const sort_stats_t *stats);
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+#define NUM_SHARDS  8       /* shards sorted separately then merged */
+#define NUM_BATCHES 100     /* batches appended to a sorted buffer */
+#define STREAM_ITEMS 1000   /* items pushed to/pulled from a stream at once */
+
+static const sort_entry_t sortTable[] =
+{
+    {METHOD_INSERTION, "Insertion sort", InsertionSort},
+    {METHOD_BINARY_INSERTION, "Binary insertion sort", BinaryInsertionSort},
+    {METHOD_BUBBLE, "Bubble sort", BubbleSort},
+    {METHOD_SHELL, "Shell sort", ShellSort},
+    {METHOD_SHELL_THREADED, "Threaded Shell sort", ShellSortThreadedInt},
+    {METHOD_QUICK, "Quick sort", QuickSort},
+    {METHOD_QUICK_3WAY, "Three-way quick sort", QuickSort3Way},
+    {METHOD_DUAL_PIVOT, "Dual-pivot quick sort", DualPivotQuickSort},
+    {METHOD_MERGE, "Merge sort", MergeSort},
+    {METHOD_BLOCK_MERGE, "Cache blocked merge sort", BlockMergeSort},
+    {METHOD_MIN_COMPARE, "Fewest comparisons sort", MinCompareSort},
+    {METHOD_HEAP, "Heap sort", HeapSort},
+    {METHOD_RADIX, "Radix sort", RadixSortInt},
+    {METHOD_RADIX_NUMERIC, "Numeric key radix sort", RadixSortNumericInt},
+    {METHOD_NATURAL_MERGE, "Natural merge sort", NaturalMergeSort},
+    {METHOD_SAMPLE, "Parallel samplesort", SampleSortInt},
+    {METHOD_MERGE_K, "Sorted shards + k-way merge", MergeShardsInt},
+    {METHOD_SORTED_BUFFER, "Sorted buffer appends", SortedBufferInt},
+    {METHOD_STREAM, "Streaming sort", SortStreamInt},
+    {METHOD_AUTO, "Auto selected sort", SortAutoInt},
+    {METHOD_AUTO_COMPARE, "Auto selected comparison sort", SortAutoCompare},
+    {METHOD_NONE, NULL, NULL}
+};
+
+/* names of the algorithms that SortAuto may report, by sort_algorithm_t */
+static const char *algorithmNames[] =
+{
+    "none",
+    "insertion sort",
+    "bubble sort",
+    "Shell sort",
+    "quick sort",
+    "merge sort",
+    "natural merge sort",
+    "heap sort",
+    "radix sort",
+    "three-way quick sort",
+    "dual-pivot quick sort",
+    "parallel samplesort"
+};
 
 /***************************************************************************
 *                                FUNCTIONS
@@ -238,6 +341,36 @@ unsigned int Byte7Key(const void *value)
 }
 #endif
 
+/***************************************************************************
+*   Function   : RadixSortInt
+*   Description: This function wraps the RadixSort passes required to sort
+*                an array of integers, so that it may be called like any of
+*                the other sort functions.
+*   Parameters : list - a pointer to an array of integers
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array (sizeof(int))
+*                compareFunc - unused
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void RadixSortInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    (void)compareFunc;
+
+    /* make one Radix sort pass for every byte (LSB to MSB) */
+    RadixSort(list, numItems, itemSize, 256, Byte0Key);
+    RadixSort(list, numItems, itemSize, 256, Byte1Key);
+    RadixSort(list, numItems, itemSize, 256, Byte2Key);
+    RadixSort(list, numItems, itemSize, 256, Byte3Key);
+#if UINT_MAX > 0xFFFFFFFFU
+    RadixSort(list, numItems, itemSize, 256, Byte4Key);
+    RadixSort(list, numItems, itemSize, 256, Byte5Key);
+    RadixSort(list, numItems, itemSize, 256, Byte6Key);
+    RadixSort(list, numItems, itemSize, 256, Byte7Key);
+#endif
+}
+
 /***************************************************************************
 *   Function   : DumpList
 *   Description: This function just prints all of the elements in an
@@ -259,6 +392,267 @@ void DumpList(int *list, size_t numItems)
     printf("\n");
 }
 
+/***************************************************************************
+*   Function   : RadixSortNumericInt
+*   Description: This function wraps RadixSortNumeric, which picks its own
+*                digit width, so that it may be called like any of the
+*                other sort functions.
+*   Parameters : list - a pointer to an array of integers
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array (sizeof(int))
+*                compareFunc - unused
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void RadixSortNumericInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    (void)compareFunc;
+    RadixSortNumeric(list, numItems, itemSize, 0, SORT_KEY_INT);
+}
+
+/***************************************************************************
+*   Function   : SortAutoInt
+*   Description: This function wraps SortAuto so that it may be called like
+*                any of the other sort functions.
+*   Parameters : list - a pointer to an array of integers
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array (sizeof(int))
+*                compareFunc - function used to compare integers
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void SortAutoInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    SortAuto(list, numItems, itemSize, compareFunc, SORT_KEY_INT);
+}
+
+/***************************************************************************
+*   Function   : SortAutoCompare
+*   Description: This function wraps SortAuto so that it may be called like
+*                any of the other sort functions.  No numeric key is given,
+*                so SortAuto must choose one of the comparison sorts.
+*   Parameters : list - a pointer to an array of integers
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array (sizeof(int))
+*                compareFunc - function used to compare integers
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void SortAutoCompare(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    SortAuto(list, numItems, itemSize, compareFunc, SORT_KEY_NONE);
+}
+
+/***************************************************************************
+*   Function   : SampleSortInt
+*   Description: This function wraps ParallelSampleSort so that it may be
+*                called like any of the other sort functions.  It uses one
+*                thread per processor.
+*   Parameters : list - a pointer to an array of integers
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array (sizeof(int))
+*                compareFunc - function used to compare integers
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void SampleSortInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    ParallelSampleSort(list, numItems, itemSize, compareFunc, 0);
+}
+
+/***************************************************************************
+*   Function   : ShellSortThreadedInt
+*   Description: This function wraps ShellSortGaps so that it may be
+*                called like any of the other sort functions.  It uses
+*                Tokuda's gaps and one thread per processor.
+*   Parameters : list - a pointer to an array of integers
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array (sizeof(int))
+*                compareFunc - function used to compare integers
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void ShellSortThreadedInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    ShellSortGaps(list, numItems, itemSize, compareFunc, SORT_GAPS_TOKUDA,
+        NULL, 0, 0);
+}
+
+/***************************************************************************
+*   Function   : MergeShardsInt
+*   Description: This function demonstrates MergeK.  It splits a list into
+*                NUM_SHARDS shards, sorts each of them with quick sort, and
+*                merges the sorted shards.
+*   Parameters : list - a pointer to an array of integers
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array (sizeof(int))
+*                compareFunc - function used to compare integers
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void MergeShardsInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    const void *shards[NUM_SHARDS];
+    size_t shardItems[NUM_SHARDS];
+    size_t i, first;
+    void *merged;
+
+    first = 0;
+
+    for (i = 0; i < NUM_SHARDS; i++)
+    {
+        shards[i] = (char *)list + (first * itemSize);
+        shardItems[i] = ((numItems * (i + 1)) / NUM_SHARDS) - first;
+        QuickSort((void *)shards[i], shardItems[i], itemSize, compareFunc);
+        first += shardItems[i];
+    }
+
+    merged = MergeK(shards, shardItems, NUM_SHARDS, itemSize, compareFunc,
+        NULL);
+
+    if (NULL == merged)
+    {
+        printf("Unable to allocate storage for merged shards.\n");
+        return;
+    }
+
+    memcpy(list, merged, numItems * itemSize);
+    free(merged);
+}
+
+/***************************************************************************
+*   Function   : SortedBufferInt
+*   Description: This function demonstrates the sorted buffer.  It appends
+*                a list to a sorted buffer in NUM_BATCHES batches of
+*                varying size, and copies the sorted items back to the
+*                list.
+*   Parameters : list - a pointer to an array of integers
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array (sizeof(int))
+*                compareFunc - function used to compare integers
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void SortedBufferInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sorted_buffer_t *buffer;
+    size_t i, first, last;
+
+    buffer = SortedBufferCreate(itemSize, compareFunc, 0);
+
+    if (NULL == buffer)
+    {
+        printf("Unable to allocate a sorted buffer.\n");
+        return;
+    }
+
+    first = 0;
+
+    for (i = 0; i < NUM_BATCHES; i++)
+    {
+        /* batch sizes grow, some will be merged and some go to the tier */
+        last = (numItems * (i + 1) * (i + 1)) / (NUM_BATCHES * NUM_BATCHES);
+
+        if (!SortedBufferAppend(buffer, (char *)list + (first * itemSize),
+            last - first))
+        {
+            printf("Unable to append to a sorted buffer.\n");
+            break;
+        }
+
+        first = last;
+    }
+
+    memcpy(list, SortedBufferItems(buffer),
+        SortedBufferCount(buffer) * itemSize);
+    SortedBufferFree(buffer);
+}
+
+/***************************************************************************
+*   Function   : SortStreamInt
+*   Description: This function demonstrates the streaming sort.  It pushes
+*                a list to a stream STREAM_ITEMS at a time, and then pulls
+*                the sorted items back into the list.
+*   Parameters : list - a pointer to an array of integers
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array (sizeof(int))
+*                compareFunc - function used to compare integers
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void SortStreamInt(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sort_stream_t *stream;
+    size_t i, count;
+
+    stream = SortStreamCreate(itemSize, compareFunc, 0, 0);
+
+    if (NULL == stream)
+    {
+        printf("Unable to allocate a sort stream.\n");
+        return;
+    }
+
+    for (i = 0; i < numItems; i += count)
+    {
+        count = ((numItems - i) < STREAM_ITEMS) ? (numItems - i) :
+            STREAM_ITEMS;
+
+        if (!SortStreamPush(stream, (char *)list + (i * itemSize), count))
+        {
+            printf("Unable to push to a sort stream.\n");
+            break;
+        }
+    }
+
+    for (i = 0; i < numItems; i += count)
+    {
+        count = SortStreamPull(stream, (char *)list + (i * itemSize),
+            STREAM_ITEMS);
+
+        if (0 == count)
+        {
+            break;
+        }
+    }
+
+    SortStreamFree(stream);
+}
+
+/***************************************************************************
+*   Function   : PrintStats
+*   Description: This function prints the operation statistics collected
+*                by the sort library.
+*   Parameters : stats - pointer to the statistics collected for a sort
+*   Effects    : Statistics are printed to stdout
+*   Returned   : NONE
+***************************************************************************/
+void PrintStats(const sort_stats_t *stats)
+{
+    printf("Library statistics:\n");
+    printf("  comparisons   : %lu\n", stats->comparisons);
+    printf("  item moves    : %lu\n", stats->moves);
+    printf("  bytes copied  : %lu\n", stats->bytesCopied);
+    printf("  allocations   : %lu\n", stats->mallocs);
+    printf("  peak scratch  : %lu bytes\n",
+        (unsigned long)stats->peakScratchBytes);
+    printf("  max depth     : %lu\n", stats->maxDepth);
+    printf("  skipped radix : %lu passes\n", stats->radixPassesSkipped);
+
+    if (SORT_ALG_NONE != stats->algorithm)
+    {
+        printf("  auto selected : %s\n", algorithmNames[stats->algorithm]);
+    }
+}
+
 /***************************************************************************
 *   Function   : main
 *   Description: This function is the entry point for this program.  It
@@ -277,16 +671,26 @@ int main(int argc, char *argv[])
     size_t i;                           /* counter */
     time_t timer;                       /* time - used for random seed */
     unsigned char debug;                /* non-zero prints debug messages */
+    unsigned char perf;                 /* non-zero reports hw counters */
+    perf_counters_t counters;           /* hardware performance counters */
+    sort_stats_t stats;                 /* library operation statistics */
     sort_method_t methods;
     option_t *optList, *thisOpt;
+    sort_tuning_t tuning;               /* calibrated thresholds */
+    unsigned long hash;                 /* order independent list hash */
+    size_t unsortedAt;                  /* first item out of order */
+    input_order_t order;                /* order of the generated list */
 
     /* initialize variables */
     numItems = 0;
     debug = 0;
+    perf = 0;
     methods = METHOD_NONE;
+    order = ORDER_RANDOM;
 
     /* parse command line */
-    optList = GetOptList(argc, argv, "iIbBsSqQmMhHrRn:N:AadD?");
+    optList = GetOptList(argc, argv,
+        "iIjJbBsSgGqQ32mMwWfFlLkKoOeEhHrRxXuUaAvVn:N:c:C:t:T:y:Y:dDpP?");
     thisOpt = optList;
 
     while (thisOpt != NULL)
@@ -309,6 +713,11 @@ int main(int argc, char *argv[])
                 methods |= METHOD_INSERTION;
                 break;
 
+            case 'j':       /* binary insertion sort */
+            case 'J':
+                methods |= METHOD_BINARY_INSERTION;
+                break;
+
             case 'b':       /* bubble sort */
             case 'B':
                 methods |= METHOD_BUBBLE;
@@ -319,16 +728,59 @@ int main(int argc, char *argv[])
                 methods |= METHOD_SHELL;
                 break;
 
+            case 'g':       /* shell sort, h-sorts split among threads */
+            case 'G':
+                methods |= METHOD_SHELL_THREADED;
+                break;
+
             case 'q':       /* quick sort */
             case 'Q':
                 methods |= METHOD_QUICK;
                 break;
 
+            case '3':       /* three-way quick sort */
+                methods |= METHOD_QUICK_3WAY;
+                break;
+
+            case '2':       /* dual-pivot quick sort */
+                methods |= METHOD_DUAL_PIVOT;
+                break;
+
+            case 'l':       /* parallel samplesort */
+            case 'L':
+                methods |= METHOD_SAMPLE;
+                break;
+
+            case 'k':       /* sorted shards merged by MergeK */
+            case 'K':
+                methods |= METHOD_MERGE_K;
+                break;
+
+            case 'o':       /* batches appended to a sorted buffer */
+            case 'O':
+                methods |= METHOD_SORTED_BUFFER;
+                break;
+
+            case 'e':       /* streaming sort */
+            case 'E':
+                methods |= METHOD_STREAM;
+                break;
+
             case 'm':       /* merge sort */
             case 'M':
                 methods |= METHOD_MERGE;
                 break;
 
+            case 'w':       /* merge sort of cache sized tiles */
+            case 'W':
+                methods |= METHOD_BLOCK_MERGE;
+                break;
+
+            case 'f':       /* fewest comparisons */
+            case 'F':
+                methods |= METHOD_MIN_COMPARE;
+                break;
+
             case 'h':       /* heap sort */
             case 'H':
                 methods |= METHOD_HEAP;
@@ -339,11 +791,89 @@ int main(int argc, char *argv[])
                 methods |= METHOD_RADIX;
                 break;
 
+            case 'x':       /* radix sort of native int keys */
+            case 'X':
+                methods |= METHOD_RADIX_NUMERIC;
+                break;
+
+            case 'u':       /* natural merge sort */
+            case 'U':
+                methods |= METHOD_NATURAL_MERGE;
+                break;
+
+            case 'a':       /* automatically selected sort */
+            case 'A':
+                methods |= METHOD_AUTO;
+                break;
+
+            case 'v':       /* automatically selected comparison sort */
+            case 'V':
+                methods |= METHOD_AUTO_COMPARE;
+                break;
+
             case 'd':       /* enable debug dump of string */
             case 'D':
                 debug = 1;
                 break;
 
+            case 'c':       /* calibrate and write a tuning profile */
+            case 'C':
+                printf("Calibrating sort thresholds ...\n");
+                SortCalibrate(&tuning);
+
+                if (!SortSaveTuning(thisOpt->argument, &tuning))
+                {
+                    printf("Error: Unable to write %s\n", thisOpt->argument);
+                    FreeOptList(optList);
+                    return EXIT_FAILURE;
+                }
+
+                SortSetTuning(&tuning);
+                printf("Insertion sort cutoff: %lu items\n",
+                    (unsigned long)tuning.insertionCutoff);
+                break;
+
+            case 't':       /* load a tuning profile */
+            case 'T':
+                if (!SortLoadTuning(thisOpt->argument))
+                {
+                    printf("Unable to read %s, using default thresholds.\n",
+                        thisOpt->argument);
+                }
+                break;
+
+            case 'p':       /* report hardware performance counters */
+            case 'P':
+                perf = 1;
+                break;
+
+            case 'y':       /* order of the generated list */
+            case 'Y':
+                if (0 == strcmp(thisOpt->argument, "random"))
+                {
+                    order = ORDER_RANDOM;
+                }
+                else if (0 == strcmp(thisOpt->argument, "sorted"))
+                {
+                    order = ORDER_SORTED;
+                }
+                else if (0 == strcmp(thisOpt->argument, "reversed"))
+                {
+                    order = ORDER_REVERSED;
+                }
+                else if (0 == strcmp(thisOpt->argument, "swapped"))
+                {
+                    order = ORDER_SWAPPED;
+                }
+                else
+                {
+                    printf("Error: Unknown list order %s\n",
+                        thisOpt->argument);
+                    FreeOptList(optList);
+                    return EXIT_FAILURE;
+                }
+                break;
+
             case '?':
                 ShowUsage(argv[0]);
 
@@ -390,7 +920,25 @@ int main(int argc, char *argv[])
     srand((unsigned int)time(&timer));
     for (i = 0; i < numItems; i++)
     {
-        unsorted[i] = rand();
+        switch (order)
+        {
+            case ORDER_SORTED:
+                unsorted[i] = (int)i;
+                break;
+
+            case ORDER_REVERSED:
+                unsorted[i] = (int)(numItems - i);
+                break;
+
+            case ORDER_SWAPPED:
+                /* looks random to SortAuto's sample, but isn't */
+                unsorted[i] = (int)(i ^ 1);
+                break;
+
+            default:
+                unsorted[i] = rand();
+                break;
+        }
     }
 
     if (debug)
@@ -399,115 +947,44 @@ int main(int argc, char *argv[])
         DumpList(unsorted, numItems);
     }
 
-    /* --- Insertion Sort --- */
-    if (methods & METHOD_INSERTION)
-    {
-        memcpy((void *)list, (void *)unsorted, numItems * sizeof(int));
-        comparisons = 0;
-        InsertionSort((void *)list, numItems, sizeof(int), CompareIntLessThan);
-
-        printf("Insertion sort:\n");
+    hash = SortMultisetHash(unsorted, numItems, sizeof(int), 0);
 
-        if (debug)
-        {
-            printf("Sorted list:\n");
-            DumpList(list, numItems);
-        }
-
-        printf("Number of comparisons to sort %ld Items: %lu\n",
-            numItems, comparisons);
-
-        if (!VerifySort((void *)list, numItems, sizeof(int),
-            CompareIntLessThan))
-        {
-            printf("ERROR: Sort results are incorrect.\n");
-        }
-    }
-
-    /* --- Bubble Sort --- */
-    if (methods & METHOD_BUBBLE)
+    /* open the counters before the thread pool starts so they count it */
+    if (perf)
     {
-        memcpy((void *)list, (void *)unsorted, numItems * sizeof(int));
-        comparisons = 0;
-        BubbleSort((void *)list, numItems, sizeof(int), CompareIntLessThan);
-
-
-        printf("Bubble sort:\n");
-
-        if (debug)
+        if (0 == PerfOpen(&counters))
         {
-            printf("Sorted list:\n");
-            DumpList(list, numItems);
-        }
-
-        printf("Number of comparisons to sort %ld Items: %lu\n",
-            numItems, comparisons);
-
-        if (!VerifySort((void *)list, numItems, sizeof(int),
-            CompareIntLessThan))
-        {
-            printf("ERROR: Sort results are incorrect.\n");
+            printf("Hardware counters unavailable on this system.\n");
         }
     }
 
-    /* --- Shell Sort --- */
-    if (methods & METHOD_SHELL)
+    for (i = 0; NULL != sortTable[i].sortFunc; i++)
     {
-        memcpy((void *)list, (void *)unsorted, numItems * sizeof(int));
-        comparisons = 0;
-        ShellSort((void *)list, numItems, sizeof(int), CompareIntLessThan);
-
-        printf("Shell sort:\n");
-
-        if (debug)
+        if (!(methods & sortTable[i].method))
         {
-            printf("Sorted list:\n");
-            DumpList(list, numItems);
+            continue;
         }
 
-        printf("Number of comparisons to sort %ld Items: %lu\n",
-            numItems, comparisons);
-
-        if (!VerifySort((void *)list, numItems, sizeof(int),
-            CompareIntLessThan))
-        {
-            printf("ERROR: Sort results are incorrect.\n");
-        }
-    }
-
-    /* --- Quick Sort --- */
-    if (methods & METHOD_QUICK)
-    {
         memcpy((void *)list, (void *)unsorted, numItems * sizeof(int));
         comparisons = 0;
-        QuickSort((void *)list, numItems, sizeof(int), CompareIntLessThan);
-
-        printf("Quick sort:\n");
+        SortStatsAttach(&stats);
 
-        if (debug)
+        if (perf)
         {
-            printf("Sorted list:\n");
-            DumpList(list, numItems);
+            PerfStart(&counters);
         }
 
-        printf("Number of comparisons to sort %ld Items: %lu\n",
-            numItems, comparisons);
+        sortTable[i].sortFunc((void *)list, numItems, sizeof(int),
+            CompareIntLessThan);
 
-        if (!VerifySort((void *)list, numItems, sizeof(int),
-            CompareIntLessThan))
+        if (perf)
         {
-            printf("ERROR: Sort results are incorrect.\n");
+            PerfStop(&counters);
         }
-    }
 
-    /* --- Merge Sort --- */
-    if (methods & METHOD_MERGE)
-    {
-        memcpy((void *)list, (void *)unsorted, numItems * sizeof(int));
-        comparisons = 0;
-        MergeSort((void *)list, numItems, sizeof(int), CompareIntLessThan);
+        SortStatsAttach(NULL);
 
-        printf("Merge sort:\n");
+        printf("%s:\n", sortTable[i].name);
 
         if (debug)
         {
@@ -518,72 +995,33 @@ int main(int argc, char *argv[])
         printf("Number of comparisons to sort %ld Items: %lu\n",
             numItems, comparisons);
 
-        if (!VerifySort((void *)list, numItems, sizeof(int),
-            CompareIntLessThan))
+#ifdef SORT_STATS
+        PrintStats(&stats);
+#endif
+
+        if (perf && (counters.numOpen > 0))
         {
-            printf("ERROR: Sort results are incorrect.\n");
+            PerfPrint(&counters, stdout);
         }
-    }
 
-    /* --- Heap Sort --- */
-    if (methods & METHOD_HEAP)
-    {
-        memcpy((void *)list, (void *)unsorted, numItems * sizeof(int));
-        comparisons = 0;
-        HeapSort((void *)list, numItems, sizeof(int), CompareIntLessThan);
+        unsortedAt = SortFindUnsorted(list, numItems, sizeof(int),
+            CompareIntLessThan, SORT_KEY_INT, 0);
 
-        printf("Heap sort:\n");
-
-        if (debug)
+        if (unsortedAt < numItems)
         {
-            printf("Sorted list:\n");
-            DumpList(list, numItems);
+            printf("ERROR: Sort results are incorrect at item %lu.\n",
+                (unsigned long)unsortedAt);
         }
 
-        printf("Number of comparisons to sort %ld Items: %lu\n",
-            numItems, comparisons);
-
-        if (!VerifySort((void *)list, numItems, sizeof(int),
-            CompareIntLessThan))
+        if (SortMultisetHash(list, numItems, sizeof(int), 0) != hash)
         {
-            printf("ERROR: Sort results are incorrect.\n");
+            printf("ERROR: Sorted items aren't the original items.\n");
         }
     }
 
-    /* --- Radix Sort --- */
-    if (methods & METHOD_RADIX)
+    if (perf)
     {
-        memcpy((void *)list, (void *)unsorted, numItems * sizeof(int));
-        comparisons = 0;
-
-        /* make one Radix sort pass for every byte (LSB to MSB) */
-        RadixSort((void *)list, numItems, sizeof(int), 256, Byte0Key);
-        RadixSort((void *)list, numItems, sizeof(int), 256, Byte1Key);
-        RadixSort((void *)list, numItems, sizeof(int), 256, Byte2Key);
-        RadixSort((void *)list, numItems, sizeof(int), 256, Byte3Key);
-#if UINT_MAX > 0xFFFFFFFFU
-        RadixSort((void *)list, numItems, sizeof(int), 256, Byte4Key);
-        RadixSort((void *)list, numItems, sizeof(int), 256, Byte5Key);
-        RadixSort((void *)list, numItems, sizeof(int), 256, Byte6Key);
-        RadixSort((void *)list, numItems, sizeof(int), 256, Byte7Key);
-#endif
-
-        printf("Radix sort:\n");
-
-        if (debug)
-        {
-            printf("Sorted list:\n");
-            DumpList(list, numItems);
-        }
-
-        printf("Number of comparisons to sort %ld Items: %lu\n",
-            numItems, comparisons);
-
-        if (!VerifySort((void *)list, numItems, sizeof(int),
-            CompareIntLessThan))
-        {
-            printf("ERROR: Sort results are incorrect.\n");
-        }
+        PerfClose(&counters);
     }
 
     /* clean-up and exit */
@@ -641,13 +1079,32 @@ void ShowUsage(char *progPath)
     printf("Options:\n");
     printf("  -n : number of elements to sort.\n");
     printf("  -i : use insertion sort\n");
+    printf("  -j : use binary insertion sort\n");
     printf("  -b : use bubble sort\n");
     printf("  -s : use shell sort\n");
+    printf("  -g : use shell sort with Tokuda's gaps on every processor\n");
     printf("  -q : use quick sort\n");
+    printf("  -3 : use three-way quick sort\n");
+    printf("  -2 : use dual-pivot quick sort\n");
     printf("  -m : use merge sort\n");
+    printf("  -w : use merge sort of cache sized tiles and k-way merges\n");
+    printf("  -f : use merge-insertion and binary merges for the fewest "
+        "comparisons\n");
+    printf("  -l : use parallel samplesort\n");
+    printf("  -k : sort shards and merge them with MergeK\n");
+    printf("  -o : append batches to a sorted buffer\n");
+    printf("  -e : push the list through a streaming sort\n");
     printf("  -h : use heap sort\n");
     printf("  -r : use radix sort\n");
+    printf("  -x : use radix sort of int keys with adaptive digit widths\n");
+    printf("  -u : use natural merge sort\n");
+    printf("  -a : use the sort selected by SortAuto\n");
+    printf("  -v : use the sort selected by SortAuto without a numeric key\n");
+    printf("  -c <profile> : calibrate thresholds and write them to profile\n");
+    printf("  -t <profile> : use thresholds from profile\n");
+    printf("  -y <order> : list order (random, sorted, reversed, swapped)\n");
     printf("  -d : display sort results and other debug information\n");
+    printf("  -p : report hardware performance counters for each sort\n");
     printf("  -? : Print out command line options.\n\n");
     printf("Default: %s -n1000\n", RemovePath(progPath));
 }
@@ -51,41 +51,194 @@
 *                             INCLUDED FILES
 ***************************************************************************/
 #include "sort.h"
+#include "sortint.h"
 #include <string.h>
 #include <assert.h>
 
 /***************************************************************************
-*                            TYPE DEFINITIONS
+*                               PROTOTYPES
 ***************************************************************************/
-typedef enum
-{
-    FALSE,
-    TRUE
-} bool_t;
+static void InsertionSortTemp(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), void *temp);
+static void InsertionSortLeaf(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), void *temp,
+    bool_t guarded);
+static void QuickSortPartition(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), void *temp,
+    bool_t guarded);
+static void QuickSort3WayRecursive(void *list, size_t numItems,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    void *temp, bool_t guarded);
+
+static void SiftDown(void *list, size_t root, size_t lastChild, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+static void SwapInPlace(void *x, void *y, size_t itemSize);
+
+static void MergeRuns(const void *src, void *dst, size_t low, size_t mid,
+    size_t high, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+static size_t MedianOfThree(void *list, size_t a, size_t b, size_t c,
+    size_t itemSize, int (*compareFunc) (const void *, const void *));
+static void SwapRange(void *list, size_t a, size_t b, size_t count,
+    size_t itemSize, void *temp);
+static void DualPivotPartition(void *list, size_t numItems,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    void *temp, bool_t guarded);
 
 /***************************************************************************
-*                                 MACROS
+*                                CONSTANTS
 ***************************************************************************/
-#define Swap(x, y, temp, size)      {   memcpy(temp, x, size);  \
-                                        memcpy(x, y, size);     \
-                                        memcpy(y, temp, size);  }
+/* dual-pivot quick sort needs this many items to sample its pivots */
+#define DUAL_PIVOT_MIN_ITEMS    8
 
-#define VoidPtrOffset(ptr, offset)  (void *)(&((char *)ptr)[offset])
+/* bytes of an item that heap sort swaps at a time through the stack */
+#define SWAP_CHUNK_BYTES        64
 
 /***************************************************************************
-*                               PROTOTYPES
+*                            GLOBAL VARIABLES
 ***************************************************************************/
-static void SiftDown(void *list, size_t root, size_t lastChild, size_t itemSize,
-    int (*compareFunc) (const void *, const void *), void *temp);
+#ifdef SORT_STATS
+/* statistics for sorts made by this thread, NULL if not collecting */
+SORT_TLS sort_stats_t *sortStats = NULL;
+#endif
 
 /***************************************************************************
 *                                FUNCTIONS
 ***************************************************************************/
 
+/***************************************************************************
+*   Function   : SortStatsAttach
+*   Description: This function zeros a statistics structure and makes it
+*                the structure that collects operation counts for all of
+*                the sorts that the calling thread makes.  Statistics are
+*                only collected if the library is compiled with SORT_STATS
+*                defined.  Otherwise the structure is just zeroed.
+*   Parameters : stats - pointer to the statistics structure to fill in.
+*                        NULL stops collecting statistics.
+*   Effects    : Future sorts by this thread update stats
+*   Returned   : NONE
+***************************************************************************/
+void SortStatsAttach(sort_stats_t *stats)
+{
+    if (NULL != stats)
+    {
+        memset(stats, 0, sizeof(sort_stats_t));
+    }
+
+#ifdef SORT_STATS
+    sortStats = stats;
+#endif
+}
+
+#ifdef SORT_STATS
+/***************************************************************************
+*   Function   : StatDepth
+*   Description: This function adjusts the current recursion depth and
+*                records the deepest recursion seen.
+*   Parameters : delta - amount to change the recursion depth by
+*   Effects    : sortStats->depth and sortStats->maxDepth are updated
+*   Returned   : NONE
+***************************************************************************/
+void StatDepth(int delta)
+{
+    if (delta < 0)
+    {
+        sortStats->depth--;
+    }
+    else
+    {
+        sortStats->depth++;
+
+        if (sortStats->depth > sortStats->maxDepth)
+        {
+            sortStats->maxDepth = sortStats->depth;
+        }
+    }
+}
+#endif
+
+/***************************************************************************
+*   Function   : ScratchAlloc
+*   Description: This function allocates scratch memory for a sort and
+*                records the allocation in the statistics.
+*   Parameters : size - number of bytes to allocate
+*   Effects    : Memory is allocated from the heap
+*   Returned   : Pointer to the allocated memory, NULL on failure.
+***************************************************************************/
+void *ScratchAlloc(size_t size)
+{
+    void *ptr;
+
+    ptr = malloc(size);
+
+#ifdef SORT_STATS
+    if ((NULL != ptr) && (NULL != sortStats))
+    {
+        sortStats->mallocs++;
+        sortStats->scratchBytes += size;
+
+        if (sortStats->scratchBytes > sortStats->peakScratchBytes)
+        {
+            sortStats->peakScratchBytes = sortStats->scratchBytes;
+        }
+    }
+#endif
+
+    return ptr;
+}
+
+/***************************************************************************
+*   Function   : ScratchCalloc
+*   Description: This function allocates zeroed scratch memory for a sort
+*                and records the allocation in the statistics.
+*   Parameters : count - number of elements to allocate
+*                size - size of each element
+*   Effects    : Memory is allocated from the heap
+*   Returned   : Pointer to the allocated memory, NULL on failure.
+***************************************************************************/
+void *ScratchCalloc(size_t count, size_t size)
+{
+    void *ptr;
+
+    ptr = ScratchAlloc(count * size);
+
+    if (NULL != ptr)
+    {
+        memset(ptr, 0, count * size);
+    }
+
+    return ptr;
+}
+
+/***************************************************************************
+*   Function   : ScratchFree
+*   Description: This function frees memory allocated by ScratchAlloc and
+*                records the release in the statistics.
+*   Parameters : ptr - pointer to the memory to free
+*                size - number of bytes that were allocated
+*   Effects    : Memory is returned to the heap
+*   Returned   : NONE
+***************************************************************************/
+void ScratchFree(void *ptr, size_t size)
+{
+#ifdef SORT_STATS
+    if ((NULL != ptr) && (NULL != sortStats))
+    {
+        sortStats->scratchBytes -= size;
+    }
+#else
+    (void)size;
+#endif
+
+    free(ptr);
+}
+
 /***************************************************************************
 *   Function   : VerifySort
-*   Description: This function verifies that an array of integers is
-*                sorted in ascending order.
+*   Description: This function verifies that an array of items is sorted
+*                in ascending order.  See SortFindUnsorted for a faster
+*                check of numeric keys.
 *   Parameters : list - a pointer to a sorted array of items
 *                numItems - number of items in the sorted array
 *                itemSize - size of each item in the sorted array
@@ -101,11 +254,16 @@ int VerifySort(void *list, size_t numItems, size_t itemSize,
 {
     size_t i, endItem;
 
+    if (numItems <= 1)
+    {
+        return(TRUE);
+    }
+
     endItem = (numItems - 1) * itemSize;
 
     for (i = 0; i < endItem; i += itemSize)
     {
-        if (compareFunc(VoidPtrOffset(list, i),
+        if (CompareItems(compareFunc, VoidPtrOffset(list, i),
                 VoidPtrOffset(list, (i + itemSize))) > 0)
         {
             return (FALSE);
@@ -117,7 +275,8 @@ int VerifySort(void *list, size_t numItems, size_t itemSize,
 
 /***************************************************************************
 *   Function   : InsertionSort
-*   Description: This function performs an insertion sort on array of items.
+*   Description: This function performs an insertion sort on array of items
+*                using scratch memory from the heap.  See InsertionSortCtx.
 *   Parameters : list - a pointer of an array of items to sort
 *                numItems - number of items in the array
 *                itemSize - size of each item in the array
@@ -131,39 +290,302 @@ int VerifySort(void *list, size_t numItems, size_t itemSize,
 void InsertionSort(void *list, size_t numItems, size_t itemSize,
     int (*compareFunc) (const void *, const void *))
 {
-    size_t i, j, endItem;
+    sort_error_t result;
+
+    result = InsertionSortCtx(NULL, list, numItems, itemSize, compareFunc);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : InsertionSortCtx
+*   Description: This function performs an insertion sort on array of items.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t InsertionSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
     void *temp;
 
+    if (numItems <= 1)
+    {
+        /* singleton lists are already sorted */
+        return SORT_OK;
+    }
+
     /* create temporary swap variable */
-    temp = malloc(itemSize);
-    assert(temp != NULL);
+    temp = ContextAlloc(ctx, itemSize);
+
+    if (NULL == temp)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    InsertionSortTemp(list, numItems, itemSize, compareFunc, temp);
+    ContextFree(ctx, temp, itemSize);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : InsertionSortTemp
+*   Description: This function does the work of an insertion sort using a
+*                temporary item provided by the caller.  The other sorts
+*                use it for their small partitions.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                temp - a temporary variable holding the item being
+*                       inserted
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+static void InsertionSortTemp(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), void *temp)
+{
+    size_t i, j, endItem;
 
     endItem = numItems * itemSize;
 
     for (i = itemSize; i < endItem; i += itemSize)
     {
         j = i;
-        memcpy(temp, VoidPtrOffset(list, i), itemSize);
+        CopyItem(temp, VoidPtrOffset(list, i), itemSize);
 
         /* look for a place to insert list[i] */
         while ((j > 0) &&
-            (compareFunc(temp, VoidPtrOffset(list, (j - itemSize))) < 0))
+            (CompareItems(compareFunc, temp, VoidPtrOffset(list, (j - itemSize))) < 0))
         {
-            memcpy(VoidPtrOffset(list, j),
-                VoidPtrOffset(list, (j - itemSize)),
-                itemSize);
+            CopyItem(VoidPtrOffset(list, j),
+                VoidPtrOffset(list, (j - itemSize)), itemSize);
             j -= itemSize;
         }
 
-        memcpy(VoidPtrOffset(list, j), temp, itemSize);
+        CopyItem(VoidPtrOffset(list, j), temp, itemSize);
+    }
+}
+
+/***************************************************************************
+*   Function   : InsertionSortLeaf
+*   Description: This function insertion sorts a small partition for one
+*                of the quick sorts.  Only the leftmost partition needs to
+*                check for the start of the list.  Every other partition
+*                follows a pivot that is ordered before or the same as all
+*                of its items, so the search for a place to insert an item
+*                always stops at the pivot.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                temp - a temporary variable holding the item being
+*                       inserted
+*                guarded - FALSE if the item before list[0] isn't ordered
+*                          after any item in the list
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+static void InsertionSortLeaf(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), void *temp,
+    bool_t guarded)
+{
+    char *item, *hole, *end;
+
+    if (guarded)
+    {
+        InsertionSortTemp(list, numItems, itemSize, compareFunc, temp);
+        return;
+    }
+
+    end = (char *)list + (numItems * itemSize);
+
+    for (item = (char *)list + itemSize; item < end; item += itemSize)
+    {
+        hole = item;
+        CopyItem(temp, item, itemSize);
+
+        /* the item before list[0] stops this loop */
+        while (CompareItems(compareFunc, temp, hole - itemSize) < 0)
+        {
+            CopyItem(hole, hole - itemSize, itemSize);
+            hole -= itemSize;
+        }
+
+        CopyItem(hole, temp, itemSize);
+    }
+}
+
+/***************************************************************************
+*   Function   : BinaryInsertionSort
+*   Description: This function performs a binary insertion sort on array
+*                of items using scratch memory from the heap.  See
+*                BinaryInsertionSortCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void BinaryInsertionSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sort_error_t result;
+
+    result = BinaryInsertionSortCtx(NULL, list, numItems, itemSize,
+        compareFunc);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : BinaryInsertionSortCtx
+*   Description: This function performs a binary insertion sort on array
+*                of items.  The place to insert each item is found with a
+*                binary search, and the items after it are shifted with a
+*                single memmove.  It makes order N * log(N) comparisons
+*                and N - 1 for a list that's already sorted, but still
+*                moves order N^2 items.  The sort is stable.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t BinaryInsertionSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    void *temp;
+
+    if (numItems <= 1)
+    {
+        /* singleton lists are already sorted */
+        return SORT_OK;
+    }
+
+    /* create temporary swap variable */
+    temp = ContextAlloc(ctx, itemSize);
+
+    if (NULL == temp)
+    {
+        return SORT_ERR_NOMEM;
     }
 
-    free(temp);
+    BinaryInsertionSortTemp(list, numItems, 1, itemSize, compareFunc, temp);
+    ContextFree(ctx, temp, itemSize);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : BinaryInsertionSortTemp
+*   Description: This function does the work of a binary insertion sort
+*                using a temporary item provided by the caller.  Each item
+*                is first compared with the last sorted item, so an item
+*                that is already in place costs one comparison.  Otherwise
+*                a binary search finds the first sorted item ordered after
+*                it, and the items from there on are moved up by one.  The
+*                stable sorts use it for their small partitions.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                sorted - number of items at the start of the list that
+*                         are already sorted (at least 1)
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                temp - a temporary variable holding the item being
+*                       inserted
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void BinaryInsertionSortTemp(void *list, size_t numItems, size_t sorted,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    void *temp)
+{
+    size_t i, low, high, mid;
+    void *item;
+
+    for (i = sorted; i < numItems; i++)
+    {
+        item = VoidPtrOffset(list, i * itemSize);
+
+        if (CompareItems(compareFunc, item,
+            VoidPtrOffset(list, (i - 1) * itemSize)) >= 0)
+        {
+            continue;           /* already in place */
+        }
+
+        /* find the first of list[0] .. list[i - 1] ordered after item */
+        low = 0;
+        high = i - 1;
+
+        while (low < high)
+        {
+            mid = low + ((high - low) / 2);
+
+            if (CompareItems(compareFunc, item,
+                VoidPtrOffset(list, mid * itemSize)) < 0)
+            {
+                high = mid;
+            }
+            else
+            {
+                low = mid + 1;
+            }
+        }
+
+        CopyItem(temp, item, itemSize);
+        MoveItems(VoidPtrOffset(list, (low + 1) * itemSize),
+            VoidPtrOffset(list, low * itemSize), i - low, itemSize);
+        CopyItem(VoidPtrOffset(list, low * itemSize), temp, itemSize);
+    }
 }
 
 /***************************************************************************
 *   Function   : BubbleSort
-*   Description: This function performs an bubble sort on array of items.
+*   Description: This function performs a bubble sort on array of items
+*                using scratch memory from the heap.  See BubbleSortCtx.
 *   Parameters : list - a pointer of an array of items to sort
 *                numItems - number of items in the array
 *                itemSize - size of each item in the array
@@ -171,46 +593,1140 @@ void InsertionSort(void *list, size_t numItems, size_t itemSize,
 *                   compareFunc(x, y) < 0  iff x precedes y
 *                   compareFunc(x, y) = 0  iff x and y are ordered the same
 *                   compareFunc(x, y) > 0  iff y precedes x
-*   Effects    : The contents of list are sorted in ascending order
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void BubbleSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sort_error_t result;
+
+    result = BubbleSortCtx(NULL, list, numItems, itemSize, compareFunc);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : BubbleSortCtx
+*   Description: This function performs an bubble sort on array of items.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t BubbleSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    size_t i, endItem;
+    bool_t done = FALSE;    /* true if no swaps last pass */
+    void *temp;
+
+    if (numItems <= 1)
+    {
+        /* singleton lists are already sorted */
+        return SORT_OK;
+    }
+
+    /* create temporary swap variable */
+    temp = ContextAlloc(ctx, itemSize);
+
+    if (NULL == temp)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    while (TRUE != done)
+    {
+        done = TRUE;
+        numItems--;     /* one less item left to sort after each pass */
+        endItem = numItems * itemSize;
+
+        /* push largest value to end of list each iteration */
+        for (i = 0; i < endItem; i += itemSize)
+        {
+            if (CompareItems(compareFunc, VoidPtrOffset(list, (i + itemSize)),
+                VoidPtrOffset(list, i)) < 0)
+            {
+                /* swap values */
+                Swap(VoidPtrOffset(list, i),
+                    VoidPtrOffset(list, (i + itemSize)), temp, itemSize);
+                done = FALSE;
+            }
+        }
+    }
+
+    ContextFree(ctx, temp, itemSize);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : ShellSort
+*   Description: This function performs a Shell sort on array of items
+*                using scratch memory from the heap.  See ShellSortCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void ShellSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sort_error_t result;
+
+    result = ShellSortCtx(NULL, list, numItems, itemSize, compareFunc);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : ShellSortCtx
+*   Description: This function performs a Shell sort on array of items
+*                using Knuth's gaps on the calling thread.  See
+*                ShellSortGapsCtx for other gaps (Ciura's usually take
+*                fewer comparisons) and threads.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t ShellSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    return ShellSortGapsCtx(ctx, list, numItems, itemSize, compareFunc,
+        SORT_GAPS_KNUTH, NULL, 0, 1);
+}
+
+/***************************************************************************
+*   Function   : QuickSort
+*   Description: This function performs an quick sort on array of items
+*                using scratch memory from the heap.  See QuickSortCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void QuickSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sort_error_t result;
+
+    result = QuickSortCtx(NULL, list, numItems, itemSize, compareFunc);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : QuickSortCtx
+*   Description: This function performs an quick sort on array of items.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t QuickSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    void *temp;
+
+    if (SortIsSorted(list, numItems, itemSize, compareFunc))
+    {
+        /* singleton and already sorted lists need no work */
+        return SORT_OK;
+    }
+
+    /* create temporary swap variable, shared by every partition */
+    temp = ContextAlloc(ctx, itemSize);
+
+    if (NULL == temp)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    QuickSortPartition(list, numItems, itemSize, compareFunc, temp, TRUE);
+    ContextFree(ctx, temp, itemSize);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : QuickSortPartition
+*   Description: This function does the work of QuickSort.  The first item
+*                is used as the pivot, and each partition is sorted
+*                recursively.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                temp - a temporary variable for use by Swap() function
+*                guarded - FALSE if the item before list[0] isn't ordered
+*                          after any item in the list
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+static void QuickSortPartition(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), void *temp,
+    bool_t guarded)
+{
+    size_t left, right;         /* partition pointers */
+
+    if (numItems <= sortTuning.insertionCutoff)
+    {
+        /* small lists sort faster with insertion sort */
+        InsertionSortLeaf(list, numItems, itemSize, compareFunc, temp,
+            guarded);
+    }
+    else
+    {
+        StatEnter();
+
+        left = 0;
+        right = (numItems  - 1) * itemSize;
+
+        while(!0)
+        {
+            /* seek until something on left partition is too large */
+            while (left < right)
+            {
+                left += itemSize;
+
+                if (CompareItems(compareFunc, VoidPtrOffset(list, left),
+                    list) > 0)
+                {
+                    break;      /* found a value that's too large */
+                }
+            }
+
+            if (left > right)
+            {
+                /* went too far */
+                break;
+            }
+
+            /* seek until something on right partition is too small */
+            while (left <= right)
+            {
+                if (CompareItems(compareFunc, VoidPtrOffset(list, right),
+                    list) <= 0)
+                {
+                    break;      /* found a value that's too small */
+                }
+
+                right -= itemSize;
+            }
+
+            if (left >= right)
+            {
+                /* went too far */
+                break;
+            }
+
+            /* swap left and right */
+            Swap(VoidPtrOffset(list, left), VoidPtrOffset(list, right), temp,
+                itemSize);
+        }
+
+        /* found place for start */
+        Swap(list, VoidPtrOffset(list, right), temp, itemSize);
+
+        /* sort each partition  [0 .. right] and [right + 1 .. end] */
+        QuickSortPartition(list, right / itemSize, itemSize, compareFunc,
+            temp, guarded);
+        QuickSortPartition(VoidPtrOffset(list, (right + itemSize)),
+            numItems - ((right / itemSize) + 1), itemSize, compareFunc, temp,
+            FALSE);
+
+        StatLeave();
+    }
+}
+
+/***************************************************************************
+*   Function   : MedianOfThree
+*   Description: This function finds the median of three items in a list.
+*   Parameters : list - a pointer of an array of items
+*                a, b, c - indices of the three items
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : NONE
+*   Returned   : The index of the median item.
+***************************************************************************/
+static size_t MedianOfThree(void *list, size_t a, size_t b, size_t c,
+    size_t itemSize, int (*compareFunc) (const void *, const void *))
+{
+    void *pa, *pb, *pc;
+
+    pa = VoidPtrOffset(list, a * itemSize);
+    pb = VoidPtrOffset(list, b * itemSize);
+    pc = VoidPtrOffset(list, c * itemSize);
+
+    if (CompareItems(compareFunc, pa, pb) < 0)
+    {
+        if (CompareItems(compareFunc, pb, pc) < 0)
+        {
+            return b;
+        }
+
+        return (CompareItems(compareFunc, pa, pc) < 0) ? c : a;
+    }
+
+    if (CompareItems(compareFunc, pb, pc) > 0)
+    {
+        return b;
+    }
+
+    return (CompareItems(compareFunc, pa, pc) < 0) ? a : c;
+}
+
+/***************************************************************************
+*   Function   : SwapRange
+*   Description: This function swaps two non-overlapping ranges of items.
+*   Parameters : list - a pointer of an array of items
+*                a - index of the first item in the first range
+*                b - index of the first item in the second range
+*                count - number of items in each range
+*                itemSize - size of each item in the array
+*                temp - a temporary variable for use by Swap() function
+*   Effects    : list[a] .. list[a + count - 1] are swapped with
+*                list[b] .. list[b + count - 1]
+*   Returned   : NONE
+***************************************************************************/
+static void SwapRange(void *list, size_t a, size_t b, size_t count,
+    size_t itemSize, void *temp)
+{
+    a *= itemSize;
+    b *= itemSize;
+
+    for (; count > 0; count--)
+    {
+        Swap(VoidPtrOffset(list, a), VoidPtrOffset(list, b), temp, itemSize);
+        a += itemSize;
+        b += itemSize;
+    }
+}
+
+/***************************************************************************
+*   Function   : QuickSort3WayPartition
+*   Description: This function does the work of QuickSort3Way.  It uses
+*                Bentley and McIlroy's "fat partition".  While the list is
+*                scanned, items equal to the pivot are swapped to the ends
+*                of the list.  When the scan is done, they are swapped into
+*                the middle, and only the items less than and greater than
+*                the pivot need to be sorted.  The smaller partition is
+*                sorted recursively and the larger one iteratively, so the
+*                recursion depth is at most log2(N).
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                temp - a temporary variable for use by Swap() function
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void QuickSort3WayPartition(void *list, size_t numItems,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    void *temp)
+{
+    QuickSort3WayRecursive(list, numItems, itemSize, compareFunc, temp,
+        TRUE);
+}
+
+/***************************************************************************
+*   Function   : QuickSort3WayRecursive
+*   Description: This function partitions a list for QuickSort3Way and
+*                sorts each partition.  See QuickSort3WayPartition.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                temp - a temporary variable for use by Swap() function
+*                guarded - FALSE if the item before list[0] isn't ordered
+*                          after any item in the list
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+static void QuickSort3WayRecursive(void *list, size_t numItems,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    void *temp, bool_t guarded)
+{
+    size_t a, b, c, d;          /* [0, a) == pivot < [a, b) .. (c, d] > */
+    size_t pivot, step, count;
+    int result;
+
+    StatEnter();
+
+    while (numItems > sortTuning.insertionCutoff)
+    {
+        /* median of three, or Tukey's ninther for larger lists */
+        pivot = numItems / 2;
+
+        if (numItems > 40)
+        {
+            step = numItems / 8;
+            a = MedianOfThree(list, 0, step, 2 * step, itemSize,
+                compareFunc);
+            pivot = MedianOfThree(list, pivot - step, pivot, pivot + step,
+                itemSize, compareFunc);
+            c = MedianOfThree(list, numItems - 1 - (2 * step),
+                numItems - 1 - step, numItems - 1, itemSize, compareFunc);
+            pivot = MedianOfThree(list, a, pivot, c, itemSize, compareFunc);
+        }
+        else
+        {
+            pivot = MedianOfThree(list, 0, pivot, numItems - 1, itemSize,
+                compareFunc);
+        }
+
+        /* the pivot is kept at list[0] while partitioning */
+        if (pivot != 0)
+        {
+            Swap(list, VoidPtrOffset(list, pivot * itemSize), temp, itemSize);
+        }
+
+        a = b = 1;
+        c = d = numItems - 1;
+
+        while (!0)
+        {
+            while (b <= c)
+            {
+                result = CompareItems(compareFunc,
+                    VoidPtrOffset(list, b * itemSize), list);
+
+                if (result > 0)
+                {
+                    break;
+                }
+
+                if (0 == result)
+                {
+                    /* move the equal item to the left end */
+                    Swap(VoidPtrOffset(list, a * itemSize),
+                        VoidPtrOffset(list, b * itemSize), temp, itemSize);
+                    a++;
+                }
+
+                b++;
+            }
+
+            while (b <= c)
+            {
+                result = CompareItems(compareFunc,
+                    VoidPtrOffset(list, c * itemSize), list);
+
+                if (result < 0)
+                {
+                    break;
+                }
+
+                if (0 == result)
+                {
+                    /* move the equal item to the right end */
+                    Swap(VoidPtrOffset(list, c * itemSize),
+                        VoidPtrOffset(list, d * itemSize), temp, itemSize);
+                    d--;
+                }
+
+                c--;
+            }
+
+            if (b > c)
+            {
+                break;
+            }
+
+            Swap(VoidPtrOffset(list, b * itemSize),
+                VoidPtrOffset(list, c * itemSize), temp, itemSize);
+            b++;
+            c--;
+        }
+
+        /* swap the equal items from the ends into the middle */
+        count = (a < (b - a)) ? a : (b - a);
+        SwapRange(list, 0, b - count, count, itemSize, temp);
+
+        count = ((d - c) < (numItems - 1 - d)) ? (d - c) : (numItems - 1 - d);
+        SwapRange(list, b, numItems - count, count, itemSize, temp);
+
+        /* [0, b - a) is less than the pivot, the last d - c items greater */
+        a = b - a;
+        d = d - c;
+
+        if (a < d)
+        {
+            QuickSort3WayRecursive(list, a, itemSize, compareFunc, temp,
+                guarded);
+            list = VoidPtrOffset(list, (numItems - d) * itemSize);
+            numItems = d;
+            guarded = FALSE;    /* items equal to the pivot come before */
+        }
+        else
+        {
+            QuickSort3WayRecursive(VoidPtrOffset(list,
+                (numItems - d) * itemSize), d, itemSize, compareFunc, temp,
+                FALSE);
+            numItems = a;
+        }
+    }
+
+    InsertionSortLeaf(list, numItems, itemSize, compareFunc, temp, guarded);
+    StatLeave();
+}
+
+/***************************************************************************
+*   Function   : QuickSort3Way
+*   Description: This function performs a three-way quick sort on array of
+*                items using scratch memory from the heap.  See
+*                QuickSort3WayCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void QuickSort3Way(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sort_error_t result;
+
+    result = QuickSort3WayCtx(NULL, list, numItems, itemSize, compareFunc);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : QuickSort3WayCtx
+*   Description: This function performs a three-way quick sort on array of
+*                items.  Items equal to the pivot are grouped together and
+*                never examined again, so lists with only K distinct values
+*                are sorted in order N * K time (or better) instead of
+*                N * log(N).  This makes it the best choice for lists with
+*                many duplicates.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t QuickSort3WayCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    void *temp;
+
+    if (SortIsSorted(list, numItems, itemSize, compareFunc))
+    {
+        /* singleton and already sorted lists need no work */
+        return SORT_OK;
+    }
+
+    /* create temporary swap variable */
+    temp = ContextAlloc(ctx, itemSize);
+
+    if (NULL == temp)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    QuickSort3WayPartition(list, numItems, itemSize, compareFunc, temp);
+    ContextFree(ctx, temp, itemSize);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : DualPivotPartition
+*   Description: This function does the work of DualPivotQuickSort.  It
+*                uses Yaroslavskiy's partition.  Five evenly spaced items
+*                are sorted, and the second and fourth become the pivots
+*                p1 <= p2, which are kept at the ends of the list.  A single
+*                scan divides the rest of the list into the items less than
+*                p1, the items between p1 and p2, and the items greater than
+*                p2.  The two smaller partitions are sorted recursively and
+*                the largest iteratively.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                temp - a temporary variable for use by Swap() function
+*                guarded - FALSE if the item before list[0] isn't ordered
+*                          after any item in the list
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+static void DualPivotPartition(void *list, size_t numItems,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    void *temp, bool_t guarded)
+{
+    size_t sample[5];           /* indices of the pivot candidates */
+    size_t less, great, k;      /* [1, less) < p1 <= [less, k) <= p2 < */
+    size_t i, j, last, step;
+    size_t sizes[3];            /* sizes of the three partitions */
+    void *p1, *p2, *item;
+    bool_t distinct;
+
+    StatEnter();
+
+    while ((numItems > sortTuning.insertionCutoff) &&
+        (numItems >= DUAL_PIVOT_MIN_ITEMS))
+    {
+        last = numItems - 1;
+
+        /* sort five evenly spaced items in place */
+        step = numItems / 6;
+
+        for (i = 0; i < 5; i++)
+        {
+            sample[i] = step * (i + 1);
+        }
+
+        for (i = 1; i < 5; i++)
+        {
+            for (j = i; j > 0; j--)
+            {
+                if (CompareItems(compareFunc,
+                    VoidPtrOffset(list, sample[j] * itemSize),
+                    VoidPtrOffset(list, sample[j - 1] * itemSize)) >= 0)
+                {
+                    break;
+                }
+
+                Swap(VoidPtrOffset(list, sample[j] * itemSize),
+                    VoidPtrOffset(list, sample[j - 1] * itemSize), temp,
+                    itemSize);
+            }
+        }
+
+        /* the second and fourth items are the pivots, move them to the ends */
+        Swap(list, VoidPtrOffset(list, sample[1] * itemSize), temp, itemSize);
+        Swap(VoidPtrOffset(list, last * itemSize),
+            VoidPtrOffset(list, sample[3] * itemSize), temp, itemSize);
+
+        p1 = list;
+        p2 = VoidPtrOffset(list, last * itemSize);
+        distinct = (CompareItems(compareFunc, p1, p2) < 0) ? TRUE : FALSE;
+
+        less = 1;
+        great = last - 1;
+
+        for (k = less; k <= great; k++)
+        {
+            item = VoidPtrOffset(list, k * itemSize);
+
+            if (CompareItems(compareFunc, item, p1) < 0)
+            {
+                /* item belongs in the left partition */
+                if (k != less)
+                {
+                    Swap(item, VoidPtrOffset(list, less * itemSize), temp,
+                        itemSize);
+                }
+
+                less++;
+            }
+            else if (CompareItems(compareFunc, item, p2) > 0)
+            {
+                /* item belongs in the right partition, find it a place */
+                while ((k < great) &&
+                    (CompareItems(compareFunc,
+                        VoidPtrOffset(list, great * itemSize), p2) > 0))
+                {
+                    great--;
+                }
+
+                Swap(item, VoidPtrOffset(list, great * itemSize), temp,
+                    itemSize);
+                great--;
+
+                /* the item swapped in may belong in the left partition */
+                if (CompareItems(compareFunc, item, p1) < 0)
+                {
+                    if (k != less)
+                    {
+                        Swap(item, VoidPtrOffset(list, less * itemSize),
+                            temp, itemSize);
+                    }
+
+                    less++;
+                }
+            }
+        }
+
+        /* move the pivots into their final places */
+        less--;
+        great++;
+        Swap(list, VoidPtrOffset(list, less * itemSize), temp, itemSize);
+        Swap(VoidPtrOffset(list, last * itemSize),
+            VoidPtrOffset(list, great * itemSize), temp, itemSize);
+
+        /* [0, less) < p1 = list[less], list[great] = p2 < (great, last] */
+        sizes[0] = less;
+        sizes[1] = great - less - 1;
+        sizes[2] = last - great;
+
+        if (FALSE == distinct)
+        {
+            /* p1 == p2, so everything between them is equal too */
+            sizes[1] = 0;
+        }
+
+        /* sort the two smaller partitions recursively, loop on the largest */
+        if ((sizes[0] >= sizes[1]) && (sizes[0] >= sizes[2]))
+        {
+            DualPivotPartition(VoidPtrOffset(list, (less + 1) * itemSize),
+                sizes[1], itemSize, compareFunc, temp, FALSE);
+            DualPivotPartition(VoidPtrOffset(list, (great + 1) * itemSize),
+                sizes[2], itemSize, compareFunc, temp, FALSE);
+            numItems = sizes[0];
+        }
+        else if (sizes[1] >= sizes[2])
+        {
+            DualPivotPartition(list, sizes[0], itemSize, compareFunc, temp,
+                guarded);
+            DualPivotPartition(VoidPtrOffset(list, (great + 1) * itemSize),
+                sizes[2], itemSize, compareFunc, temp, FALSE);
+            list = VoidPtrOffset(list, (less + 1) * itemSize);
+            numItems = sizes[1];
+            guarded = FALSE;    /* p1 comes before */
+        }
+        else
+        {
+            DualPivotPartition(list, sizes[0], itemSize, compareFunc, temp,
+                guarded);
+            DualPivotPartition(VoidPtrOffset(list, (less + 1) * itemSize),
+                sizes[1], itemSize, compareFunc, temp, FALSE);
+            list = VoidPtrOffset(list, (great + 1) * itemSize);
+            numItems = sizes[2];
+            guarded = FALSE;    /* p2 comes before */
+        }
+    }
+
+    InsertionSortLeaf(list, numItems, itemSize, compareFunc, temp, guarded);
+    StatLeave();
+}
+
+/***************************************************************************
+*   Function   : DualPivotQuickSort
+*   Description: This function performs Yaroslavskiy's dual-pivot quick
+*                sort on array of items using scratch memory from the heap.
+*                See DualPivotQuickSortCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void DualPivotQuickSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sort_error_t result;
+
+    result = DualPivotQuickSortCtx(NULL, list, numItems, itemSize,
+        compareFunc);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : DualPivotQuickSortCtx
+*   Description: This function performs Yaroslavskiy's dual-pivot quick
+*                sort on array of items.  Each pass splits the list into
+*                three partitions instead of two, so fewer passes are made
+*                over the data than with a single pivot quick sort.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t DualPivotQuickSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    void *temp;
+
+    if (SortIsSorted(list, numItems, itemSize, compareFunc))
+    {
+        /* singleton and already sorted lists need no work */
+        return SORT_OK;
+    }
+
+    /* create temporary swap variable */
+    temp = ContextAlloc(ctx, itemSize);
+
+    if (NULL == temp)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    DualPivotPartition(list, numItems, itemSize, compareFunc, temp, TRUE);
+    ContextFree(ctx, temp, itemSize);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : MergeSort
+*   Description: This function performs an merge sort on array of items
+*                using scratch memory from the heap.  See MergeSortCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void MergeSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sort_error_t result;
+
+    result = MergeSortCtx(NULL, list, numItems, itemSize, compareFunc);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : MergeSortCtx
+*   Description: This function performs an merge sort on array of items.
+*                A single buffer the size of the list is allocated and is
+*                used for every merge.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t MergeSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    void *merged, *temp;
+
+    if (SortIsSorted(list, numItems, itemSize, compareFunc))
+    {
+        /* singleton and already sorted lists need no work */
+        return SORT_OK;
+    }
+
+    merged = ContextAlloc(ctx, numItems * itemSize);
+
+    if (NULL == merged)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    /* create temporary variable for insertion sorts */
+    temp = ContextAlloc(ctx, itemSize);
+
+    if (NULL == temp)
+    {
+        ContextFree(ctx, merged, numItems * itemSize);
+        return SORT_ERR_NOMEM;
+    }
+
+    MergeSortRecursive(list, numItems, itemSize, compareFunc, merged, temp);
+
+    ContextFree(ctx, temp, itemSize);
+    ContextFree(ctx, merged, numItems * itemSize);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : MergeSortRecursive
+*   Description: This function does the work of MergeSort.  Each half of
+*                the list is sorted recursively, then the halves are merged
+*                into the buffer and copied back.  Items that are ordered
+*                the same are taken from the low half first, so the sort
+*                is stable.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                merged - a buffer with room for numItems items
+*                temp - a temporary variable for use by insertion sort
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void MergeSortRecursive(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), void *merged,
+    void *temp)
+{
+    size_t pivot;
+    size_t lowPtr, highPtr, mergedPtr;
+
+    if (numItems <= 1)
+    {
+        /* singleton lists are already sorted */
+        return;
+    }
+
+    if (numItems <= sortTuning.insertionCutoff)
+    {
+        /* small lists sort faster with binary insertion sort */
+        BinaryInsertionSortTemp(list, numItems, 1, itemSize, compareFunc,
+            temp);
+        return;
+    }
+
+    StatEnter();
+
+    /* divide the list in half */
+    pivot = (numItems - 1) / 2;
+
+    /* sort each half of the list */
+    MergeSortRecursive(list, (pivot + 1), itemSize, compareFunc, merged,
+        temp);
+    MergeSortRecursive(VoidPtrOffset(list, ((pivot + 1) * itemSize)),
+        numItems - pivot - 1, itemSize, compareFunc, merged, temp);
+
+    /***********************************************************************
+    * merge list[0] .. list[pivot] with
+    * list[pivot + 1] .. list[numItems - 1]
+    * Indices are multiples of itemSize from here on out
+    ************************************************************************/
+    pivot *=  itemSize;
+    numItems *= itemSize;
+    lowPtr = 0;
+    highPtr = pivot + itemSize;
+    mergedPtr = 0;
+
+    while ((lowPtr <= pivot) && (highPtr < numItems))
+    {
+        /* copy lowest value pointed to into merged list, low half wins ties */
+        if (CompareItems(compareFunc, VoidPtrOffset(list, highPtr),
+            VoidPtrOffset(list, lowPtr)) < 0)
+        {
+            CopyItem(VoidPtrOffset(merged, mergedPtr),
+                VoidPtrOffset(list, highPtr), itemSize);
+            highPtr += itemSize;
+        }
+        else
+        {
+            CopyItem(VoidPtrOffset(merged, mergedPtr),
+                VoidPtrOffset(list, lowPtr), itemSize);
+            lowPtr += itemSize;
+        }
+
+        mergedPtr += itemSize;
+    }
+
+    /* one of the halves ran out of data, just copy from the other half */
+    if (lowPtr > pivot)
+    {
+        /* finish high half */
+        while(highPtr < numItems)
+        {
+            CopyItem(VoidPtrOffset(merged, mergedPtr),
+                VoidPtrOffset(list, highPtr), itemSize);
+            mergedPtr += itemSize;
+            highPtr += itemSize;
+        }
+    }
+    else
+    {
+        /* finish low half */
+        while(lowPtr <= pivot)
+        {
+            CopyItem(VoidPtrOffset(merged, mergedPtr),
+                VoidPtrOffset(list, lowPtr), itemSize);
+            mergedPtr += itemSize;
+            lowPtr += itemSize;
+        }
+    }
+
+    /* now copy the merged arrays out of merged */
+    CopyItems(list, merged, numItems / itemSize, itemSize);
+    StatLeave();
+}
+
+/***************************************************************************
+*   Function   : MergeRuns
+*   Description: This function merges two adjacent sorted runs of items
+*                into the same positions of a destination array.  When
+*                items are ordered the same, the item from the low run is
+*                copied first, so the merge is stable.
+*   Parameters : src - array containing the runs to merge
+*                dst - array receiving the merged run
+*                low - index of the first item in the low run
+*                mid - index of the first item in the high run
+*                high - index one past the last item of the high run
+*                itemSize - size of each item in the arrays
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : dst[low] .. dst[high - 1] contain the merged runs
 *   Returned   : NONE
 ***************************************************************************/
-void BubbleSort(void *list, size_t numItems, size_t itemSize,
+static void MergeRuns(const void *src, void *dst, size_t low, size_t mid,
+    size_t high, size_t itemSize,
     int (*compareFunc) (const void *, const void *))
 {
-    size_t i, endItem;
-    bool_t done = FALSE;    /* true if no swaps last pass */
-    void *temp;
+    size_t lowPtr, highPtr, mergedPtr;
 
-    /* create temporary swap variable */
-    temp = malloc(itemSize);
-    assert(temp != NULL);
+    /* indices are multiples of itemSize from here on out */
+    lowPtr = low * itemSize;
+    mid *= itemSize;
+    highPtr = mid;
+    high *= itemSize;
+    mergedPtr = lowPtr;
 
-    while (TRUE != done)
+    while ((lowPtr < mid) && (highPtr < high))
     {
-        done = TRUE;
-        numItems--;     /* one less item left to sort after each pass */
-        endItem = numItems * itemSize;
-
-        /* push largest value to end of list each iteration */
-        for (i = 0; i < endItem; i += itemSize)
+        /* copy the lowest value into dst, low run wins ties */
+        if (CompareItems(compareFunc, VoidPtrOffset(src, highPtr),
+            VoidPtrOffset(src, lowPtr)) < 0)
         {
-            if (compareFunc(VoidPtrOffset(list, (i + itemSize)),
-                VoidPtrOffset(list, i)) < 0)
-            {
-                /* swap values */
-                Swap(VoidPtrOffset(list, i),
-                    VoidPtrOffset(list, (i + itemSize)), temp, itemSize);
-                done = FALSE;
-            }
+            CopyItem(VoidPtrOffset(dst, mergedPtr),
+                VoidPtrOffset(src, highPtr), itemSize);
+            highPtr += itemSize;
+        }
+        else
+        {
+            CopyItem(VoidPtrOffset(dst, mergedPtr),
+                VoidPtrOffset(src, lowPtr), itemSize);
+            lowPtr += itemSize;
         }
+
+        mergedPtr += itemSize;
     }
 
-    free(temp);
+    /* one of the runs ran out of data, just copy the rest of the other */
+    if (lowPtr < mid)
+    {
+        CopyItems(VoidPtrOffset(dst, mergedPtr), VoidPtrOffset(src, lowPtr),
+            (mid - lowPtr) / itemSize, itemSize);
+    }
+    else if (highPtr < high)
+    {
+        CopyItems(VoidPtrOffset(dst, mergedPtr), VoidPtrOffset(src, highPtr),
+            (high - highPtr) / itemSize, itemSize);
+    }
 }
 
 /***************************************************************************
-*   Function   : ShellSort
-*   Description: This function performs an Shell sort on array of items.
+*   Function   : NaturalMergeSort
+*   Description: This function performs a natural merge sort on array of items
+*                using scratch memory from the heap.  See NaturalMergeSortCtx.
 *   Parameters : list - a pointer of an array of items to sort
 *                numItems - number of items in the array
 *                itemSize - size of each item in the array
@@ -221,57 +1737,35 @@ void BubbleSort(void *list, size_t numItems, size_t itemSize,
 *   Effects    : The contents of list are sorted in ascending order
 *   Returned   : NONE
 ***************************************************************************/
-void ShellSort(void *list, size_t numItems, size_t itemSize,
+void NaturalMergeSort(void *list, size_t numItems, size_t itemSize,
     int (*compareFunc) (const void *, const void *))
 {
-    size_t i, j, endItem;
-    size_t increment, incrementItem;    /* spacing between sorted numbers */
-    void *temp;
-
-    /* create temporary swap variable */
-    temp = malloc(itemSize);
-    assert(temp != NULL);
-
-    /* determine starting increment size in the form of (3^k - 1) */
-    for (increment = 1;
-        increment <= numItems;
-        increment = (increment * 3) + 1);
+    sort_error_t result;
 
-    endItem = numItems * itemSize;
+    result = NaturalMergeSortCtx(NULL, list, numItems, itemSize,
+        compareFunc);
 
-    /* loop through partial sorts */
-    for (increment /= 3; increment > 0; increment /= 3)
+    if (SORT_ERR_NOMEM == result)
     {
-        incrementItem = increment * itemSize;
-
-        /* insertion sort at increment spacing */
-        for (i = incrementItem; i < endItem; i += itemSize)
-        {
-            j = i;
-            memcpy(temp, VoidPtrOffset(list, i), itemSize);
-
-            /* look for a place to insert list[i] using increment spacing */
-            while ((j >= incrementItem) &&
-                (compareFunc(temp,
-                    VoidPtrOffset(list, (j - incrementItem))) < 0))
-            {
-                memcpy(VoidPtrOffset(list, j),
-                    VoidPtrOffset(list, (j - incrementItem)),
-                    itemSize);
-                j = j - incrementItem;
-            }
-
-            memcpy(VoidPtrOffset(list, j), temp, itemSize);
-        }
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
     }
 
-    free(temp);
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
 }
 
 /***************************************************************************
-*   Function   : QuickSort
-*   Description: This function performs an quick sort on array of items.
-*   Parameters : list - a pointer of an array of items to sort
+*   Function   : NaturalMergeSortCtx
+*   Description: This function performs a natural merge sort on array of
+*                items.  Rather than blindly splitting the list in half,
+*                it finds the runs that are already in order (reversing
+*                runs that are in strictly descending order) and merges
+*                them, so lists that are sorted or nearly sorted take
+*                order N time.  Runs shorter than the insertion sort cutoff
+*                are extended with an insertion sort.  The sort is stable.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
 *                numItems - number of items in the array
 *                itemSize - size of each item in the array
 *                compareFunc - a comparison function such that:
@@ -279,174 +1773,170 @@ void ShellSort(void *list, size_t numItems, size_t itemSize,
 *                   compareFunc(x, y) = 0  iff x and y are ordered the same
 *                   compareFunc(x, y) > 0  iff y precedes x
 *   Effects    : The contents of list are sorted in ascending order
-*   Returned   : NONE
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
 ***************************************************************************/
-void QuickSort(void *list, size_t numItems, size_t itemSize,
+sort_error_t NaturalMergeSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
     int (*compareFunc) (const void *, const void *))
 {
-    size_t left, right;         /* partition pointers */
+    size_t *runs;                   /* index of the start of each run */
+    size_t numRuns, maxRuns, minRun;
+    size_t start, end, i, j;
+    void *buffer, *src, *dst, *swap;
     void *temp;
 
-    if (numItems > 1)
+    if (numItems <= 1)
     {
-        /* create temporary swap variable */
-        temp = malloc(itemSize);
-        assert(temp != NULL);
+        /* singleton lists are already sorted */
+        return SORT_OK;
+    }
 
-        left = 0;
-        right = (numItems  - 1) * itemSize;
+    minRun = (sortTuning.insertionCutoff > 1) ? sortTuning.insertionCutoff : 2;
 
-        while(!0)
+    /* every run but the last has at least minRun items, plus a sentinel */
+    maxRuns = (numItems / minRun) + 2;
+    runs = (size_t *)ContextAlloc(ctx, maxRuns * sizeof(size_t));
+
+    if (NULL == runs)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    /* create temporary swap variable */
+    temp = ContextAlloc(ctx, itemSize);
+
+    if (NULL == temp)
+    {
+        ContextFree(ctx, runs, maxRuns * sizeof(size_t));
+        return SORT_ERR_NOMEM;
+    }
+
+    /* find the runs */
+    numRuns = 0;
+    start = 0;
+
+    while (start < numItems)
+    {
+        end = start + 1;
+
+        if ((end < numItems) &&
+            (CompareItems(compareFunc, VoidPtrOffset(list, end * itemSize),
+                VoidPtrOffset(list, start * itemSize)) < 0))
         {
-            /* seek until something on left partition is too large */
-            while (left < right)
+            /* strictly descending run, reversing it keeps the sort stable */
+            for (end++; end < numItems; end++)
             {
-                left += itemSize;
-
-                if (compareFunc(VoidPtrOffset(list, left), list) > 0)
+                if (CompareItems(compareFunc,
+                    VoidPtrOffset(list, end * itemSize),
+                    VoidPtrOffset(list, (end - 1) * itemSize)) >= 0)
                 {
-                    break;      /* found a value that's too large */
+                    break;
                 }
             }
 
-            if (left > right)
+            for (i = start, j = end - 1; i < j; i++, j--)
             {
-                /* went too far */
-                break;
+                Swap(VoidPtrOffset(list, i * itemSize),
+                    VoidPtrOffset(list, j * itemSize), temp, itemSize);
             }
-
-            /* seek until something on right partition is too small */
-            while (left <= right)
+        }
+        else
+        {
+            /* ascending run */
+            for (; end < numItems; end++)
             {
-                if (compareFunc(VoidPtrOffset(list, right), list) <= 0)
+                if (CompareItems(compareFunc,
+                    VoidPtrOffset(list, end * itemSize),
+                    VoidPtrOffset(list, (end - 1) * itemSize)) < 0)
                 {
-                    break;      /* found a value that's too small */
+                    break;
                 }
-
-                right -= itemSize;
             }
+        }
 
-            if (left >= right)
+        if (((end - start) < minRun) && (end < numItems))
+        {
+            /* short run, insert the items after it until it's minRun long */
+            i = end - start;
+            end = start + minRun;
+
+            if (end > numItems)
             {
-                /* went too far */
-                break;
+                end = numItems;
             }
 
-            /* swap left and right */
-            Swap(VoidPtrOffset(list, left), VoidPtrOffset(list, right), temp,
-                itemSize);
+            BinaryInsertionSortTemp(VoidPtrOffset(list, start * itemSize),
+                end - start, i, itemSize, compareFunc, temp);
         }
 
-        /* found place for start */
-        Swap(list, VoidPtrOffset(list, right), temp, itemSize);
-        free(temp);
-
-        /* sort each partition  [0 .. right] and [right + 1 .. end] */
-        QuickSort(list, right / itemSize, itemSize, compareFunc);
-        QuickSort(VoidPtrOffset(list, (right + itemSize)),
-            numItems - ((right / itemSize) + 1), itemSize, compareFunc);
+        runs[numRuns] = start;
+        numRuns++;
+        start = end;
     }
-}
 
-/***************************************************************************
-*   Function   : MergeSort
-*   Description: This function performs an merge sort on array of items.
-*   Parameters : list - a pointer of an array of items to sort
-*                numItems - number of items in the array
-*                itemSize - size of each item in the array
-*                compareFunc - a comparison function such that:
-*                   compareFunc(x, y) < 0  iff x precedes y
-*                   compareFunc(x, y) = 0  iff x and y are ordered the same
-*                   compareFunc(x, y) > 0  iff y precedes x
-*   Effects    : The contents of list are sorted in ascending order
-*   Returned   : NONE
-***************************************************************************/
-void MergeSort(void *list, size_t numItems, size_t itemSize,
-    int (*compareFunc) (const void *, const void *))
-{
-    size_t pivot;
-    void *merged;
-    size_t lowPtr, highPtr, mergedPtr;
+    runs[numRuns] = numItems;
+    ContextFree(ctx, temp, itemSize);
 
-    if (numItems <= 1)
+    if (1 == numRuns)
     {
-        /* singleton lists are already sorted */
-        return;
+        /* the list was already sorted (or reversed) */
+        ContextFree(ctx, runs, maxRuns * sizeof(size_t));
+        return SORT_OK;
     }
 
-    /* divide the list in half */
-    pivot = (numItems - 1) / 2;
-
-    /* sort each half of the list */
-    MergeSort(list, (pivot + 1), itemSize, compareFunc);
-    MergeSort(VoidPtrOffset(list, ((pivot + 1) * itemSize)),
-        numItems - pivot - 1, itemSize, compareFunc);
+    buffer = ContextAlloc(ctx, numItems * itemSize);
 
-    merged = malloc(numItems * itemSize);
-    assert(merged != NULL);
+    if (NULL == buffer)
+    {
+        ContextFree(ctx, runs, maxRuns * sizeof(size_t));
+        return SORT_ERR_NOMEM;
+    }
 
-    /***********************************************************************
-    * merge list[0] .. list[pivot] with
-    * list[pivot + 1] .. list[numItems - 1]
-    * Indices are multiples of itemSize from here on out
-    ************************************************************************/
-    pivot *=  itemSize;
-    numItems *= itemSize;
-    lowPtr = 0;
-    highPtr = pivot + itemSize;
-    mergedPtr = 0;
+    /* merge pairs of runs, alternating between list and buffer */
+    src = list;
+    dst = buffer;
 
-    while ((lowPtr <= pivot) && (highPtr < numItems))
+    while (numRuns > 1)
     {
-        /* copy lowest value pointed to into merged list */
-        if (compareFunc(VoidPtrOffset(list, lowPtr),
-            VoidPtrOffset(list, highPtr)) < 0)
-        {
-            memcpy(VoidPtrOffset(merged, mergedPtr),
-                VoidPtrOffset(list, lowPtr),
-                itemSize);
-            lowPtr += itemSize;
-        }
-        else
+        j = 0;      /* number of merged runs */
+
+        for (i = 0; i < numRuns; i += 2)
         {
-            memcpy(VoidPtrOffset(merged, mergedPtr),
-                VoidPtrOffset(list, highPtr),
-                itemSize);
-            highPtr += itemSize;
+            if ((i + 1) < numRuns)
+            {
+                MergeRuns(src, dst, runs[i], runs[i + 1], runs[i + 2],
+                    itemSize, compareFunc);
+            }
+            else
+            {
+                /* odd run out, copy it as is */
+                CopyItems(VoidPtrOffset(dst, runs[i] * itemSize),
+                    VoidPtrOffset(src, runs[i] * itemSize),
+                    runs[i + 1] - runs[i], itemSize);
+            }
+
+            runs[j] = runs[i];
+            j++;
         }
 
-        mergedPtr += itemSize;
-    }
+        runs[j] = numItems;
+        numRuns = j;
 
-    /* one of the halves ran out of data, just copy from the other half */
-    if (lowPtr > pivot)
-    {
-        /* finish high half */
-        while(highPtr < numItems)
-        {
-            memcpy(VoidPtrOffset(merged, mergedPtr),
-                VoidPtrOffset(list, highPtr),
-                itemSize);
-            mergedPtr += itemSize;
-            highPtr += itemSize;
-        }
+        swap = src;
+        src = dst;
+        dst = swap;
     }
-    else
+
+    if (src != list)
     {
-        /* finish low half */
-        while(lowPtr <= pivot)
-        {
-            memcpy(VoidPtrOffset(merged, mergedPtr),
-                VoidPtrOffset(list, lowPtr),
-                itemSize);
-            mergedPtr += itemSize;
-            lowPtr += itemSize;
-        }
+        /* the last merge was into the buffer */
+        CopyItems(list, src, numItems, itemSize);
     }
 
-    /* now copy the merged arrays out of merged */
-    memcpy(list, merged, numItems);
-    free(merged);
+    ContextFree(ctx, buffer, numItems * itemSize);
+    ContextFree(ctx, runs, maxRuns * sizeof(size_t));
+    return SORT_OK;
 }
 
 /***************************************************************************
@@ -467,13 +1957,12 @@ void MergeSort(void *list, size_t numItems, size_t itemSize,
 *                   compareFunc(x, y) < 0  iff x precedes y
 *                   compareFunc(x, y) = 0  iff x and y are ordered the same
 *                   compareFunc(x, y) > 0  iff y precedes x
-*                temp - a temporary variable for use by Swap() function
 *   Effects    : Promotes (sifts up) children larger than their parents
 *                along a path starting at root.
 *   Returned   : NONE
 ***************************************************************************/
 void SiftDown(void *list, size_t root, size_t lastChild, size_t itemSize,
-    int (*compareFunc) (const void *, const void *), void *temp)
+    int (*compareFunc) (const void *, const void *))
 {
     size_t child;
 
@@ -483,7 +1972,7 @@ void SiftDown(void *list, size_t root, size_t lastChild, size_t itemSize,
         if (child < lastChild)
         {
             /* there is a right child */
-            if (compareFunc(VoidPtrOffset(list, (child * itemSize)),
+            if (CompareItems(compareFunc, VoidPtrOffset(list, (child * itemSize)),
                 VoidPtrOffset(list, ((child + 1) * itemSize))) < 0)
             {
                 /* right child is actually larger */
@@ -491,21 +1980,54 @@ void SiftDown(void *list, size_t root, size_t lastChild, size_t itemSize,
             }
         }
 
-        if (compareFunc(VoidPtrOffset(list, (child * itemSize)),
+        if (CompareItems(compareFunc, VoidPtrOffset(list, (child * itemSize)),
             VoidPtrOffset(list, (root * itemSize))) <= 0)
         {
             break;
         }
 
         /* child is greater than its parent, swap them */
-        Swap((void *)VoidPtrOffset(list, (root * itemSize)),
-            VoidPtrOffset(list, (child * itemSize)), temp, itemSize);
+        SwapInPlace(VoidPtrOffset(list, (root * itemSize)),
+            VoidPtrOffset(list, (child * itemSize)), itemSize);
+    }
+}
+
+/***************************************************************************
+*   Function   : SwapInPlace
+*   Description: This function swaps two items through a small buffer on
+*                the stack, SWAP_CHUNK_BYTES at a time, so that heap sort
+*                doesn't need any scratch memory.
+*   Parameters : x - pointer to the first item
+*                y - pointer to the second item
+*                itemSize - size of each item
+*   Effects    : The contents of x and y are exchanged
+*   Returned   : NONE
+***************************************************************************/
+static void SwapInPlace(void *x, void *y, size_t itemSize)
+{
+    char chunk[SWAP_CHUNK_BYTES];
+    char *a, *b;
+    size_t size;
+
+    StatMove(3, itemSize);
+    a = (char *)x;
+    b = (char *)y;
+
+    for (; itemSize > 0; itemSize -= size)
+    {
+        size = (itemSize < SWAP_CHUNK_BYTES) ? itemSize : SWAP_CHUNK_BYTES;
+        memcpy(chunk, a, size);
+        memcpy(a, b, size);
+        memcpy(b, chunk, size);
+        a += size;
+        b += size;
     }
 }
 
 /***************************************************************************
 *   Function   : HeapSort
-*   Description: This function performs an heap sort on array of items.
+*   Description: This function performs a heap sort on array of items
+*                using scratch memory from the heap.  See HeapSortCtx.
 *   Parameters : list - a pointer of an array of items to sort
 *                numItems - number of items in the array
 *                itemSize - size of each item in the array
@@ -518,26 +2040,53 @@ void SiftDown(void *list, size_t root, size_t lastChild, size_t itemSize,
 ***************************************************************************/
 void HeapSort(void *list, size_t numItems, size_t itemSize,
     int (*compareFunc) (const void *, const void *))
+{
+    sort_error_t result;
+
+    result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : HeapSortCtx
+*   Description: This function performs an heap sort on array of items.
+*                Items are swapped through a buffer on the stack, so heap
+*                sort never needs scratch memory and never fails.  The other
+*                comparison sorts fall back to it when their scratch memory
+*                isn't available and they can't return an error.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK
+***************************************************************************/
+sort_error_t HeapSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
 {
     size_t i;
-    void *temp;
 
-    if (numItems <= 1)
+    (void)ctx;      /* heap sort sorts in place */
+
+    if (SortIsSorted(list, numItems, itemSize, compareFunc))
     {
-        return;
+        /* singleton and already sorted lists need no work */
+        return SORT_OK;
     }
 
-    /* create temporary swap variable */
-    temp = malloc(itemSize);
-    assert(temp != NULL);
-
     /* build a heap adding one element at a time */
     for (i = numItems / 2; i > 0; i--)
     {
-        SiftDown(list, i, numItems - 1, itemSize, compareFunc, temp);
+        SiftDown(list, i, numItems - 1, itemSize, compareFunc);
     }
 
-    SiftDown(list, 0, numItems - 1, itemSize, compareFunc, temp);
+    SiftDown(list, 0, numItems - 1, itemSize, compareFunc);
 
     /***********************************************************************
     * The largest item is now at the top of the heap.  Pull it off the
@@ -549,22 +2098,22 @@ void HeapSort(void *list, size_t numItems, size_t itemSize,
     while (numItems > 1)
     {
         /* swap the largest item with the last item in the heap */
-        Swap(list, VoidPtrOffset(list, ((numItems - 1) * itemSize)) , temp,
+        SwapInPlace(list, VoidPtrOffset(list, ((numItems - 1) * itemSize)),
             itemSize);
 
         /* make the heap one item smaller and rebuild the heap */
         numItems--;
-        SiftDown(list, 0, numItems - 1, itemSize, compareFunc, temp);
+        SiftDown(list, 0, numItems - 1, itemSize, compareFunc);
     }
 
-    free(temp);
-    return;
+    return SORT_OK;
 }
 
 /***************************************************************************
 *   Function   : RadixSort
 *   Description: This function performs a single pass of a radix sort on
-*                array of items.
+*                array of items using scratch memory from the heap.  See
+*                RadixSortCtx.
 *   Parameters : list - a pointer of an array of items to sort
 *                numItems - number of items in the array
 *                itemSize - size of each item in the array
@@ -573,22 +2122,54 @@ void HeapSort(void *list, size_t numItems, size_t itemSize,
 *                          the current sorting pass.  The key values
 *                          are expected to range from 0 to (numKeys - 1)
 *   Effects    : The contents of list are sorted according to their key.
-*                Multiple calls to this function may be required to obtain
-*                the desired sort.
 *   Returned   : NONE
 ***************************************************************************/
 void RadixSort(void *list, size_t numItems, size_t itemSize,
     unsigned int numKeys, unsigned int (*keyFunc) (const void *))
+{
+    sort_error_t result;
+
+    result = RadixSortCtx(NULL, list, numItems, itemSize, numKeys, keyFunc);
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : RadixSortCtx
+*   Description: This function performs a single pass of a radix sort on
+*                array of items.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                numKeys - number of keys produced by keyFunc
+*                keyFunc - a function that generates a key used for
+*                          the current sorting pass.  The key values
+*                          are expected to range from 0 to (numKeys - 1)
+*   Effects    : The contents of list are sorted according to their key.
+*                Multiple calls to this function may be required to obtain
+*                the desired sort.
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t RadixSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    unsigned int numKeys, unsigned int (*keyFunc) (const void *))
 {
     size_t *keyCounters;            /* num values with the same key */
     size_t *offsetTable;            /* position of next value with key */
-    size_t i;
+    size_t i, count, offset;
     unsigned int key;
     void *temp;
+    radix_scatter_t *scatter;       /* staging lines, NULL if not used */
 
     /* create an array of zeroed key counters */
-    keyCounters = (size_t *)calloc(numKeys, sizeof(size_t));
-    assert(keyCounters != NULL);
+    keyCounters = (size_t *)ContextCalloc(ctx, numKeys, sizeof(size_t));
+
+    if (NULL == keyCounters)
+    {
+        return SORT_ERR_NOMEM;
+    }
 
     /* count occurances of values with same key */
     for (i = 0; i < numItems; i++)
@@ -597,40 +2178,69 @@ void RadixSort(void *list, size_t numItems, size_t itemSize,
         keyCounters[key] = keyCounters[key] + 1;
     }
 
-    /* allocate offset table */
-    offsetTable = (size_t *)malloc(numKeys * sizeof(size_t));
-    assert(offsetTable != NULL);
+    if ((numItems > 0) && (keyCounters[key] == numItems))
+    {
+        /* every item has the same key, this pass won't change anything */
+        StatAdd(radixPassesSkipped, 1);
+        ContextFree(ctx, keyCounters, numKeys * sizeof(size_t));
+        return SORT_OK;
+    }
+
+    temp = ContextAlloc(ctx, numItems * itemSize);
+
+    if (NULL == temp)
+    {
+        ContextFree(ctx, keyCounters, numKeys * sizeof(size_t));
+        return SORT_ERR_NOMEM;
+    }
 
-    offsetTable[0] = 0;         /* the first key 0 item starts at 0 */
+    /* the counters are turned into the offset table in place */
+    offsetTable = keyCounters;
+    offset = 0;                 /* the first key 0 item starts at 0 */
 
-    for(i = 1; i < numKeys; i++)
+    for(i = 0; i < numKeys; i++)
     {
         /* determine sorted offset for the first value with key i */
-        offsetTable[i] = offsetTable[i - 1] + keyCounters[i - 1];
+        count = keyCounters[i];
+        offsetTable[i] = offset;
+        offset += count;
     }
 
-    free(keyCounters);          /* we're done with keyCounters now */
+    /* now sort, through staging lines if they're worth using */
+    scatter = RadixScatterCreate(ctx, numKeys, itemSize);
 
-    temp = malloc(numItems * itemSize);
-    assert(temp != NULL);
+    if (NULL != scatter)
+    {
+        RadixScatterStart(scatter, temp, offsetTable);
 
-    /* now sort */
-    for (i = 0; i < numItems; i++)
+        for (i = 0; i < numItems; i++)
+        {
+            key = keyFunc(VoidPtrOffset(list, (itemSize * i)));
+            RadixScatterPut(scatter, key, VoidPtrOffset(list, (itemSize * i)));
+        }
+
+        RadixScatterFinish(scatter);
+        RadixScatterFree(ctx, scatter);
+    }
+    else
     {
-        key = keyFunc(VoidPtrOffset(list, (itemSize * i)));
+        for (i = 0; i < numItems; i++)
+        {
+            key = keyFunc(VoidPtrOffset(list, (itemSize * i)));
 
-        /* copy list + (itemSize * i) into its sorted position */
-        memcpy(VoidPtrOffset(temp, (offsetTable[key] * itemSize)),
-            VoidPtrOffset(list, (itemSize * i)),
-            itemSize);
+            /* copy list + (itemSize * i) into its sorted position */
+            CopyItem(VoidPtrOffset(temp, (offsetTable[key] * itemSize)),
+                VoidPtrOffset(list, (itemSize * i)), itemSize);
 
-        /* the next item with the same key is sorted one position higher */
-        offsetTable[key] = offsetTable[key] + 1;
+            /* the next item with the same key is sorted one position higher */
+            offsetTable[key] = offsetTable[key] + 1;
+        }
     }
 
     /* copy sorted data back to list */
-    memcpy(list, temp, itemSize * numItems);
+    CopyItems(list, temp, numItems, itemSize);
 
-    free(offsetTable);
-    free(temp);
+    ContextFree(ctx, temp, numItems * itemSize);
+    ContextFree(ctx, offsetTable, numKeys * sizeof(size_t));
+    return SORT_OK;
 }
@@ -49,39 +49,381 @@
 ***************************************************************************/
 #include <stdlib.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* SortContextCreate flags */
+#define SORT_CTX_HUGE_PAGES     0x01    /* back large blocks with huge pages */
+
+/* SortPoolStart flags */
+#define SORT_POOL_PIN_THREADS   0x01    /* keep each worker on one processor */
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* native numeric key types that may be radix sorted */
+typedef enum
+{
+    SORT_KEY_NONE,                      /* not numeric, use compareFunc */
+    SORT_KEY_INT,
+    SORT_KEY_UINT,
+    SORT_KEY_LONG,
+    SORT_KEY_ULONG,
+    SORT_KEY_FLOAT,
+    SORT_KEY_DOUBLE
+} sort_key_t;
+
+/* sort algorithms (used to report the algorithm SortAuto chose) */
+typedef enum
+{
+    SORT_ALG_NONE,
+    SORT_ALG_INSERTION,
+    SORT_ALG_BUBBLE,
+    SORT_ALG_SHELL,
+    SORT_ALG_QUICK,
+    SORT_ALG_MERGE,
+    SORT_ALG_NATURAL_MERGE,
+    SORT_ALG_HEAP,
+    SORT_ALG_RADIX,
+    SORT_ALG_QUICK_3WAY,
+    SORT_ALG_DUAL_PIVOT_QUICK,
+    SORT_ALG_SAMPLE
+} sort_algorithm_t;
+
+/* operation counts collected when the library is built with SORT_STATS */
+typedef struct
+{
+    unsigned long comparisons;          /* calls to compareFunc */
+    unsigned long moves;                /* items copied */
+    unsigned long bytesCopied;          /* bytes copied moving items */
+    unsigned long mallocs;              /* scratch allocations */
+    size_t scratchBytes;                /* scratch currently allocated */
+    size_t peakScratchBytes;            /* most scratch allocated at once */
+    unsigned long depth;                /* current recursion depth */
+    unsigned long maxDepth;             /* deepest recursion */
+    unsigned long radixPassesSkipped;   /* radix passes with a single key */
+    sort_algorithm_t algorithm;         /* last algorithm SortAuto chose */
+} sort_stats_t;
+
+/* Shell sort gap sequences, see ShellSortGaps */
+typedef enum
+{
+    SORT_GAPS_KNUTH,                    /* 1, 4, 13, 40, 121, ... */
+    SORT_GAPS_SEDGEWICK,                /* 1, 8, 23, 77, 281, ... */
+    SORT_GAPS_TOKUDA,                   /* 1, 4, 9, 20, 46, 103, ... */
+    SORT_GAPS_CIURA,                    /* 1, 4, 10, 23, 57, 132, ... */
+    SORT_GAPS_CUSTOM                    /* supplied by the caller */
+} sort_gaps_t;
+
+/* sorted array that accepts batches of items, see SortedBufferCreate */
+typedef struct sorted_buffer_t sorted_buffer_t;
+
+/* items pushed in any order and pulled in sorted order, see SortStreamCreate */
+typedef struct sort_stream_t sort_stream_t;
+
+/* sort done a slice at a time, see SortJobCreate */
+typedef struct sort_job_t sort_job_t;
+
+/* machine dependent thresholds, see SortCalibrate and SortLoadTuning */
+typedef struct
+{
+    size_t l1dCacheBytes;               /* level 1 data cache size */
+    size_t l2CacheBytes;                /* level 2 cache size */
+    size_t llcCacheBytes;               /* last level cache size */
+    size_t insertionCutoff;             /* insertion sort lists this small */
+    unsigned int radixBits;             /* widest radix sort digit */
+    size_t parallelGrain;               /* fewest items worth a thread */
+    size_t mergeBlockBytes;             /* bytes sorted in cache per block */
+} sort_tuning_t;
+
+/* errors returned by the Ctx versions of the sorts */
+typedef enum
+{
+    SORT_OK,                            /* success */
+    SORT_ERR_NOMEM,                     /* scratch memory wasn't available */
+    SORT_ERR_PARAM                      /* a parameter isn't supported */
+} sort_error_t;
+
+/* scratch memory kept between sorts, see SortContextCreate */
+typedef struct sort_context_t sort_context_t;
+
 /***************************************************************************
 *                               PROTOTYPES
 ***************************************************************************/
+/* zero stats and collect statistics for this thread's sorts into it */
+void SortStatsAttach(sort_stats_t *stats);
+
+/* fill tuning with the compiled-in default thresholds */
+void SortTuningDefaults(sort_tuning_t *tuning);
+
+/* get or replace the thresholds used by the library */
+void SortGetTuning(sort_tuning_t *tuning);
+void SortSetTuning(const sort_tuning_t *tuning);
+
+/* load/save thresholds from/to a profile, returns 1 for success */
+int SortLoadTuning(const char *fileName);
+int SortSaveTuning(const char *fileName, const sort_tuning_t *tuning);
+
+/* measure the best thresholds for this machine */
+void SortCalibrate(sort_tuning_t *tuning);
+
+/* sort context, NULL arena to allocate memory as needed */
+sort_context_t *SortContextCreate(void *arena, size_t arenaSize,
+    unsigned int flags);
+void SortContextFree(sort_context_t *ctx);
+sort_error_t SortContextReserve(sort_context_t *ctx, size_t bytes);
+
+/* start/stop the worker threads shared by the parallel sorts */
+int SortPoolStart(unsigned int numThreads, unsigned int flags);
+void SortPoolStop(void);
+
+/* threads used when none are specified, and calls of func on the pool */
+unsigned int SortDefaultThreads(void);
+void SortRunThreads(unsigned int numThreads,
+    void (*func)(void *arg, unsigned int thread), void *arg);
+
+/***************************************************************************
+* Each sort has a Ctx version that takes its scratch memory from a context
+* (NULL for the heap) and returns an error instead of asserting when there
+* isn't enough.  After an error the list holds the same items, but they
+* may not be sorted.
+*
+* The versions without Ctx take scratch memory from the heap.  If it isn't
+* available, the comparison sorts fall back to HeapSort, which sorts in
+* place and never fails.  The list is still sorted, but not stably, and
+* SortUnique and SortCountRuns may keep any one of each group of equal
+* items.  The radix and key sorts (RadixSort, RadixSortNumeric, SortByKey,
+* SortByKeyFunc and ApplyPermutation) have nothing to fall back to.  They
+* assert, and if NDEBUG is defined they leave the list unsorted, so use
+* their Ctx versions when memory may run out.
+***************************************************************************/
 /* order N^2 insertion sort */
 void InsertionSort(void *list, size_t numItems, size_t itemSize,
     int (*compareFunc) (const void *, const void *));
+sort_error_t InsertionSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+/* order N^2 insertion sort making order N * log(N) comparisons */
+void BinaryInsertionSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+sort_error_t BinaryInsertionSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
 
 /* order N^2 bubble sort */
 void BubbleSort(void *list, size_t numItems, size_t itemSize,
     int (*compareFunc) (const void *, const void *));
+sort_error_t BubbleSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
 
 /* order N^(3/2) Shell sort */
 void ShellSort(void *list, size_t numItems, size_t itemSize,
     int (*compareFunc) (const void *, const void *));
+sort_error_t ShellSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+/* Shell sort with a choice of gaps and threads, 0 threads for all */
+void ShellSortGaps(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), sort_gaps_t gapType,
+    const size_t *gaps, size_t numGaps, unsigned int numThreads);
+sort_error_t ShellSortGapsCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), sort_gaps_t gapType,
+    const size_t *gaps, size_t numGaps, unsigned int numThreads);
 
 /* order N * log(N) quick sort */
 void QuickSort(void *list, size_t numItems, size_t itemSize,
     int (*compareFunc) (const void *, const void *));
+sort_error_t QuickSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+/* order N * log(N) quick sort, order N * K for K distinct values */
+void QuickSort3Way(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+sort_error_t QuickSort3WayCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+/* order N * log(N) dual-pivot quick sort */
+void DualPivotQuickSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+sort_error_t DualPivotQuickSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+/* order N * log(N) / P in-place parallel samplesort, 0 threads for all */
+void ParallelSampleSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), unsigned int numThreads);
+sort_error_t ParallelSampleSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), unsigned int numThreads);
+
+/* sort each of many small segments of a list, 0 threads for all */
+void SortSegments(void *list, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), const size_t *offsets,
+    size_t numSegments, unsigned int numThreads);
+sort_error_t SortSegmentsCtx(sort_context_t *ctx, void *list,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    const size_t *offsets, size_t numSegments, unsigned int numThreads);
 
 /* order N * log(N) merge sort */
 void MergeSort(void *list, size_t numItems, size_t itemSize,
     int (*compareFunc) (const void *, const void *));
+sort_error_t MergeSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+/* order N * log(N) stable merge sort of cache sized tiles, then K-way merges */
+void BlockMergeSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+sort_error_t BlockMergeSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+/* stable sort making close to log2(N!) comparisons, for costly compares */
+void MinCompareSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+sort_error_t MinCompareSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+/* order N * log(K) stable merge of K sorted lists, NULL output allocates */
+void *MergeK(const void *const *lists, const size_t *numItems,
+    size_t numLists, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), void *output);
+
+/* sorted buffer, appends cost order B * log(B) + merge for B new items */
+sorted_buffer_t *SortedBufferCreate(size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t capacity);
+void SortedBufferFree(sorted_buffer_t *buffer);
+int SortedBufferAppend(sorted_buffer_t *buffer, const void *items,
+    size_t numItems);
+const void *SortedBufferItems(sorted_buffer_t *buffer);
+size_t SortedBufferCount(const sorted_buffer_t *buffer);
+
+/* streaming sort, chunks are sorted in the background while pushing */
+sort_stream_t *SortStreamCreate(size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t chunkItems,
+    unsigned int numThreads);
+void SortStreamFree(sort_stream_t *stream);
+int SortStreamPush(sort_stream_t *stream, const void *items,
+    size_t numItems);
+sort_error_t SortStreamFinish(sort_stream_t *stream);
+size_t SortStreamPull(sort_stream_t *stream, void *output, size_t maxItems);
+
+/* resumable sort, each SortStep places about budget items */
+sort_job_t *SortJobCreate(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+void SortJobFree(sort_job_t *job);
+int SortStep(sort_job_t *job, size_t budget);
+void SortJobProgress(const sort_job_t *job, size_t *done, size_t *total);
 
 /* order N * log(N) heap sort */
 void HeapSort(void *list, size_t numItems, size_t itemSize,
     int (*compareFunc) (const void *, const void *));
+sort_error_t HeapSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+/* order N to N * log(N) natural (run adaptive) merge sort */
+void NaturalMergeSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+sort_error_t NaturalMergeSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
 
 /* order N * k radix sort */
 void RadixSort(void *list, size_t numItems, size_t itemSize,
     unsigned int numKeys, unsigned int (*keyFunc) (const void *));
+sort_error_t RadixSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    unsigned int numKeys, unsigned int (*keyFunc) (const void *));
+
+/* order N * k radix sort of items with a native numeric key */
+void RadixSortNumeric(void *list, size_t numItems, size_t itemSize,
+    size_t keyOffset, sort_key_t keyType);
+sort_error_t RadixSortNumericCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    size_t keyOffset, sort_key_t keyType);
+
+/* sort and remove duplicates, returns the number of distinct items */
+size_t SortUnique(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+sort_error_t SortUniqueCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t *numUnique);
+
+/* sort, remove duplicates, and count the items equal to each one kept */
+size_t SortCountRuns(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t *counts);
+sort_error_t SortCountRunsCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t *counts,
+    size_t *numUnique);
+
+/* sort a column of keys and move payload columns with it, order optional */
+void SortByKey(void *keys, size_t numItems, size_t keySize,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType,
+    void *const *payloads, const size_t *payloadSizes, size_t numPayloads,
+    size_t *order);
+sort_error_t SortByKeyCtx(sort_context_t *ctx, void *keys,
+    size_t numItems, size_t keySize,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType,
+    void *const *payloads, const size_t *payloadSizes, size_t numPayloads,
+    size_t *order);
+
+/* sort items by a key that keyFunc computes once per item, order optional */
+void SortByKeyFunc(void *list, size_t numItems, size_t itemSize,
+    void (*keyFunc) (const void *item, void *key), size_t keySize,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType,
+    size_t *order);
+sort_error_t SortByKeyFuncCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    void (*keyFunc) (const void *item, void *key), size_t keySize,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType,
+    size_t *order);
+
+/* move item order[i] of each column to position i */
+void ApplyPermutation(void *const *columns, const size_t *itemSizes,
+    size_t numColumns, size_t numItems, const size_t *order);
+sort_error_t ApplyPermutationCtx(sort_context_t *ctx,
+    void *const *columns, const size_t *itemSizes, size_t numColumns,
+    size_t numItems, const size_t *order);
+
+/* sort with the algorithm best suited to a sample of the list */
+sort_algorithm_t SortAuto(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType);
+sort_error_t SortAutoCtx(sort_context_t *ctx, void *list, size_t numItems,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    sort_key_t keyType, sort_algorithm_t *algorithm);
 
 /* tests sorts results */
 int VerifySort(void *list, size_t numItems, size_t itemSize,
     int (*compareFunc) (const void *, const void *));
 
+/* index of the first item out of order, numItems if the list is sorted */
+size_t SortFindUnsorted(const void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType,
+    unsigned int numThreads);
+
+/* quick check that a list is sorted, used by sorts to skip sorted lists */
+int SortIsSorted(const void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+/* order independent hash, equal before and after sorting */
+unsigned long SortMultisetHash(const void *list, size_t numItems,
+    size_t itemSize, unsigned int numThreads);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* _SORT_H_ */
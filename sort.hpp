@@ -0,0 +1,1161 @@
+/***************************************************************************
+*                  C++ Interface to the Sort Library Algorithms
+*
+*   File    : sort.hpp
+*   Purpose : This is a header only C++ (C++17 or later) version of the
+*             library's quick, merge, heap, and insertion sorts.  They
+*             work on random access iterators or ranges, move items with
+*             std::move instead of copying their bytes, so types like
+*             std::string and std::vector may be sorted directly, and
+*             compare projections of the items like the std::ranges
+*             algorithms.  sort and stable_sort take an optional execution
+*             policy (sortlib::execution or std::execution); the parallel
+*             policies sort pieces of the list on the library's thread pool
+*             and merge them.  Lists of native numbers sorted by std::less
+*             are handed to the C library's radix sort.  The names and
+*             parameters follow the standard library's rather than the C
+*             library's, so that these sorts are drop in replacements for
+*             std::sort and std::stable_sort.  sort_job wraps the
+*             library's resumable sort, with adapters that run its steps
+*             from an event loop and complete a std::future or resume a
+*             C++20 coroutine.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+#ifndef _SORT_HPP_
+#define _SORT_HPP_
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+
+#ifdef __cpp_lib_execution
+#include <execution>
+#endif
+
+#ifdef __cpp_lib_coroutine
+#include <coroutine>
+#endif
+
+#include "sort.h"
+
+namespace sortlib
+{
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* projection returning the item itself (std::identity before C++20) */
+struct identity
+{
+    using is_transparent = void;
+
+    template <class T>
+    constexpr T &&operator()(T &&item) const noexcept
+    {
+        return std::forward<T>(item);
+    }
+};
+
+namespace execution
+{
+    /* sort on the calling thread */
+    struct sequenced_policy
+    {
+    };
+
+    /* sort on the library's thread pool, 0 threads for the default */
+    struct parallel_policy
+    {
+        unsigned int threads = 0;
+    };
+
+    inline constexpr sequenced_policy seq{};
+    inline constexpr parallel_policy par{};
+
+    template <class T>
+    struct is_execution_policy : std::false_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<sequenced_policy> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<parallel_policy> : std::true_type
+    {
+    };
+
+#ifdef __cpp_lib_execution
+    template <>
+    struct is_execution_policy<std::execution::sequenced_policy> :
+        std::true_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<std::execution::parallel_policy> :
+        std::true_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<std::execution::parallel_unsequenced_policy> :
+        std::true_type
+    {
+    };
+#endif
+
+    template <class T>
+    inline constexpr bool is_execution_policy_v =
+        is_execution_policy<std::remove_cv_t<std::remove_reference_t<T>>>::
+        value;
+}
+
+namespace detail
+{
+
+/***************************************************************************
+*                                 HELPERS
+***************************************************************************/
+template <class It>
+using random_access_t = std::enable_if_t<std::is_base_of_v<
+    std::random_access_iterator_tag,
+    typename std::iterator_traits<It>::iterator_category>>;
+
+template <class Range>
+using range_iterator_t = decltype(std::begin(std::declval<Range &>()));
+
+template <class P>
+using policy_t = std::enable_if_t<execution::is_execution_policy_v<P>>;
+
+/* comparison of the projections of two items */
+template <class Comp, class Proj>
+struct projected_less
+{
+    Comp &comp;
+    Proj &proj;
+
+    template <class A, class B>
+    bool operator()(A &&a, B &&b) const
+    {
+        return std::invoke(comp, std::invoke(proj, std::forward<A>(a)),
+            std::invoke(proj, std::forward<B>(b)));
+    }
+};
+
+/* convert either kind of policy to a thread count, 1 for sequential */
+inline unsigned int policy_threads(execution::sequenced_policy)
+{
+    return 1;
+}
+
+inline unsigned int policy_threads(execution::parallel_policy policy)
+{
+    return (0 == policy.threads) ? SortDefaultThreads() : policy.threads;
+}
+
+#ifdef __cpp_lib_execution
+inline unsigned int policy_threads(std::execution::sequenced_policy)
+{
+    return 1;
+}
+
+inline unsigned int policy_threads(std::execution::parallel_policy)
+{
+    return SortDefaultThreads();
+}
+
+inline unsigned int policy_threads(
+    std::execution::parallel_unsequenced_policy)
+{
+    return SortDefaultThreads();
+}
+#endif
+
+inline std::size_t insertion_cutoff()
+{
+    sort_tuning_t tuning;
+
+    SortGetTuning(&tuning);
+    return (tuning.insertionCutoff < 1) ? 1 : tuning.insertionCutoff;
+}
+
+/***************************************************************************
+* Work run on the pool by SortRunThreads.  The first exception thrown by
+* any of the calls is rethrown on the calling thread once they've all
+* returned.
+***************************************************************************/
+struct pool_task
+{
+    std::exception_ptr error;
+    std::mutex errorLock;
+
+    virtual void run(unsigned int thread) = 0;
+
+    void call(unsigned int thread) noexcept
+    {
+        try
+        {
+            run(thread);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> guard(errorLock);
+
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+        }
+    }
+
+protected:
+    ~pool_task() = default;
+};
+
+extern "C" inline void SortCppPoolCall(void *arg, unsigned int thread)
+{
+    static_cast<pool_task *>(arg)->call(thread);
+}
+
+template <class Func>
+struct pool_call : pool_task
+{
+    Func &func;
+
+    explicit pool_call(Func &f) : func(f)
+    {
+    }
+
+    void run(unsigned int thread) override
+    {
+        func(thread);
+    }
+};
+
+/* call func(i) for i from 0 to count - 1 on the library's thread pool */
+template <class Func>
+void run_on_pool(unsigned int count, Func &&func)
+{
+    pool_call<std::remove_reference_t<Func>> task(func);
+
+    if (count <= 1)
+    {
+        if (1 == count)
+        {
+            func(0u);
+        }
+
+        return;
+    }
+
+    SortRunThreads(count, SortCppPoolCall, &task);
+
+    if (task.error)
+    {
+        std::rethrow_exception(task.error);
+    }
+}
+
+/***************************************************************************
+*                               ALGORITHMS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : insertion_sort
+*   Description: This function sorts a list by moving each item back past
+*                the sorted items that belong after it.  Items smaller than
+*                the first item are moved to the front at once, so the
+*                inner loop doesn't need to test for the start of the list.
+*   Parameters : first, last - the list
+*                less - ordering of the items
+*   Effects    : The list is sorted (stable)
+*   Returned   : NONE
+***************************************************************************/
+template <class It, class Less>
+void insertion_sort(It first, It last, Less &less)
+{
+    using value_type = typename std::iterator_traits<It>::value_type;
+
+    if (first == last)
+    {
+        return;
+    }
+
+    for (It i = first + 1; i < last; ++i)
+    {
+        if (less(*i, *first))
+        {
+            value_type item = std::move(*i);
+
+            std::move_backward(first, i, i + 1);
+            *first = std::move(item);
+        }
+        else if (less(*i, *(i - 1)))
+        {
+            value_type item = std::move(*i);
+            It hole = i;
+
+            do
+            {
+                *hole = std::move(*(hole - 1));
+                --hole;
+            } while (less(item, *(hole - 1)));
+
+            *hole = std::move(item);
+        }
+    }
+}
+
+/***************************************************************************
+*   Function   : heap_sort
+*   Description: This function builds a max heap of the list and then
+*                repeatedly moves the largest item to the end of the list,
+*                sifting the item it displaced down through a hole instead
+*                of swapping at every level.
+*   Parameters : first, last - the list
+*                less - ordering of the items
+*   Effects    : The list is sorted
+*   Returned   : NONE
+***************************************************************************/
+template <class It, class Less>
+void sift_down(It first, std::ptrdiff_t hole, std::ptrdiff_t count,
+    typename std::iterator_traits<It>::value_type &&item, Less &less)
+{
+    std::ptrdiff_t child;
+
+    while ((child = (2 * hole) + 1) < count)
+    {
+        if ((child + 1 < count) && less(first[child], first[child + 1]))
+        {
+            child++;
+        }
+
+        if (!less(item, first[child]))
+        {
+            break;
+        }
+
+        first[hole] = std::move(first[child]);
+        hole = child;
+    }
+
+    first[hole] = std::move(item);
+}
+
+template <class It, class Less>
+void heap_sort(It first, It last, Less &less)
+{
+    using value_type = typename std::iterator_traits<It>::value_type;
+    std::ptrdiff_t count = last - first;
+
+    for (std::ptrdiff_t i = (count / 2) - 1; i >= 0; i--)
+    {
+        detail::sift_down(first, i, count, value_type(std::move(first[i])),
+            less);
+    }
+
+    for (std::ptrdiff_t end = count - 1; end > 0; end--)
+    {
+        value_type item = std::move(first[end]);
+
+        first[end] = std::move(first[0]);
+        detail::sift_down(first, 0, end, std::move(item), less);
+    }
+}
+
+/***************************************************************************
+*   Function   : quick_sort
+*   Description: This function partitions the list around the median of
+*                its first, middle, and last items, recursing on the
+*                smaller part and looping on the larger.  Parts of
+*                sortTuning.insertionCutoff items or fewer are finished
+*                with insertion sort.  If the partitions are badly
+*                unbalanced 2 * log2(N) levels deep, the part is heap
+*                sorted instead.
+*   Parameters : first, last - the list
+*                less - ordering of the items
+*                cutoff - largest part that is insertion sorted
+*                depth - partitions left before switching to heap sort
+*   Effects    : The list is sorted
+*   Returned   : NONE
+***************************************************************************/
+template <class It, class Less>
+void quick_sort(It first, It last, Less &less, std::size_t cutoff,
+    int depth)
+{
+    while (static_cast<std::size_t>(last - first) > cutoff)
+    {
+        if (0 == depth)
+        {
+            detail::heap_sort(first, last, less);
+            return;
+        }
+
+        depth--;
+
+        /* put the median of three at first, where it's the pivot */
+        It middle = first + ((last - first) / 2);
+        It back = last - 1;
+
+        if (less(*middle, *first))
+        {
+            std::iter_swap(middle, first);
+        }
+
+        if (less(*back, *middle))
+        {
+            std::iter_swap(back, middle);
+
+            if (less(*middle, *first))
+            {
+                std::iter_swap(middle, first);
+            }
+        }
+
+        std::iter_swap(first, middle);
+
+        /* Hoare partition, stopping on items equal to the pivot */
+        It low = first;
+        It high = last;
+
+        for (;;)
+        {
+            do
+            {
+                ++low;
+            } while ((low < last) && less(*low, *first));
+
+            do
+            {
+                --high;
+            } while (less(*first, *high));
+
+            if (low >= high)
+            {
+                break;
+            }
+
+            std::iter_swap(low, high);
+        }
+
+        std::iter_swap(first, high);
+
+        if ((high - first) < (last - (high + 1)))
+        {
+            detail::quick_sort(first, high, less, cutoff, depth);
+            first = high + 1;
+        }
+        else
+        {
+            detail::quick_sort(high + 1, last, less, cutoff, depth);
+            last = high;
+        }
+    }
+
+    detail::insertion_sort(first, last, less);
+}
+
+/***************************************************************************
+*   Function   : merge
+*   Description: This function merges two adjacent sorted lists.  The
+*                first list is moved to a buffer and merged with the
+*                second back into the space they occupied.  Nothing is
+*                moved if the lists are already in order.
+*   Parameters : first, middle, last - the lists [first, middle) and
+*                                      [middle, last)
+*                less - ordering of the items
+*                buffer - scratch for the first list
+*   Effects    : [first, last) is sorted (stable)
+*   Returned   : NONE
+***************************************************************************/
+template <class It, class Less>
+void merge(It first, It middle, It last, Less &less,
+    std::vector<typename std::iterator_traits<It>::value_type> &buffer)
+{
+    if ((first == middle) || (middle == last) ||
+        !less(*middle, *(middle - 1)))
+    {
+        return;
+    }
+
+    buffer.clear();
+    buffer.insert(buffer.end(), std::make_move_iterator(first),
+        std::make_move_iterator(middle));
+
+    auto low = buffer.begin();
+    It high = middle;
+    It out = first;
+
+    while ((low != buffer.end()) && (high != last))
+    {
+        if (less(*high, *low))
+        {
+            *out = std::move(*high);
+            ++high;
+        }
+        else
+        {
+            *out = std::move(*low);
+            ++low;
+        }
+
+        ++out;
+    }
+
+    std::move(low, buffer.end(), out);
+    buffer.clear();
+}
+
+/***************************************************************************
+*   Function   : merge_sort
+*   Description: This function sorts each half of the list and merges
+*                them.  Lists of sortTuning.insertionCutoff items or fewer
+*                are insertion sorted.
+*   Parameters : first, last - the list
+*                less - ordering of the items
+*                cutoff - largest list that is insertion sorted
+*                buffer - scratch for half of the list
+*   Effects    : The list is sorted (stable)
+*   Returned   : NONE
+***************************************************************************/
+template <class It, class Less>
+void merge_sort(It first, It last, Less &less, std::size_t cutoff,
+    std::vector<typename std::iterator_traits<It>::value_type> &buffer)
+{
+    if (static_cast<std::size_t>(last - first) <= cutoff)
+    {
+        detail::insertion_sort(first, last, less);
+        return;
+    }
+
+    It middle = first + ((last - first) / 2);
+
+    detail::merge_sort(first, middle, less, cutoff, buffer);
+    detail::merge_sort(middle, last, less, cutoff, buffer);
+    detail::merge(first, middle, last, less, buffer);
+}
+
+/***************************************************************************
+*   Function   : parallel_sort
+*   Description: This function divides the list into one piece per thread
+*                (no piece smaller than sortTuning.parallelGrain), sorts
+*                the pieces on the library's thread pool, and then merges
+*                neighboring pieces in rounds, each round's merges running
+*                on the pool.
+*   Parameters : first, last - the list
+*                less - ordering of the items, called from several threads
+*                threads - most threads to use
+*                sortPiece - function sorting a piece of the list
+*   Effects    : The list is sorted (stable if sortPiece is)
+*   Returned   : NONE
+***************************************************************************/
+template <class It, class Less, class SortPiece>
+void parallel_sort(It first, It last, Less &less, unsigned int threads,
+    SortPiece sortPiece)
+{
+    using value_type = typename std::iterator_traits<It>::value_type;
+    sort_tuning_t tuning;
+    std::size_t count = static_cast<std::size_t>(last - first);
+
+    SortGetTuning(&tuning);
+
+    if ((tuning.parallelGrain > 0) &&
+        (threads > count / tuning.parallelGrain))
+    {
+        threads = static_cast<unsigned int>(count / tuning.parallelGrain);
+    }
+
+    if (threads <= 1)
+    {
+        sortPiece(first, last);
+        return;
+    }
+
+    /* piece i is [first + bounds[i], first + bounds[i + 1]) */
+    std::vector<std::size_t> bounds(threads + 1);
+
+    for (unsigned int i = 0; i <= threads; i++)
+    {
+        bounds[i] = ((count / threads) * i) +
+            std::min<std::size_t>(i, count % threads);
+    }
+
+    run_on_pool(threads, [&](unsigned int i)
+    {
+        sortPiece(first + bounds[i], first + bounds[i + 1]);
+    });
+
+    for (unsigned int width = 1; width < threads; width *= 2)
+    {
+        unsigned int merges = (threads - width + (2 * width) - 1) /
+            (2 * width);
+
+        run_on_pool(merges, [&](unsigned int i)
+        {
+            std::vector<value_type> buffer;
+            unsigned int low = 2 * width * i;
+            unsigned int high = std::min(low + (2 * width), threads);
+
+            detail::merge(first + bounds[low], first + bounds[low + width],
+                first + bounds[high], less, buffer);
+        });
+    }
+}
+
+/***************************************************************************
+* Lists of the native numeric types sorted by std::less with no projection
+* are radix sorted by the C library.  radix_key is the library's key type,
+* or SORT_KEY_NONE for any other list.
+***************************************************************************/
+template <class T>
+constexpr sort_key_t numeric_key()
+{
+    return std::is_same_v<T, int> ? SORT_KEY_INT :
+        std::is_same_v<T, unsigned int> ? SORT_KEY_UINT :
+        std::is_same_v<T, long> ? SORT_KEY_LONG :
+        std::is_same_v<T, unsigned long> ? SORT_KEY_ULONG :
+        std::is_same_v<T, float> ? SORT_KEY_FLOAT :
+        std::is_same_v<T, double> ? SORT_KEY_DOUBLE : SORT_KEY_NONE;
+}
+
+template <class T, class Comp>
+constexpr bool is_plain_less_v = std::is_same_v<Comp, std::less<>> ||
+    std::is_same_v<Comp, std::less<T>>
+#ifdef __cpp_lib_ranges
+    || std::is_same_v<Comp, std::ranges::less>
+#endif
+    ;
+
+template <class Proj>
+constexpr bool is_identity_v = std::is_same_v<Proj, identity>
+#ifdef __cpp_lib_ranges
+    || std::is_same_v<Proj, std::identity>
+#endif
+    ;
+
+template <class It>
+constexpr bool is_contiguous_v = std::is_pointer_v<It>
+#ifdef __cpp_lib_ranges
+    || std::contiguous_iterator<It>
+#endif
+    ;
+
+template <class It, class Comp, class Proj>
+constexpr sort_key_t radix_key()
+{
+    using value_type = typename std::iterator_traits<It>::value_type;
+
+    if constexpr (is_contiguous_v<It> && is_identity_v<Proj> &&
+        is_plain_less_v<value_type, Comp>)
+    {
+        return numeric_key<value_type>();
+    }
+    else
+    {
+        return SORT_KEY_NONE;
+    }
+}
+
+/* radix sort a numeric list, returns false if it isn't sorted */
+template <class It>
+bool radix_sort(It first, It last, sort_key_t key)
+{
+    using value_type = typename std::iterator_traits<It>::value_type;
+
+    return (SORT_OK == RadixSortNumericCtx(nullptr, std::addressof(*first),
+        static_cast<std::size_t>(last - first), sizeof(value_type), 0, key));
+}
+
+/* sort a list, stable or not, with threads threads */
+template <bool stable, class It, class Comp, class Proj>
+void sort_list(It first, It last, Comp &comp, Proj &proj,
+    unsigned int threads)
+{
+    using value_type = typename std::iterator_traits<It>::value_type;
+    constexpr sort_key_t key = radix_key<It, Comp, Proj>();
+    projected_less<Comp, Proj> less{comp, proj};
+    std::size_t cutoff = insertion_cutoff();
+
+    if (last - first < 2)
+    {
+        return;
+    }
+
+    if constexpr (SORT_KEY_NONE != key)
+    {
+        /* the radix sort makes one pass per digit; it's only threaded
+         * when it's one piece of a parallel sort */
+        if ((threads <= 1) && detail::radix_sort(first, last, key))
+        {
+            return;
+        }
+    }
+
+    auto sortPiece = [&](It low, It high)
+    {
+        if constexpr (SORT_KEY_NONE != key)
+        {
+            if (radix_sort(low, high, key))
+            {
+                return;
+            }
+        }
+
+        if constexpr (stable)
+        {
+            std::vector<value_type> buffer;
+
+            buffer.reserve(static_cast<std::size_t>(high - low) / 2);
+            detail::merge_sort(low, high, less, cutoff, buffer);
+        }
+        else
+        {
+            int depth = 0;
+
+            for (auto n = high - low; n > 1; n /= 2)
+            {
+                depth += 2;
+            }
+
+            detail::quick_sort(low, high, less, cutoff, depth);
+        }
+    };
+
+    detail::parallel_sort(first, last, less, threads, sortPiece);
+}
+
+}   /* namespace detail */
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : sort
+*   Description: These functions sort a list with an introspective quick
+*                sort, or with several threads when they're given a
+*                parallel policy.  The order of equal items isn't kept.
+*   Parameters : policy - optional sequential or parallel execution policy
+*                first, last - iterators to the list (or range - the list)
+*                comp - ordering of the projected items (default std::less)
+*                proj - projection of the items compared (default the items)
+*   Effects    : The list is sorted
+*   Returned   : NONE
+***************************************************************************/
+template <class It, class Comp = std::less<>, class Proj = identity,
+    class = detail::random_access_t<It>>
+void sort(It first, It last, Comp comp = {}, Proj proj = {})
+{
+    detail::sort_list<false>(first, last, comp, proj, 1);
+}
+
+template <class Policy, class It, class Comp = std::less<>,
+    class Proj = identity, class = detail::policy_t<Policy>,
+    class = detail::random_access_t<It>>
+void sort(Policy &&policy, It first, It last, Comp comp = {},
+    Proj proj = {})
+{
+    detail::sort_list<false>(first, last, comp, proj,
+        detail::policy_threads(policy));
+}
+
+template <class Range, class Comp = std::less<>, class Proj = identity,
+    class = detail::random_access_t<detail::range_iterator_t<Range>>>
+void sort(Range &&range, Comp comp = {}, Proj proj = {})
+{
+    detail::sort_list<false>(std::begin(range), std::end(range), comp,
+        proj, 1);
+}
+
+template <class Policy, class Range, class Comp = std::less<>,
+    class Proj = identity, class = detail::policy_t<Policy>,
+    class = detail::random_access_t<detail::range_iterator_t<Range>>>
+void sort(Policy &&policy, Range &&range, Comp comp = {}, Proj proj = {})
+{
+    detail::sort_list<false>(std::begin(range), std::end(range), comp,
+        proj, detail::policy_threads(policy));
+}
+
+/***************************************************************************
+*   Function   : stable_sort
+*   Description: These functions sort a list with a merge sort, or with
+*                several threads when they're given a parallel policy.
+*                Equal items stay in their original order.
+*   Parameters : policy - optional sequential or parallel execution policy
+*                first, last - iterators to the list (or range - the list)
+*                comp - ordering of the projected items (default std::less)
+*                proj - projection of the items compared (default the items)
+*   Effects    : The list is sorted
+*   Returned   : NONE
+***************************************************************************/
+template <class It, class Comp = std::less<>, class Proj = identity,
+    class = detail::random_access_t<It>>
+void stable_sort(It first, It last, Comp comp = {}, Proj proj = {})
+{
+    detail::sort_list<true>(first, last, comp, proj, 1);
+}
+
+template <class Policy, class It, class Comp = std::less<>,
+    class Proj = identity, class = detail::policy_t<Policy>,
+    class = detail::random_access_t<It>>
+void stable_sort(Policy &&policy, It first, It last, Comp comp = {},
+    Proj proj = {})
+{
+    detail::sort_list<true>(first, last, comp, proj,
+        detail::policy_threads(policy));
+}
+
+template <class Range, class Comp = std::less<>, class Proj = identity,
+    class = detail::random_access_t<detail::range_iterator_t<Range>>>
+void stable_sort(Range &&range, Comp comp = {}, Proj proj = {})
+{
+    detail::sort_list<true>(std::begin(range), std::end(range), comp,
+        proj, 1);
+}
+
+template <class Policy, class Range, class Comp = std::less<>,
+    class Proj = identity, class = detail::policy_t<Policy>,
+    class = detail::random_access_t<detail::range_iterator_t<Range>>>
+void stable_sort(Policy &&policy, Range &&range, Comp comp = {},
+    Proj proj = {})
+{
+    detail::sort_list<true>(std::begin(range), std::end(range), comp,
+        proj, detail::policy_threads(policy));
+}
+
+/***************************************************************************
+*   Function   : heap_sort
+*   Description: These functions heap sort a list in place, without any
+*                scratch memory.
+*   Parameters : first, last - iterators to the list (or range - the list)
+*                comp - ordering of the projected items (default std::less)
+*                proj - projection of the items compared (default the items)
+*   Effects    : The list is sorted
+*   Returned   : NONE
+***************************************************************************/
+template <class It, class Comp = std::less<>, class Proj = identity,
+    class = detail::random_access_t<It>>
+void heap_sort(It first, It last, Comp comp = {}, Proj proj = {})
+{
+    detail::projected_less<Comp, Proj> less{comp, proj};
+
+    detail::heap_sort(first, last, less);
+}
+
+template <class Range, class Comp = std::less<>, class Proj = identity,
+    class = detail::random_access_t<detail::range_iterator_t<Range>>>
+void heap_sort(Range &&range, Comp comp = {}, Proj proj = {})
+{
+    sortlib::heap_sort(std::begin(range), std::end(range), comp, proj);
+}
+
+/***************************************************************************
+*   Function   : insertion_sort
+*   Description: These functions insertion sort a list, which is the
+*                fastest way to sort very short or nearly sorted lists.
+*   Parameters : first, last - iterators to the list (or range - the list)
+*                comp - ordering of the projected items (default std::less)
+*                proj - projection of the items compared (default the items)
+*   Effects    : The list is sorted (stable)
+*   Returned   : NONE
+***************************************************************************/
+template <class It, class Comp = std::less<>, class Proj = identity,
+    class = detail::random_access_t<It>>
+void insertion_sort(It first, It last, Comp comp = {}, Proj proj = {})
+{
+    detail::projected_less<Comp, Proj> less{comp, proj};
+
+    detail::insertion_sort(first, last, less);
+}
+
+template <class Range, class Comp = std::less<>, class Proj = identity,
+    class = detail::random_access_t<detail::range_iterator_t<Range>>>
+void insertion_sort(Range &&range, Comp comp = {}, Proj proj = {})
+{
+    sortlib::insertion_sort(std::begin(range), std::end(range), comp, proj);
+}
+
+/***************************************************************************
+*                             RESUMABLE SORTS
+***************************************************************************/
+/* reported to the waiter of a sort_job that was cancelled */
+class sort_cancelled : public std::exception
+{
+public:
+    const char *what() const noexcept override
+    {
+        return "sort cancelled";
+    }
+};
+
+/***************************************************************************
+* sort_job owns a SortJobCreate job sorting a list of trivially copyable
+* items (the C library copies them with memcpy).  step does a slice of the
+* sort; progress returns the fraction that's done.  cancel stops the
+* adapters below at their next slice, and the list is left holding the
+* same items when the sort_job is destroyed.
+***************************************************************************/
+class sort_job
+{
+public:
+    template <class T>
+    sort_job(T *list, std::size_t numItems,
+        int (*compareFunc)(const void *, const void *)) :
+        job(SortJobCreate(list, numItems, sizeof(T), compareFunc)),
+        finished(false),
+        cancelRequested(false)
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+            "the resumable sort copies items with memcpy");
+
+        if (nullptr == job)
+        {
+            throw std::bad_alloc();
+        }
+    }
+
+    sort_job(const sort_job &) = delete;
+    sort_job &operator=(const sort_job &) = delete;
+
+    ~sort_job()
+    {
+        SortJobFree(job);
+    }
+
+    /* place about budget items, returns true once the list is sorted */
+    bool step(std::size_t budget)
+    {
+        if (!finished)
+        {
+            finished = (0 != SortStep(job, budget));
+        }
+
+        return finished;
+    }
+
+    bool done() const
+    {
+        return finished;
+    }
+
+    double progress() const
+    {
+        std::size_t placed, total;
+
+        SortJobProgress(job, &placed, &total);
+        return (0 == total) ? 1.0 : (static_cast<double>(placed) / total);
+    }
+
+    void cancel()
+    {
+        cancelRequested = true;
+    }
+
+    bool cancelled() const
+    {
+        return cancelRequested;
+    }
+
+private:
+    sort_job_t *job;
+    bool finished;
+    bool cancelRequested;
+};
+
+namespace detail
+{
+
+/* steps of a sort_async, each posted to the caller's event loop */
+template <class Post>
+struct sort_slices
+{
+    sort_job &job;
+    std::size_t budget;
+    Post post;
+    std::promise<void> promise;
+
+    static void run(std::shared_ptr<sort_slices> self)
+    {
+        try
+        {
+            if (self->job.cancelled())
+            {
+                throw sort_cancelled();
+            }
+
+            if (self->job.step(self->budget))
+            {
+                self->promise.set_value();
+                return;
+            }
+
+            self->post([self]()
+            {
+                run(self);
+            });
+        }
+        catch (...)
+        {
+            self->promise.set_exception(std::current_exception());
+        }
+    }
+};
+
+}   /* namespace detail */
+
+/***************************************************************************
+*   Function   : sort_async
+*   Description: This function sorts a job one slice at a time on an event
+*                loop.  post is called with a function that does the next
+*                slice; the loop calls it after its other work, and it
+*                posts the slice after it until the sort is done.
+*   Parameters : job - the sort, which must outlive the returned future
+*                budget - items placed by each slice
+*                post - callable taking a void() function for the loop to
+*                       call later
+*   Effects    : The first slice is posted
+*   Returned   : A future that is ready when the list is sorted, or that
+*                holds sort_cancelled if the job is cancelled first.
+***************************************************************************/
+template <class Post>
+std::future<void> sort_async(sort_job &job, std::size_t budget, Post post)
+{
+    auto state = std::make_shared<detail::sort_slices<Post>>(
+        detail::sort_slices<Post>{job, budget, std::move(post), {}});
+    std::future<void> result = state->promise.get_future();
+
+    state->post([state]()
+    {
+        detail::sort_slices<Post>::run(state);
+    });
+
+    return result;
+}
+
+#ifdef __cpp_lib_coroutine
+/***************************************************************************
+* "co_await sort_steps(job, budget, post)" suspends a coroutine while its
+* sort runs a slice at a time on an event loop, like sort_async, and
+* resumes it from the loop when the list is sorted.  The co_await throws
+* sort_cancelled if the job is cancelled first.
+***************************************************************************/
+template <class Post>
+class sort_awaiter
+{
+public:
+    sort_awaiter(sort_job &j, std::size_t b, Post p) :
+        job(j),
+        budget(b),
+        post(std::move(p))
+    {
+    }
+
+    bool await_ready() const
+    {
+        return job.done();
+    }
+
+    void await_suspend(std::coroutine_handle<> waiting)
+    {
+        handle = waiting;
+        post([this]()
+        {
+            slice();
+        });
+    }
+
+    void await_resume()
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    void slice()
+    {
+        try
+        {
+            if (job.cancelled())
+            {
+                throw sort_cancelled();
+            }
+
+            if (!job.step(budget))
+            {
+                post([this]()
+                {
+                    slice();
+                });
+
+                return;
+            }
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        handle.resume();
+    }
+
+    sort_job &job;
+    std::size_t budget;
+    Post post;
+    std::coroutine_handle<> handle;
+    std::exception_ptr error;
+};
+
+template <class Post>
+sort_awaiter<Post> sort_steps(sort_job &job, std::size_t budget, Post post)
+{
+    return sort_awaiter<Post>(job, budget, std::move(post));
+}
+#endif
+
+}   /* namespace sortlib */
+
+#endif /* _SORT_HPP_ */
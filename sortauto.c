@@ -0,0 +1,339 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortauto.c
+*   Purpose : This module implements SortAuto, which takes a small sample
+*             of a list to estimate how sorted it already is and how many
+*             duplicate items it contains, then sorts the list with the
+*             algorithm that is best suited to it.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <string.h>
+#include <assert.h>
+#include "sort.h"
+#include "sortint.h"
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+typedef struct
+{
+    size_t pairs;           /* adjacent pairs compared */
+    size_t descents;        /* adjacent pairs that are out of order */
+    size_t samples;         /* items sampled for duplicates */
+    size_t duplicates;      /* sampled items equal to their predecessor */
+} list_profile_t;
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* order is estimated from SAMPLE_WINDOWS runs of SAMPLE_WINDOW items */
+#define SAMPLE_WINDOWS      16
+#define SAMPLE_WINDOW       8
+
+/* duplicates are estimated from DUPLICATE_SAMPLES evenly spaced items */
+#define DUPLICATE_SAMPLES   64
+
+/* radix sort's passes over the list don't pay off for fewer items */
+#define RADIX_MIN_ITEMS     512
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static void ProfileList(sort_context_t *ctx, void *list, size_t numItems,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    list_profile_t *profile);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : SortAuto
+*   Description: This function samples a list and sorts it with the
+*                algorithm that is best suited to the sample using scratch
+*                memory from the heap.  See SortAutoCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                keyType - the type of the numeric key at the start of each
+*                          item that compareFunc orders items by, or
+*                          SORT_KEY_NONE if there isn't one.
+*   Effects    : The contents of list are sorted in ascending order.  The
+*                algorithm used is recorded in the statistics.
+*   Returned   : The algorithm used to sort the list.
+***************************************************************************/
+sort_algorithm_t SortAuto(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType)
+{
+    sort_algorithm_t algorithm;
+    sort_error_t result;
+
+    result = SortAutoCtx(NULL, list, numItems, itemSize, compareFunc,
+        keyType, &algorithm);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+        algorithm = SORT_ALG_HEAP;
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+
+    return algorithm;
+}
+
+/***************************************************************************
+*   Function   : SortAutoCtx
+*   Description: This function samples a list and sorts it with the
+*                algorithm that is best suited to the sample:
+*                - insertion sort for lists with no more than the insertion
+*                  sort cutoff items
+*                - natural merge sort for lists that appear to be sorted
+*                  (ascending or descending)
+*                - radix sort for lists with a native numeric key
+*                - three-way quick sort for lists with many duplicate items
+*                - dual-pivot quick sort for lists that appear to be random.
+*                  Lists that only look random to the sample (like sorted
+*                  lists with adjacent pairs swapped) would make the first
+*                  item pivots of QuickSort quadratic and overflow the
+*                  stack, so QuickSort is never chosen.
+*                - natural merge sort for everything else, since it takes
+*                  advantage of whatever runs exist
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                keyType - the type of the numeric key at the start of each
+*                          item that compareFunc orders items by, or
+*                          SORT_KEY_NONE if there isn't one.
+*                algorithm - receives the algorithm used to sort the list
+*                            (may be NULL)
+*   Effects    : The contents of list are sorted in ascending order.  The
+*                algorithm used is recorded in the statistics.
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t SortAutoCtx(sort_context_t *ctx, void *list, size_t numItems,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    sort_key_t keyType, sort_algorithm_t *algorithm)
+{
+    list_profile_t profile;
+    sort_algorithm_t chosen;
+    sort_error_t result;
+
+    if (numItems <= sortTuning.insertionCutoff)
+    {
+        chosen = SORT_ALG_INSERTION;
+    }
+    else
+    {
+        ProfileList(ctx, list, numItems, itemSize, compareFunc, &profile);
+
+        if ((0 == profile.descents) || (profile.pairs == profile.descents))
+        {
+            /* looks sorted or reversed, there should be long runs */
+            chosen = SORT_ALG_NATURAL_MERGE;
+        }
+        else if ((SORT_KEY_NONE != keyType) &&
+            (0 != RadixKeySize(keyType)) &&
+            (RadixKeySize(keyType) <= itemSize) &&
+            (numItems >= RADIX_MIN_ITEMS))
+        {
+            chosen = SORT_ALG_RADIX;
+        }
+        else if ((profile.samples > 0) &&
+            ((2 * profile.duplicates) >= profile.samples))
+        {
+            /* few distinct values */
+            chosen = SORT_ALG_QUICK_3WAY;
+        }
+        else if (((4 * profile.descents) >= profile.pairs) &&
+            ((4 * profile.descents) <= (3 * profile.pairs)))
+        {
+            /* about as many descents as ascents, assume random order */
+            chosen = SORT_ALG_DUAL_PIVOT_QUICK;
+        }
+        else
+        {
+            chosen = SORT_ALG_NATURAL_MERGE;
+        }
+    }
+
+    StatSet(algorithm, chosen);
+
+    switch (chosen)
+    {
+        case SORT_ALG_INSERTION:
+            result = InsertionSortCtx(ctx, list, numItems, itemSize,
+                compareFunc);
+            break;
+
+        case SORT_ALG_RADIX:
+            result = RadixSortNumericCtx(ctx, list, numItems, itemSize, 0,
+                keyType);
+            break;
+
+        case SORT_ALG_QUICK_3WAY:
+            result = QuickSort3WayCtx(ctx, list, numItems, itemSize,
+                compareFunc);
+            break;
+
+        case SORT_ALG_DUAL_PIVOT_QUICK:
+            result = DualPivotQuickSortCtx(ctx, list, numItems, itemSize,
+                compareFunc);
+            break;
+
+        default:
+            result = NaturalMergeSortCtx(ctx, list, numItems, itemSize,
+                compareFunc);
+            break;
+    }
+
+    if (NULL != algorithm)
+    {
+        *algorithm = chosen;
+    }
+
+    return result;
+}
+
+/***************************************************************************
+*   Function   : ProfileList
+*   Description: This function samples a list to estimate how sorted it is
+*                and how many duplicates it contains.  Order is estimated
+*                by counting the descents in windows of adjacent items
+*                spread across the list.  Duplicates are estimated by
+*                sorting a copy of evenly spaced items and counting the
+*                items that are equal to their predecessor.  The sample
+*                size is fixed, so the cost doesn't grow with the list.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sample
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                profile - pointer to structure receiving the estimates
+*   Effects    : profile is filled in
+*   Returned   : NONE
+***************************************************************************/
+static void ProfileList(sort_context_t *ctx, void *list, size_t numItems,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    list_profile_t *profile)
+{
+    size_t window, start, end, i, step;
+    void *sample;
+
+    memset(profile, 0, sizeof(list_profile_t));
+
+    /* count descents in windows of adjacent items */
+    for (window = 0; window < SAMPLE_WINDOWS; window++)
+    {
+        if (numItems <= (SAMPLE_WINDOWS * SAMPLE_WINDOW))
+        {
+            /* the list is small enough to check all of it */
+            start = 0;
+            end = numItems;
+            window = SAMPLE_WINDOWS;
+        }
+        else
+        {
+            start = ((numItems - SAMPLE_WINDOW) / (SAMPLE_WINDOWS - 1)) *
+                window;
+            end = start + SAMPLE_WINDOW;
+        }
+
+        for (i = start + 1; i < end; i++)
+        {
+            profile->pairs++;
+
+            if (CompareItems(compareFunc, VoidPtrOffset(list, i * itemSize),
+                VoidPtrOffset(list, (i - 1) * itemSize)) < 0)
+            {
+                profile->descents++;
+            }
+        }
+    }
+
+    /* count duplicates in a sorted sample of evenly spaced items */
+    profile->samples =
+        (numItems < DUPLICATE_SAMPLES) ? numItems : DUPLICATE_SAMPLES;
+    sample = ContextAlloc(ctx, profile->samples * itemSize);
+
+    if (NULL == sample)
+    {
+        /* no duplicate estimate, assume there aren't many */
+        profile->samples = 0;
+        return;
+    }
+
+    step = numItems / profile->samples;
+
+    for (i = 0; i < profile->samples; i++)
+    {
+        CopyItem(VoidPtrOffset(sample, i * itemSize),
+            VoidPtrOffset(list, i * step * itemSize), itemSize);
+    }
+
+    if (SORT_OK != InsertionSortCtx(ctx, sample, profile->samples,
+        itemSize, compareFunc))
+    {
+        ContextFree(ctx, sample, profile->samples * itemSize);
+        profile->samples = 0;
+        return;
+    }
+
+    for (i = 1; i < profile->samples; i++)
+    {
+        if (0 == CompareItems(compareFunc,
+            VoidPtrOffset(sample, i * itemSize),
+            VoidPtrOffset(sample, (i - 1) * itemSize)))
+        {
+            profile->duplicates++;
+        }
+    }
+
+    ContextFree(ctx, sample, profile->samples * itemSize);
+}
@@ -0,0 +1,443 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortbuf.c
+*   Purpose : This module implements a sorted buffer; a sorted array that
+*             items are appended to in batches.  Rather than sorting the
+*             whole array after every batch, only the new batch is sorted
+*             and then it is merged into the array from the back, into the
+*             capacity reserved after the existing items.  Batches that
+*             are small compared to the array are collected in a tier of
+*             sorted runs (like a log-structured merge tree).  Adjacent
+*             runs of similar size are merged as they're added, and the
+*             tier is folded into the array when it grows too large or the
+*             sorted items are requested.  Items that are ordered the same
+*             stay in the order that they were appended.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdlib.h>
+#include "sort.h"
+#include "sortint.h"
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* batches with less than 1/SMALL_BATCH_RATIO of the items go to the tier */
+#define SMALL_BATCH_RATIO   8
+
+/* the tier is folded in when it has 1/TIER_RATIO of the items */
+#define TIER_RATIO          4
+
+/* the tier is also folded in when it has this many runs */
+#define MAX_TIER_RUNS       32
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+struct sorted_buffer_t
+{
+    size_t itemSize;            /* size of each item */
+    int (*compareFunc) (const void *, const void *);
+    void *items;                /* sorted items */
+    size_t numItems;            /* number of sorted items */
+    size_t capacity;            /* items that fit in items */
+    void *tier;                 /* runs of recently appended items */
+    size_t tierItems;           /* number of items in the tier */
+    size_t tierCapacity;        /* items that fit in tier */
+    size_t runs[MAX_TIER_RUNS]; /* length of each run in the tier */
+    size_t numRuns;             /* number of runs in the tier */
+    void *temp;                 /* holds one run while it's merged */
+    size_t tempCapacity;        /* items that fit in temp */
+    sort_context_t *ctx;        /* scratch memory for sorting batches */
+};
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static bool_t Reserve(void **array, size_t *capacity, size_t needed,
+    size_t itemSize);
+static void BackwardMerge(void *dst, size_t leftItems, const void *right,
+    size_t rightItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+static void MergeTopRuns(sorted_buffer_t *buffer);
+static void FoldTier(sorted_buffer_t *buffer);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : SortedBufferCreate
+*   Description: This function creates an empty sorted buffer.
+*   Parameters : itemSize - size of each item
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                capacity - number of items to reserve space for (the
+*                           buffer grows as needed)
+*   Effects    : Memory is allocated for the buffer
+*   Returned   : Pointer to the buffer, NULL on failure.
+***************************************************************************/
+sorted_buffer_t *SortedBufferCreate(size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t capacity)
+{
+    sorted_buffer_t *buffer;
+
+    buffer = (sorted_buffer_t *)calloc(1, sizeof(sorted_buffer_t));
+
+    if (NULL == buffer)
+    {
+        return NULL;
+    }
+
+    buffer->itemSize = itemSize;
+    buffer->compareFunc = compareFunc;
+    buffer->ctx = SortContextCreate(NULL, 0, 0);
+
+    if ((NULL == buffer->ctx) ||
+        !Reserve(&buffer->items, &buffer->capacity, capacity, itemSize))
+    {
+        SortContextFree(buffer->ctx);
+        free(buffer);
+        return NULL;
+    }
+
+    return buffer;
+}
+
+/***************************************************************************
+*   Function   : SortedBufferFree
+*   Description: This function frees a sorted buffer and its items.
+*   Parameters : buffer - pointer to the buffer
+*   Effects    : The buffer's memory is freed
+*   Returned   : NONE
+***************************************************************************/
+void SortedBufferFree(sorted_buffer_t *buffer)
+{
+    if (NULL == buffer)
+    {
+        return;
+    }
+
+    SortContextFree(buffer->ctx);
+    free(buffer->items);
+    free(buffer->tier);
+    free(buffer->temp);
+    free(buffer);
+}
+
+/***************************************************************************
+*   Function   : SortedBufferAppend
+*   Description: This function adds a batch of items to a sorted buffer.
+*                The batch is copied into reserved space and sorted with
+*                NaturalMergeSortCtx, using the buffer's context (which
+*                keeps its scratch memory between appends).  Small batches
+*                become a run in the tier, and larger ones are merged
+*                straight into the sorted items (after the tier is folded
+*                in, so equal items stay in append order).  All of the
+*                memory that may be needed is reserved and the batch is
+*                sorted before anything in the buffer changes, so a failed
+*                append leaves the buffer unchanged.
+*   Parameters : buffer - pointer to the buffer
+*                items - array of items to add (in any order)
+*                numItems - number of items in the array
+*   Effects    : The items are added to the buffer
+*   Returned   : 1 for success, 0 if memory couldn't be allocated.
+***************************************************************************/
+int SortedBufferAppend(sorted_buffer_t *buffer, const void *items,
+    size_t numItems)
+{
+    size_t total, itemSize;
+    void *run;
+
+    if (0 == numItems)
+    {
+        return 1;
+    }
+
+    itemSize = buffer->itemSize;
+    total = buffer->numItems + buffer->tierItems + numItems;
+
+    /* the sorted items will have to hold everything eventually */
+    if (!Reserve(&buffer->items, &buffer->capacity, total, itemSize) ||
+        !Reserve(&buffer->temp, &buffer->tempCapacity,
+            buffer->tierItems + numItems, itemSize))
+    {
+        return 0;
+    }
+
+    if ((numItems * SMALL_BATCH_RATIO) < buffer->numItems)
+    {
+        /* small batch, make it a new run in the tier */
+        if (!Reserve(&buffer->tier, &buffer->tierCapacity,
+            buffer->tierItems + numItems, itemSize))
+        {
+            return 0;
+        }
+
+        run = VoidPtrOffset(buffer->tier, buffer->tierItems * itemSize);
+        CopyItems(run, items, numItems, itemSize);
+
+        if (SORT_OK != NaturalMergeSortCtx(buffer->ctx, run, numItems,
+            itemSize, buffer->compareFunc))
+        {
+            return 0;       /* the run isn't counted, so nothing changed */
+        }
+
+        buffer->tierItems += numItems;
+        buffer->runs[buffer->numRuns] = numItems;
+        buffer->numRuns++;
+
+        /* keep run lengths decreasing toward the top */
+        while ((buffer->numRuns > 1) &&
+            (buffer->runs[buffer->numRuns - 1] >=
+            buffer->runs[buffer->numRuns - 2]))
+        {
+            MergeTopRuns(buffer);
+        }
+
+        if (((buffer->tierItems * TIER_RATIO) >= buffer->numItems) ||
+            (MAX_TIER_RUNS == buffer->numRuns))
+        {
+            FoldTier(buffer);
+        }
+    }
+    else
+    {
+        /* sort the batch after the part of temp that FoldTier uses */
+        run = VoidPtrOffset(buffer->temp, buffer->tierItems * itemSize);
+        CopyItems(run, items, numItems, itemSize);
+
+        if (SORT_OK != NaturalMergeSortCtx(buffer->ctx, run, numItems,
+            itemSize, buffer->compareFunc))
+        {
+            return 0;
+        }
+
+        FoldTier(buffer);
+        BackwardMerge(buffer->items, buffer->numItems, run, numItems,
+            itemSize, buffer->compareFunc);
+        buffer->numItems += numItems;
+    }
+
+    return 1;
+}
+
+/***************************************************************************
+*   Function   : SortedBufferItems
+*   Description: This function folds any runs in the tier into a sorted
+*                buffer's items, and returns the sorted items.
+*   Parameters : buffer - pointer to the buffer
+*   Effects    : The tier is folded into the sorted items
+*   Returned   : Pointer to the sorted items.  It remains valid until the
+*                next append.
+***************************************************************************/
+const void *SortedBufferItems(sorted_buffer_t *buffer)
+{
+    FoldTier(buffer);
+    return buffer->items;
+}
+
+/***************************************************************************
+*   Function   : SortedBufferCount
+*   Description: This function returns the number of items in a sorted
+*                buffer.
+*   Parameters : buffer - pointer to the buffer
+*   Effects    : NONE
+*   Returned   : Number of items appended to the buffer
+***************************************************************************/
+size_t SortedBufferCount(const sorted_buffer_t *buffer)
+{
+    return buffer->numItems + buffer->tierItems;
+}
+
+/***************************************************************************
+*   Function   : Reserve
+*   Description: This function makes sure that an array has room for a
+*                number of items, growing it geometrically if it doesn't.
+*   Parameters : array - pointer to the array pointer
+*                capacity - pointer to the number of items that fit
+*                needed - number of items that must fit
+*                itemSize - size of each item
+*   Effects    : The array may be reallocated
+*   Returned   : TRUE for success, FALSE if memory couldn't be allocated
+*                (the array is unchanged).
+***************************************************************************/
+static bool_t Reserve(void **array, size_t *capacity, size_t needed,
+    size_t itemSize)
+{
+    size_t newCapacity;
+    void *newArray;
+
+    if (needed <= *capacity)
+    {
+        return TRUE;
+    }
+
+    newCapacity = *capacity + (*capacity / 2);
+
+    if (newCapacity < needed)
+    {
+        newCapacity = needed;
+    }
+
+    newArray = realloc(*array, newCapacity * itemSize);
+
+    if (NULL == newArray)
+    {
+        return FALSE;
+    }
+
+    *array = newArray;
+    *capacity = newCapacity;
+    return TRUE;
+}
+
+/***************************************************************************
+*   Function   : BackwardMerge
+*   Description: This function merges a sorted run into a sorted array
+*                that has room for it after its items.  The merge starts
+*                with the largest items, so no item in the array is
+*                overwritten before it's moved.  Ties are won by the right
+*                run, so its items end up after equal items in the array.
+*                If the run belongs after every item in the array, it's
+*                simply copied.
+*   Parameters : dst - array of leftItems sorted items with room for
+*                      rightItems more
+*                leftItems - number of items in dst
+*                right - sorted run to merge into dst (not overlapping dst)
+*                rightItems - number of items in right
+*                itemSize - size of each item
+*                compareFunc - function used to compare items
+*   Effects    : dst holds the sorted items of both
+*   Returned   : NONE
+***************************************************************************/
+static void BackwardMerge(void *dst, size_t leftItems, const void *right,
+    size_t rightItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    size_t i, j, k;
+
+    if ((0 == leftItems) ||
+        (CompareItems(compareFunc, VoidPtrOffset(dst, (leftItems - 1) *
+        itemSize), right) <= 0))
+    {
+        /* appended items come after the existing ones */
+        CopyItems(VoidPtrOffset(dst, leftItems * itemSize), right,
+            rightItems, itemSize);
+        return;
+    }
+
+    i = leftItems;
+    j = rightItems;
+    k = leftItems + rightItems;
+
+    while ((j > 0) && (i > 0))
+    {
+        k--;
+
+        if (CompareItems(compareFunc, VoidPtrOffset(dst, (i - 1) * itemSize),
+            VoidPtrOffset(right, (j - 1) * itemSize)) > 0)
+        {
+            i--;
+            CopyItem(VoidPtrOffset(dst, k * itemSize),
+                VoidPtrOffset(dst, i * itemSize), itemSize);
+        }
+        else
+        {
+            j--;
+            CopyItem(VoidPtrOffset(dst, k * itemSize),
+                VoidPtrOffset(right, j * itemSize), itemSize);
+        }
+    }
+
+    /* whatever is left of the right run goes at the front */
+    CopyItems(dst, right, j, itemSize);
+}
+
+/***************************************************************************
+*   Function   : MergeTopRuns
+*   Description: This function merges the two most recent runs in a sorted
+*                buffer's tier.  The newer run is copied to temp and merged
+*                back over the two.
+*   Parameters : buffer - pointer to the buffer (with at least two runs)
+*   Effects    : The two top runs become one
+*   Returned   : NONE
+***************************************************************************/
+static void MergeTopRuns(sorted_buffer_t *buffer)
+{
+    size_t left, right, start, itemSize;
+
+    itemSize = buffer->itemSize;
+    right = buffer->runs[buffer->numRuns - 1];
+    left = buffer->runs[buffer->numRuns - 2];
+    start = buffer->tierItems - right - left;
+
+    CopyItems(buffer->temp,
+        VoidPtrOffset(buffer->tier, (start + left) * itemSize), right,
+        itemSize);
+    BackwardMerge(VoidPtrOffset(buffer->tier, start * itemSize), left,
+        buffer->temp, right, itemSize, buffer->compareFunc);
+
+    buffer->runs[buffer->numRuns - 2] = left + right;
+    buffer->numRuns--;
+}
+
+/***************************************************************************
+*   Function   : FoldTier
+*   Description: This function merges all of the runs in a sorted buffer's
+*                tier into one, and merges that into the sorted items.
+*                The sorted items and temp already have room for it.
+*   Parameters : buffer - pointer to the buffer
+*   Effects    : The tier is emptied into the sorted items
+*   Returned   : NONE
+***************************************************************************/
+static void FoldTier(sorted_buffer_t *buffer)
+{
+    if (0 == buffer->numRuns)
+    {
+        return;
+    }
+
+    while (buffer->numRuns > 1)
+    {
+        MergeTopRuns(buffer);
+    }
+
+    BackwardMerge(buffer->items, buffer->numItems, buffer->tier,
+        buffer->tierItems, buffer->itemSize, buffer->compareFunc);
+    buffer->numItems += buffer->tierItems;
+    buffer->tierItems = 0;
+    buffer->numRuns = 0;
+}
@@ -0,0 +1,539 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortctx.c
+*   Purpose : This module implements sort contexts.  A context owns the
+*             scratch memory used by the sorts that are passed it, and
+*             keeps that memory between calls, so a program that sorts
+*             over and over only allocates memory for its first sorts.
+*             Scratch memory is handed out from the newest of a list of
+*             blocks like a stack, and must be freed in the opposite order
+*             that it was allocated.  When every allocation has been freed
+*             the blocks are combined into a single block large enough for
+*             the most memory used at once.  A context may instead be given
+*             an arena of memory by the caller, in which case it never
+*             allocates any memory at all.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/* large blocks may be mapped and marked for huge pages on Linux */
+#if defined(__linux__) && !defined(SORT_NO_HUGE_PAGES)
+#define _DEFAULT_SOURCE
+#define SORT_MMAP
+#endif
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdlib.h>
+#include "sort.h"
+#include "sortint.h"
+
+#ifdef SORT_MMAP
+#include <sys/mman.h>
+#endif
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* every allocation is aligned to this many bytes */
+#define CONTEXT_ALIGN       16
+
+/* the smallest block a context allocates */
+#define MIN_BLOCK_BYTES     (64 * 1024)
+
+/* blocks at least this large may be backed by huge pages */
+#define HUGE_PAGE_BYTES     (2 * 1024 * 1024)
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* where the memory for a block came from */
+typedef enum
+{
+    BLOCK_ARENA,                /* the caller's arena */
+    BLOCK_HEAP,                 /* malloc */
+    BLOCK_MAPPED                /* mmap */
+} block_backing_t;
+
+/* a block of scratch memory, allocations follow the header */
+typedef struct context_block_t
+{
+    struct context_block_t *prev;   /* next older block, NULL if oldest */
+    size_t size;                /* bytes available for allocations */
+    size_t used;                /* bytes allocated */
+    size_t totalBytes;          /* bytes in the block, header included */
+    block_backing_t backing;    /* where the block's memory came from */
+} context_block_t;
+
+struct sort_context_t
+{
+    context_block_t *top;       /* newest block, NULL if none */
+    unsigned int flags;         /* SORT_CTX_ flags */
+    bool_t arena;               /* TRUE if only the caller's arena is used */
+    size_t inUse;               /* bytes allocated from all blocks */
+    size_t peak;                /* most bytes allocated at once */
+};
+
+/***************************************************************************
+*                                 MACROS
+***************************************************************************/
+/* round a size up to the allocation alignment */
+#define RoundUp(size)   (((size) + (CONTEXT_ALIGN - 1)) &               \
+                            ~(size_t)(CONTEXT_ALIGN - 1))
+
+/* the header sizes, rounded up so that allocations stay aligned */
+#define CONTEXT_HEADER  RoundUp(sizeof(sort_context_t))
+#define BLOCK_HEADER    RoundUp(sizeof(context_block_t))
+
+/* the first byte of a block available for allocations */
+#define BlockData(block)    ((char *)(block) + BLOCK_HEADER)
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static context_block_t *BlockCreate(sort_context_t *ctx, size_t size);
+static void BlockFree(context_block_t *block);
+static void BlocksFree(sort_context_t *ctx);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : SortContextCreate
+*   Description: This function creates a context that holds the scratch
+*                memory used by the Ctx versions of the sorts.  Memory is
+*                kept between sorts, so repeating a sort of the same size
+*                allocates nothing.  A context may only be used by one
+*                thread at a time.
+*   Parameters : arena - memory for the context to use instead of
+*                        allocating its own, or NULL.  The context
+*                        itself is kept at the start of the arena.
+*                arenaSize - number of bytes in arena
+*                flags - SORT_CTX_HUGE_PAGES to back large blocks with
+*                        huge pages where the system supports them
+*                        (ignored when there is an arena)
+*   Effects    : Memory is allocated for the context unless there is an
+*                arena
+*   Returned   : Pointer to the context, NULL if memory couldn't be
+*                allocated or the arena is too small.
+***************************************************************************/
+sort_context_t *SortContextCreate(void *arena, size_t arenaSize,
+    unsigned int flags)
+{
+    sort_context_t *ctx;
+    context_block_t *block;
+    size_t skip;
+
+    if (NULL == arena)
+    {
+        ctx = (sort_context_t *)malloc(sizeof(sort_context_t));
+
+        if (NULL == ctx)
+        {
+            return NULL;
+        }
+
+        ctx->top = NULL;
+        ctx->arena = FALSE;
+    }
+    else
+    {
+        /* align the start of the arena */
+        skip = RoundUp((size_t)arena) - (size_t)arena;
+
+        if (arenaSize < (skip + CONTEXT_HEADER + BLOCK_HEADER))
+        {
+            return NULL;
+        }
+
+        ctx = (sort_context_t *)VoidPtrOffset(arena, skip);
+        block = (context_block_t *)VoidPtrOffset(ctx, CONTEXT_HEADER);
+        block->prev = NULL;
+        block->totalBytes = arenaSize - skip - CONTEXT_HEADER;
+        block->size = (block->totalBytes - BLOCK_HEADER) &
+            ~(size_t)(CONTEXT_ALIGN - 1);
+        block->used = 0;
+        block->backing = BLOCK_ARENA;
+
+        ctx->top = block;
+        ctx->arena = TRUE;
+    }
+
+    ctx->flags = flags;
+    ctx->inUse = 0;
+    ctx->peak = 0;
+
+    return ctx;
+}
+
+/***************************************************************************
+*   Function   : SortContextFree
+*   Description: This function frees a context and all of the memory it
+*                allocated.  The caller's arena (if any) isn't freed.
+*   Parameters : ctx - pointer to the context
+*   Effects    : The context's memory is freed
+*   Returned   : NONE
+***************************************************************************/
+void SortContextFree(sort_context_t *ctx)
+{
+    if ((NULL == ctx) || ctx->arena)
+    {
+        return;
+    }
+
+    BlocksFree(ctx);
+    free(ctx);
+}
+
+/***************************************************************************
+*   Function   : SortContextReserve
+*   Description: This function makes sure that a context has a single block
+*                of at least the requested size, so that sorts needing no
+*                more than that much scratch memory won't allocate any.
+*   Parameters : ctx - pointer to the context
+*                bytes - number of bytes of scratch memory to reserve
+*   Effects    : The context's blocks may be replaced
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if the memory couldn't
+*                be allocated (or doesn't fit in the arena), SORT_ERR_PARAM
+*                if the context has memory allocated from it.
+***************************************************************************/
+sort_error_t SortContextReserve(sort_context_t *ctx, size_t bytes)
+{
+    bytes = RoundUp(bytes);
+
+    if (0 != ctx->inUse)
+    {
+        return SORT_ERR_PARAM;
+    }
+
+    if ((NULL != ctx->top) && (NULL == ctx->top->prev) &&
+        (ctx->top->size >= bytes))
+    {
+        return SORT_OK;         /* already large enough */
+    }
+
+    if (ctx->arena)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    BlocksFree(ctx);
+    ctx->top = BlockCreate(ctx, bytes);
+
+    if (bytes > ctx->peak)
+    {
+        ctx->peak = bytes;
+    }
+
+    return (NULL == ctx->top) ? SORT_ERR_NOMEM : SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : ContextAlloc
+*   Description: This function allocates scratch memory from a context.
+*                If the newest block doesn't have room, a larger block is
+*                added (unless the context only uses an arena).
+*   Parameters : ctx - pointer to the context, NULL to use ScratchAlloc
+*                size - number of bytes to allocate
+*   Effects    : Memory is allocated from the context
+*   Returned   : Pointer to the allocated memory, NULL on failure.
+***************************************************************************/
+void *ContextAlloc(sort_context_t *ctx, size_t size)
+{
+    context_block_t *block;
+    size_t blockSize;
+    void *ptr;
+
+    if (NULL == ctx)
+    {
+        return ScratchAlloc(size);
+    }
+
+    size = (0 == size) ? CONTEXT_ALIGN : RoundUp(size);
+    block = ctx->top;
+
+    if ((NULL == block) || ((block->size - block->used) < size))
+    {
+        if (ctx->arena)
+        {
+            return NULL;
+        }
+
+        blockSize = MIN_BLOCK_BYTES;
+
+        if (NULL != block)
+        {
+            blockSize = 2 * block->size;
+
+            if (0 == block->used)
+            {
+                /* replace an empty block that is too small */
+                ctx->top = block->prev;
+                BlockFree(block);
+            }
+        }
+
+        if (blockSize < size)
+        {
+            blockSize = size;
+        }
+
+        block = BlockCreate(ctx, blockSize);
+
+        if (NULL == block)
+        {
+            return NULL;
+        }
+
+        block->prev = ctx->top;
+        ctx->top = block;
+    }
+
+    ptr = BlockData(block) + block->used;
+    block->used += size;
+    ctx->inUse += size;
+
+    if (ctx->inUse > ctx->peak)
+    {
+        ctx->peak = ctx->inUse;
+    }
+
+#ifdef SORT_STATS
+    if (NULL != sortStats)
+    {
+        sortStats->scratchBytes += size;
+
+        if (sortStats->scratchBytes > sortStats->peakScratchBytes)
+        {
+            sortStats->peakScratchBytes = sortStats->scratchBytes;
+        }
+    }
+#endif
+
+    return ptr;
+}
+
+/***************************************************************************
+*   Function   : ContextCalloc
+*   Description: This function allocates zeroed scratch memory from a
+*                context.
+*   Parameters : ctx - pointer to the context, NULL to use ScratchCalloc
+*                count - number of elements to allocate
+*                size - size of each element
+*   Effects    : Memory is allocated from the context
+*   Returned   : Pointer to the allocated memory, NULL on failure.
+***************************************************************************/
+void *ContextCalloc(sort_context_t *ctx, size_t count, size_t size)
+{
+    void *ptr;
+
+    ptr = ContextAlloc(ctx, count * size);
+
+    if (NULL != ptr)
+    {
+        memset(ptr, 0, count * size);
+    }
+
+    return ptr;
+}
+
+/***************************************************************************
+*   Function   : ContextFree
+*   Description: This function frees scratch memory allocated from a
+*                context.  Memory must be freed in the opposite order that
+*                it was allocated.  Once everything has been freed, blocks
+*                are combined into one for the next sort.
+*   Parameters : ctx - pointer to the context, NULL to use ScratchFree
+*                ptr - pointer to the memory to free (may be NULL)
+*                size - number of bytes that were allocated
+*   Effects    : The memory may be allocated again
+*   Returned   : NONE
+***************************************************************************/
+void ContextFree(sort_context_t *ctx, void *ptr, size_t size)
+{
+    context_block_t *block;
+
+    if (NULL == ctx)
+    {
+        ScratchFree(ptr, size);
+        return;
+    }
+
+    if ((NULL == ptr) || (0 == ctx->inUse))
+    {
+        return;
+    }
+
+    size = (0 == size) ? CONTEXT_ALIGN : RoundUp(size);
+
+    /* the newest allocation is at the end of the newest non-empty block */
+    for (block = ctx->top; 0 == block->used; block = block->prev);
+
+    if ((char *)ptr != (BlockData(block) + block->used - size))
+    {
+        return;     /* freed out of order, it's released with the block */
+    }
+
+    block->used -= size;
+    ctx->inUse -= size;
+
+#ifdef SORT_STATS
+    if (NULL != sortStats)
+    {
+        sortStats->scratchBytes -= size;
+    }
+#endif
+
+    if ((0 == ctx->inUse) && (NULL != ctx->top->prev))
+    {
+        /* combine the blocks, the next sort like this one uses just one */
+        BlocksFree(ctx);
+        ctx->top = BlockCreate(ctx, ctx->peak);
+    }
+}
+
+/***************************************************************************
+*   Function   : BlockCreate
+*   Description: This function allocates a block of scratch memory for a
+*                context.  When huge pages were requested, large blocks are
+*                mapped and marked for huge pages.  Otherwise the heap is
+*                used.
+*   Parameters : ctx - pointer to the context
+*                size - bytes available for allocations in the block
+*   Effects    : Memory is allocated for the block
+*   Returned   : Pointer to the block, NULL on failure.
+***************************************************************************/
+static context_block_t *BlockCreate(sort_context_t *ctx, size_t size)
+{
+    context_block_t *block;
+    size_t totalBytes;
+
+    block = NULL;
+    totalBytes = BLOCK_HEADER + size;
+
+#ifdef SORT_MMAP
+    if ((ctx->flags & SORT_CTX_HUGE_PAGES) && (totalBytes >= HUGE_PAGE_BYTES))
+    {
+        void *mem;
+
+        /* use every byte of the last huge page */
+        totalBytes = ((totalBytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES) *
+            HUGE_PAGE_BYTES;
+        mem = mmap(NULL, totalBytes, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (MAP_FAILED != mem)
+        {
+#ifdef MADV_HUGEPAGE
+            (void)madvise(mem, totalBytes, MADV_HUGEPAGE);
+#endif
+            block = (context_block_t *)mem;
+            block->backing = BLOCK_MAPPED;
+            size = totalBytes - BLOCK_HEADER;
+        }
+        else
+        {
+            totalBytes = BLOCK_HEADER + size;
+        }
+    }
+#else
+    (void)ctx;
+#endif
+
+    if (NULL == block)
+    {
+        block = (context_block_t *)malloc(totalBytes);
+
+        if (NULL == block)
+        {
+            return NULL;
+        }
+
+        block->backing = BLOCK_HEAP;
+    }
+
+#ifdef SORT_STATS
+    if (NULL != sortStats)
+    {
+        sortStats->mallocs++;
+    }
+#endif
+
+    block->prev = NULL;
+    block->size = size;
+    block->used = 0;
+    block->totalBytes = totalBytes;
+
+    return block;
+}
+
+/***************************************************************************
+*   Function   : BlockFree
+*   Description: This function frees a block allocated by BlockCreate.
+*                Blocks in the caller's arena aren't freed.
+*   Parameters : block - pointer to the block
+*   Effects    : The block's memory is freed
+*   Returned   : NONE
+***************************************************************************/
+static void BlockFree(context_block_t *block)
+{
+#ifdef SORT_MMAP
+    if (BLOCK_MAPPED == block->backing)
+    {
+        munmap(block, block->totalBytes);
+        return;
+    }
+#endif
+
+    if (BLOCK_HEAP == block->backing)
+    {
+        free(block);
+    }
+}
+
+/***************************************************************************
+*   Function   : BlocksFree
+*   Description: This function frees every block of a context.
+*   Parameters : ctx - pointer to the context
+*   Effects    : The context has no blocks
+*   Returned   : NONE
+***************************************************************************/
+static void BlocksFree(sort_context_t *ctx)
+{
+    context_block_t *block;
+
+    while (NULL != ctx->top)
+    {
+        block = ctx->top;
+        ctx->top = block->prev;
+        BlockFree(block);
+    }
+}
@@ -0,0 +1,207 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortint.h
+*   Purpose : This is the internal header shared by the modules that make
+*             up the sort library.  It isn't intended for use by code
+*             outside of the library.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2003, 2007, 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+#ifndef _SORTINT_H_
+#define _SORTINT_H_
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <string.h>
+#include "sort.h"
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+typedef enum
+{
+    FALSE,
+    TRUE
+} bool_t;
+
+/* lock and background thread, defined in sortpar.c */
+typedef struct sort_lock_t sort_lock_t;
+typedef struct sort_thread_t sort_thread_t;
+
+/* k-way merge of sorted lists, defined in sortmerge.c */
+typedef struct loser_tree_t loser_tree_t;
+
+/* staging lines for radix sort scatters, defined in sortradix.c */
+typedef struct radix_scatter_t radix_scatter_t;
+
+/***************************************************************************
+*                                 MACROS
+***************************************************************************/
+#define Swap(x, y, temp, size)      {   memcpy(temp, x, size);  \
+                                        memcpy(x, y, size);     \
+                                        memcpy(y, temp, size);  \
+                                        StatMove(3, size);      }
+
+#define VoidPtrOffset(ptr, offset)  (void *)(&((char *)ptr)[offset])
+
+/* copy a run of count items of size bytes each */
+#define CopyItems(dst, src, count, size)                        \
+                                    (memcpy(dst, src, (count) * (size)), \
+                                        StatMove(count, size))
+
+#define CopyItem(dst, src, size)    CopyItems(dst, src, 1, size)
+
+/* move a run of count items that may overlap its destination */
+#define MoveItems(dst, src, count, size)                        \
+                                    (memmove(dst, src, (count) * (size)), \
+                                        StatMove(count, size))
+
+#define CompareItems(compareFunc, x, y)                         \
+                                    (StatAdd(comparisons, 1),   \
+                                        compareFunc((x), (y)))
+
+/* thresholds used by the sort library (see sorttune.c) */
+#define sortTuning                  (*SortTuningValues())
+
+/* thread local storage, for per-thread statistics and calibration */
+#if defined(__GNUC__)
+#define SORT_TLS                    __thread
+#elif defined(_MSC_VER)
+#define SORT_TLS                    __declspec(thread)
+#else
+#define SORT_TLS
+#endif
+
+/***************************************************************************
+* Operation statistics.  When SORT_STATS isn't defined all of these macros
+* become no-ops, so uninstrumented builds pay nothing for them.
+***************************************************************************/
+#ifdef SORT_STATS
+
+#define StatAdd(field, n)           ((NULL != sortStats) ?      \
+                                        (void)(sortStats->field += (n)) : \
+                                        (void)0)
+
+#define StatSet(field, value)       ((NULL != sortStats) ?      \
+                                        (void)(sortStats->field = (value)) : \
+                                        (void)0)
+
+#define StatMove(count, size)       (StatAdd(moves, (count)),   \
+                                        StatAdd(bytesCopied, (count) * (size)))
+
+#define StatEnter()                 ((NULL != sortStats) ?      \
+                                        StatDepth(1) : (void)0)
+
+#define StatLeave()                 ((NULL != sortStats) ?      \
+                                        StatDepth(-1) : (void)0)
+
+#else
+
+#define StatAdd(field, n)           ((void)0)
+#define StatSet(field, value)       ((void)0)
+#define StatMove(count, size)       ((void)0)
+#define StatEnter()                 ((void)0)
+#define StatLeave()                 ((void)0)
+
+#endif  /* SORT_STATS */
+
+/***************************************************************************
+*                            GLOBAL VARIABLES
+***************************************************************************/
+#ifdef SORT_STATS
+extern SORT_TLS sort_stats_t *sortStats;
+#endif
+
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+/* thresholds used by the sort library, SORT_TUNING_FILE is loaded the
+ * first time they're used (see sorttune.c) */
+sort_tuning_t *SortTuningValues(void);
+
+/* scratch memory allocation that is tracked by the statistics */
+void *ScratchAlloc(size_t size);
+void *ScratchCalloc(size_t count, size_t size);
+void ScratchFree(void *ptr, size_t size);
+
+/* scratch memory from a sort context, the heap for NULL (see sortctx.c) */
+void *ContextAlloc(sort_context_t *ctx, size_t size);
+void *ContextCalloc(sort_context_t *ctx, size_t count, size_t size);
+void ContextFree(sort_context_t *ctx, void *ptr, size_t size);
+
+#ifdef SORT_STATS
+void StatDepth(int delta);
+#endif
+
+/* binary insertion sort of items after the first sorted (see sort.c) */
+void BinaryInsertionSortTemp(void *list, size_t numItems, size_t sorted,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    void *temp);
+
+/* merge sort with the caller's buffer and temporary item (see sort.c) */
+void MergeSortRecursive(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), void *merged,
+    void *temp);
+
+/* three-way quick sort with the caller's temporary item (see sort.c) */
+void QuickSort3WayPartition(void *list, size_t numItems,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    void *temp);
+
+/* numeric keys for radix sorting (see sortradix.c) */
+size_t RadixKeySize(sort_key_t keyType);
+unsigned long RadixKey(const void *key, sort_key_t keyType);
+
+/* scatter items into buckets through staging lines (see sortradix.c) */
+radix_scatter_t *RadixScatterCreate(sort_context_t *ctx, size_t numBuckets,
+    size_t itemSize);
+void RadixScatterFree(sort_context_t *ctx, radix_scatter_t *scatter);
+void RadixScatterStart(radix_scatter_t *scatter, void *dst, size_t *offsets);
+void RadixScatterPut(radix_scatter_t *scatter, size_t bucket,
+    const void *item);
+void RadixScatterFinish(radix_scatter_t *scatter);
+
+/* merge sorted lists a few items at a time (see sortmerge.c) */
+loser_tree_t *LoserTreeCreate(sort_context_t *ctx,
+    const void *const *lists, const size_t *numItems, size_t numLists,
+    size_t itemSize, int (*compareFunc) (const void *, const void *));
+size_t LoserTreePop(loser_tree_t *tree, void *output, size_t maxItems);
+void LoserTreeFree(loser_tree_t *tree);
+
+/* threads and locks for the parallel sorts (see sortpar.c) */
+sort_thread_t *SortThreadStart(void (*func)(void *arg), void *arg);
+void SortThreadJoin(sort_thread_t *thread);
+sort_lock_t *SortLocksCreate(sort_context_t *ctx, size_t count);
+void SortLocksFree(sort_context_t *ctx, sort_lock_t *locks, size_t count);
+void SortLock(sort_lock_t *locks, size_t index);
+void SortUnlock(sort_lock_t *locks, size_t index);
+
+#endif /* _SORTINT_H_ */
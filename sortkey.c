@@ -0,0 +1,597 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortkey.c
+*   Purpose : This module sorts a column of keys and moves any number of
+*             payload columns along with it, so that data stored as
+*             separate arrays doesn't need to be interleaved into records
+*             before sorting and split apart afterward.  The sort finds
+*             the order of the keys, then ApplyPermutation moves every
+*             column into that order.  ApplyPermutation may also be used
+*             to put more columns into an order found earlier.
+*             SortByKeyFunc sorts items by a key computed from each item,
+*             calling the key function once per item instead of twice per
+*             comparison.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <assert.h>
+#include "sort.h"
+#include "sortint.h"
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* a numeric key mapped for radix sorting and the index it came from */
+typedef struct
+{
+    unsigned long key;
+    size_t index;
+} radix_record_t;
+
+/* where FindOrder gets each key */
+typedef struct
+{
+    const void *base;           /* the keys, or the items for keyFunc */
+    size_t stride;              /* bytes from one key (or item) to the next */
+    size_t keySize;             /* size of each key */
+    void (*keyFunc) (const void *item, void *key);  /* NULL to copy keys */
+} key_source_t;
+
+/* records holding a copy of a key are a multiple of this size */
+typedef union
+{
+    long l;
+    double d;
+    void *p;
+    size_t s;
+} record_align_t;
+
+/***************************************************************************
+*                                 MACROS
+***************************************************************************/
+#define RoundUpAlign(size)  ((((size) + sizeof(record_align_t) - 1) /   \
+                                sizeof(record_align_t)) *               \
+                                sizeof(record_align_t))
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static sort_error_t FindOrder(sort_context_t *ctx,
+    const key_source_t *source, size_t numItems,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType,
+    size_t *order);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : SortByKey
+*   Description: This function sorts a column of keys and the payload
+*                columns that go with it using scratch memory from the
+*                heap.  See SortByKeyCtx.
+*   Parameters : keys - a pointer to an array of keys to sort
+*                numItems - number of keys (and items in each payload)
+*                keySize - size of each key, the size of the keyType's C
+*                          type for numeric keys
+*                compareFunc - a comparison function for keys such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                keyType - type of numeric key, SORT_KEY_NONE for others
+*                payloads - array of numPayloads payload columns
+*                payloadSizes - size of an item in each payload column
+*                numPayloads - number of payload columns
+*                order - array receiving the original index of each sorted
+*                        key, NULL if it isn't needed
+*   Effects    : The keys are sorted, and the payloads are in the same order
+*   Returned   : NONE
+***************************************************************************/
+void SortByKey(void *keys, size_t numItems, size_t keySize,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType,
+    void *const *payloads, const size_t *payloadSizes, size_t numPayloads,
+    size_t *order)
+{
+    sort_error_t result;
+
+    result = SortByKeyCtx(NULL, keys, numItems, keySize, compareFunc,
+        keyType, payloads, payloadSizes, numPayloads, order);
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : SortByKeyCtx
+*   Description: This function sorts a column of keys and the payload
+*                columns that go with it.  Keys with a numeric type that
+*                may be radix sorted on this platform are radix sorted,
+*                and the others are sorted with a natural merge sort.
+*                Either way, the sort is stable.  The keys and payloads
+*                are then moved into sorted order with ApplyPermutation.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                keys - a pointer to an array of keys to sort
+*                numItems - number of keys (and items in each payload)
+*                keySize - size of each key, the size of the keyType's C
+*                          type for numeric keys
+*                compareFunc - a comparison function for keys such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                   It may be NULL for keys that are radix sorted.
+*                keyType - type of numeric key, SORT_KEY_NONE for others
+*                payloads - array of numPayloads payload columns
+*                payloadSizes - size of an item in each payload column
+*                numPayloads - number of payload columns
+*                order - array receiving the original index of each sorted
+*                        key, NULL if it isn't needed
+*   Effects    : The keys are sorted, and the payloads are in the same order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available, SORT_ERR_PARAM if keySize isn't the
+*                size of a keyType key, or the keys can't be radix sorted
+*                and there's no compareFunc.  After an error
+*                the keys and payloads are unchanged.
+***************************************************************************/
+sort_error_t SortByKeyCtx(sort_context_t *ctx, void *keys,
+    size_t numItems, size_t keySize,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType,
+    void *const *payloads, const size_t *payloadSizes, size_t numPayloads,
+    size_t *order)
+{
+    size_t *myOrder, *sizes;
+    void **columns;
+    key_source_t source;
+    size_t i;
+    sort_error_t result;
+
+    if (0 == numItems)
+    {
+        return SORT_OK;
+    }
+
+    myOrder = order;
+
+    if (NULL == myOrder)
+    {
+        myOrder = (size_t *)ContextAlloc(ctx, numItems * sizeof(size_t));
+
+        if (NULL == myOrder)
+        {
+            return SORT_ERR_NOMEM;
+        }
+    }
+
+    /* the keys are reordered along with the payloads */
+    columns = (void **)ContextAlloc(ctx, (numPayloads + 1) * sizeof(void *));
+    sizes = NULL;
+
+    if (NULL != columns)
+    {
+        sizes = (size_t *)ContextAlloc(ctx,
+            (numPayloads + 1) * sizeof(size_t));
+    }
+
+    if (NULL == sizes)
+    {
+        result = SORT_ERR_NOMEM;
+    }
+    else
+    {
+        columns[0] = keys;
+        sizes[0] = keySize;
+
+        for (i = 0; i < numPayloads; i++)
+        {
+            columns[i + 1] = payloads[i];
+            sizes[i + 1] = payloadSizes[i];
+        }
+
+        source.base = keys;
+        source.stride = keySize;
+        source.keySize = keySize;
+        source.keyFunc = NULL;
+
+        result = FindOrder(ctx, &source, numItems, compareFunc, keyType,
+            myOrder);
+
+        if (SORT_OK == result)
+        {
+            result = ApplyPermutationCtx(ctx, columns, sizes,
+                numPayloads + 1, numItems, myOrder);
+        }
+
+        ContextFree(ctx, sizes, (numPayloads + 1) * sizeof(size_t));
+    }
+
+    if (NULL != columns)
+    {
+        ContextFree(ctx, columns, (numPayloads + 1) * sizeof(void *));
+    }
+
+    if (NULL == order)
+    {
+        ContextFree(ctx, myOrder, numItems * sizeof(size_t));
+    }
+
+    return result;
+}
+
+/***************************************************************************
+*   Function   : SortByKeyFunc
+*   Description: This function sorts items by a key computed from each
+*                item using scratch memory from the heap.  See
+*                SortByKeyFuncCtx.
+*   Parameters : list - a pointer to an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                keyFunc - function writing the key of item to key
+*                keySize - size of each key, the size of the keyType's C
+*                          type for numeric keys
+*                compareFunc - a comparison function for keys such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                keyType - type of numeric key, SORT_KEY_NONE for others
+*                order - array receiving the original index of each sorted
+*                        item, NULL if it isn't needed
+*   Effects    : The items are sorted by their keys
+*   Returned   : NONE
+***************************************************************************/
+void SortByKeyFunc(void *list, size_t numItems, size_t itemSize,
+    void (*keyFunc) (const void *item, void *key), size_t keySize,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType,
+    size_t *order)
+{
+    sort_error_t result;
+
+    result = SortByKeyFuncCtx(NULL, list, numItems, itemSize, keyFunc,
+        keySize, compareFunc, keyType, order);
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : SortByKeyFuncCtx
+*   Description: This function sorts items by a key that is expensive to
+*                compute from them (a hash, a parsed field, a normalized
+*                string, etc.).  keyFunc is called exactly once for each
+*                item, and the keys are sorted along with the items'
+*                indices: numeric keys are radix sorted and others are
+*                sorted with a natural merge sort, calling compareFunc with
+*                pointers to the keys.  The items are then moved into
+*                sorted order with ApplyPermutation.  The sort is stable.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer to an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                keyFunc - function writing the key of item to key
+*                keySize - size of each key, the size of the keyType's C
+*                          type for numeric keys
+*                compareFunc - a comparison function for keys such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                   It may be NULL for keys that are radix sorted.
+*                keyType - type of numeric key, SORT_KEY_NONE for others
+*                order - array receiving the original index of each sorted
+*                        item, NULL if it isn't needed
+*   Effects    : The items are sorted by their keys
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available, SORT_ERR_PARAM if keySize isn't the
+*                size of a keyType key, or the keys can't be radix sorted
+*                and there's no compareFunc.  After an error
+*                the items are unchanged.
+***************************************************************************/
+sort_error_t SortByKeyFuncCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    void (*keyFunc) (const void *item, void *key), size_t keySize,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType,
+    size_t *order)
+{
+    size_t *myOrder;
+    key_source_t source;
+    sort_error_t result;
+
+    if (0 == numItems)
+    {
+        return SORT_OK;
+    }
+
+    myOrder = order;
+
+    if (NULL == myOrder)
+    {
+        myOrder = (size_t *)ContextAlloc(ctx, numItems * sizeof(size_t));
+
+        if (NULL == myOrder)
+        {
+            return SORT_ERR_NOMEM;
+        }
+    }
+
+    source.base = list;
+    source.stride = itemSize;
+    source.keySize = keySize;
+    source.keyFunc = keyFunc;
+
+    result = FindOrder(ctx, &source, numItems, compareFunc, keyType,
+        myOrder);
+
+    if (SORT_OK == result)
+    {
+        result = ApplyPermutationCtx(ctx, &list, &itemSize, 1, numItems,
+            myOrder);
+    }
+
+    if (NULL == order)
+    {
+        ContextFree(ctx, myOrder, numItems * sizeof(size_t));
+    }
+
+    return result;
+}
+
+/***************************************************************************
+*   Function   : ApplyPermutation
+*   Description: This function puts columns into the order found by an
+*                earlier sort using scratch memory from the heap.  See
+*                ApplyPermutationCtx.
+*   Parameters : columns - array of numColumns columns to reorder
+*                itemSizes - size of an item in each column
+*                numColumns - number of columns
+*                numItems - number of items in each column
+*                order - the original index of each item in its new order
+*   Effects    : Item i of each column becomes the original item order[i]
+*   Returned   : NONE
+***************************************************************************/
+void ApplyPermutation(void *const *columns, const size_t *itemSizes,
+    size_t numColumns, size_t numItems, const size_t *order)
+{
+    sort_error_t result;
+
+    result = ApplyPermutationCtx(NULL, columns, itemSizes, numColumns,
+        numItems, order);
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : ApplyPermutationCtx
+*   Description: This function puts columns into the order found by an
+*                earlier sort.  Each column is gathered into a copy in the
+*                new order, and the copies are written back.  The gather
+*                is blocked: a block of order small enough to stay in the
+*                level 1 cache is used for every column before moving on
+*                to the next block, so order is only read from memory
+*                once no matter how many columns there are.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                columns - array of numColumns columns to reorder
+*                itemSizes - size of an item in each column
+*                numColumns - number of columns
+*                numItems - number of items in each column
+*                order - the original index of each item in its new order.
+*                        It must hold each index from 0 to numItems - 1.
+*   Effects    : Item i of each column becomes the original item order[i]
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available (the columns are unchanged).
+***************************************************************************/
+sort_error_t ApplyPermutationCtx(sort_context_t *ctx,
+    void *const *columns, const size_t *itemSizes, size_t numColumns,
+    size_t numItems, const size_t *order)
+{
+    size_t rowBytes, blockItems, block, end, i, col;
+    char *copy, *dst;
+
+    if ((numItems <= 1) || (0 == numColumns))
+    {
+        return SORT_OK;
+    }
+
+    rowBytes = 0;
+
+    for (col = 0; col < numColumns; col++)
+    {
+        rowBytes += itemSizes[col];
+    }
+
+    copy = (char *)ContextAlloc(ctx, numItems * rowBytes);
+
+    if (NULL == copy)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    blockItems = sortTuning.l1dCacheBytes / (2 * sizeof(size_t));
+
+    if (0 == blockItems)
+    {
+        blockItems = 1;
+    }
+
+    /* gather a block of every column at a time */
+    for (block = 0; block < numItems; block += blockItems)
+    {
+        end = block + blockItems;
+
+        if (end > numItems)
+        {
+            end = numItems;
+        }
+
+        dst = copy;
+
+        for (col = 0; col < numColumns; col++)
+        {
+            for (i = block; i < end; i++)
+            {
+                CopyItem(dst + (i * itemSizes[col]),
+                    VoidPtrOffset(columns[col], order[i] * itemSizes[col]),
+                    itemSizes[col]);
+            }
+
+            dst += numItems * itemSizes[col];
+        }
+    }
+
+    /* write the copies back */
+    dst = copy;
+
+    for (col = 0; col < numColumns; col++)
+    {
+        CopyItems(columns[col], dst, numItems, itemSizes[col]);
+        dst += numItems * itemSizes[col];
+    }
+
+    ContextFree(ctx, copy, numItems * rowBytes);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : FindOrder
+*   Description: This function finds the order that sorts a column of keys
+*                without moving the keys.  Numeric keys are mapped with
+*                RadixKey and radix sorted along with their indices.  Other
+*                keys are copied into records followed by their indices and
+*                sorted with NaturalMergeSortCtx, which calls compareFunc
+*                with pointers to the copies.  Keys computed by a keyFunc
+*                are written straight into the radix or merge sort records.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                source - where to get each key
+*                numItems - number of keys
+*                compareFunc - a comparison function for keys (NULL if the
+*                              keys may be radix sorted)
+*                keyType - type of numeric key, SORT_KEY_NONE for others
+*                order - array receiving the original index of each key in
+*                        sorted order
+*   Effects    : order is written
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available, SORT_ERR_PARAM if keySize isn't the
+*                size of a keyType key, or the keys can't be radix sorted
+*                and there's no compareFunc.
+***************************************************************************/
+static sort_error_t FindOrder(sort_context_t *ctx,
+    const key_source_t *source, size_t numItems,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType,
+    size_t *order)
+{
+    radix_record_t *radix;
+    record_align_t keyCopy;     /* a computed numeric key */
+    const void *key;
+    char *records;
+    size_t recordSize, indexOffset, i;
+    sort_error_t result;
+
+    if ((SORT_KEY_NONE != keyType) && (0 != RadixKeySize(keyType)))
+    {
+        if (source->keySize != RadixKeySize(keyType))
+        {
+            /* RadixKey and keyCopy only hold a native sized key */
+            return SORT_ERR_PARAM;
+        }
+
+        radix = (radix_record_t *)ContextAlloc(ctx,
+            numItems * sizeof(radix_record_t));
+
+        if (NULL == radix)
+        {
+            return SORT_ERR_NOMEM;
+        }
+
+        for (i = 0; i < numItems; i++)
+        {
+            key = VoidPtrOffset(source->base, i * source->stride);
+
+            if (NULL != source->keyFunc)
+            {
+                source->keyFunc(key, &keyCopy);
+                key = &keyCopy;
+            }
+
+            radix[i].key = RadixKey(key, keyType);
+            radix[i].index = i;
+        }
+
+        result = RadixSortNumericCtx(ctx, radix, numItems,
+            sizeof(radix_record_t), 0, SORT_KEY_ULONG);
+
+        for (i = 0; (SORT_OK == result) && (i < numItems); i++)
+        {
+            order[i] = radix[i].index;
+        }
+
+        ContextFree(ctx, radix, numItems * sizeof(radix_record_t));
+        return result;
+    }
+
+    if (NULL == compareFunc)
+    {
+        return SORT_ERR_PARAM;
+    }
+
+    /* the key comes first, so compareFunc may be passed a record */
+    indexOffset = RoundUpAlign(source->keySize);
+    recordSize = RoundUpAlign(indexOffset + sizeof(size_t));
+    records = (char *)ContextAlloc(ctx, numItems * recordSize);
+
+    if (NULL == records)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    for (i = 0; i < numItems; i++)
+    {
+        key = VoidPtrOffset(source->base, i * source->stride);
+
+        if (NULL == source->keyFunc)
+        {
+            memcpy(records + (i * recordSize), key, source->keySize);
+        }
+        else
+        {
+            source->keyFunc(key, records + (i * recordSize));
+        }
+
+        memcpy(records + (i * recordSize) + indexOffset, &i, sizeof(size_t));
+    }
+
+    result = NaturalMergeSortCtx(ctx, records, numItems, recordSize,
+        compareFunc);
+
+    for (i = 0; (SORT_OK == result) && (i < numItems); i++)
+    {
+        memcpy(&order[i], records + (i * recordSize) + indexOffset,
+            sizeof(size_t));
+    }
+
+    ContextFree(ctx, records, numItems * recordSize);
+    return result;
+}
@@ -0,0 +1,600 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortmerge.c
+*   Purpose : This module implements MergeK, which merges any number of
+*             sorted lists into one sorted list using a loser tree
+*             (tournament tree).  Each node of the tree remembers the list
+*             that lost the match played there, so after the winning item
+*             is output only the matches on the path from its list to the
+*             root are replayed.  Each item output costs about log2(k)
+*             comparisons.  The tree may also be used by the other modules
+*             to merge runs a few items at a time.
+*
+*             This module also implements BlockMergeSort, a merge sort
+*             that sorts tiles small enough to stay in the level 2 cache
+*             and then merges the tiles with loser trees.  Each merge
+*             handles thousands of tiles at a time, so a list that is much
+*             larger than the cache is only read from and written to
+*             memory two or three times, instead of once for each of the
+*             log2(N) levels of an ordinary merge sort.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <assert.h>
+#include <stdlib.h>
+#include "sort.h"
+#include "sortint.h"
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* bytes of each list being merged that should fit in the level 2 cache */
+#define MERGE_LIST_BYTES    256
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+struct loser_tree_t
+{
+    size_t numLists;            /* number of lists being merged */
+    size_t itemSize;            /* size of each item */
+    int (*compareFunc) (const void *, const void *);
+    const char **heads;         /* next item of each list */
+    size_t *remaining;          /* items left in each list */
+    size_t *nodes;              /* loser of each match, winner in node 0 */
+    sort_context_t *ctx;        /* context the memory came from, or NULL */
+};
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static bool_t Beats(const loser_tree_t *tree, size_t a, size_t b);
+static bool_t MergePass(sort_context_t *ctx, const char *src, char *dst,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t runItems,
+    size_t fanout, const void **lists, size_t *counts);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : MergeK
+*   Description: This function merges numLists sorted lists into a single
+*                sorted list.  The merge is stable; items that are ordered
+*                the same are output in the order of the lists they came
+*                from, and in their original order within a list.
+*   Parameters : lists - array of pointers to the sorted lists
+*                numItems - array with the number of items in each list
+*                numLists - number of lists to merge
+*                itemSize - size of each item
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                output - array large enough for all of the items, or NULL
+*                         to have one allocated (free it with free).  It
+*                         may not overlap any of the lists.
+*   Effects    : The merged items are written to the output array
+*   Returned   : Pointer to the output array, NULL if memory couldn't be
+*                allocated.
+***************************************************************************/
+void *MergeK(const void *const *lists, const size_t *numItems,
+    size_t numLists, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), void *output)
+{
+    loser_tree_t *tree;
+    size_t total, i;
+    void *allocated;
+
+    total = 0;
+
+    for (i = 0; i < numLists; i++)
+    {
+        total += numItems[i];
+    }
+
+    allocated = NULL;
+
+    if (NULL == output)
+    {
+        /* allocate at least one item so success isn't mistaken for failure */
+        allocated = malloc(((0 == total) ? 1 : total) * itemSize);
+
+        if (NULL == allocated)
+        {
+            return NULL;
+        }
+
+        output = allocated;
+    }
+
+    if (0 == total)
+    {
+        return output;
+    }
+
+    tree = LoserTreeCreate(NULL, lists, numItems, numLists, itemSize,
+        compareFunc);
+
+    if (NULL == tree)
+    {
+        free(allocated);
+        return NULL;
+    }
+
+    LoserTreePop(tree, output, total);
+    LoserTreeFree(tree);
+
+    return output;
+}
+
+/***************************************************************************
+*   Function   : BlockMergeSort
+*   Description: This function performs a cache blocked merge sort on an
+*                array of items using scratch memory from the heap.  See
+*                BlockMergeSortCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void BlockMergeSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sort_error_t result;
+
+    result = BlockMergeSortCtx(NULL, list, numItems, itemSize, compareFunc);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : BlockMergeSortCtx
+*   Description: This function performs a cache blocked merge sort on an
+*                array of items.  The list is divided into tiles of
+*                sortTuning.mergeBlockBytes, and each tile is merge sorted
+*                while it's in the cache, using the start of the buffer.
+*                Then passes of multiway merges with a loser tree combine
+*                up to a fanout of sorted runs into one, moving the list
+*                between itself and the buffer, until one run is left.
+*                The fanout is chosen so that the head of every run being
+*                merged fits in the level 2 cache.  The sort is stable.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t BlockMergeSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    char *buffer, *src, *dst, *swap;
+    void *temp;
+    const void **lists;
+    size_t *counts;
+    size_t tileItems, runItems, fanout, i;
+    sort_error_t result;
+
+    if (SortIsSorted(list, numItems, itemSize, compareFunc))
+    {
+        /* singleton and already sorted lists need no work */
+        return SORT_OK;
+    }
+
+    tileItems = sortTuning.mergeBlockBytes / itemSize;
+
+    if (tileItems < 2)
+    {
+        tileItems = 2;
+    }
+
+    fanout = sortTuning.l2CacheBytes / MERGE_LIST_BYTES;
+
+    if (fanout < 2)
+    {
+        fanout = 2;
+    }
+
+    if (numItems <= tileItems)
+    {
+        /* the list fits in one tile, there's nothing to merge */
+        return MergeSortCtx(ctx, list, numItems, itemSize, compareFunc);
+    }
+
+    buffer = (char *)ContextAlloc(ctx, numItems * itemSize);
+
+    if (NULL == buffer)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    temp = ContextAlloc(ctx, itemSize);
+    lists = (const void **)ContextAlloc(ctx, fanout * sizeof(void *));
+    counts = (size_t *)ContextAlloc(ctx, fanout * sizeof(size_t));
+
+    if ((NULL == temp) || (NULL == lists) || (NULL == counts))
+    {
+        ContextFree(ctx, counts, fanout * sizeof(size_t));
+        ContextFree(ctx, lists, fanout * sizeof(void *));
+        ContextFree(ctx, temp, itemSize);
+        ContextFree(ctx, buffer, numItems * itemSize);
+        return SORT_ERR_NOMEM;
+    }
+
+    /* sort each tile while it's in the cache */
+    for (i = 0; i < numItems; i += tileItems)
+    {
+        runItems = ((numItems - i) < tileItems) ? (numItems - i) : tileItems;
+        MergeSortRecursive(VoidPtrOffset(list, (i * itemSize)), runItems,
+            itemSize, compareFunc, buffer, temp);
+    }
+
+    /* merge the runs, fanout at a time, until there's only one */
+    src = (char *)list;
+    dst = buffer;
+    result = SORT_OK;
+
+    for (runItems = tileItems; runItems < numItems; runItems *= fanout)
+    {
+        if (!MergePass(ctx, src, dst, numItems, itemSize, compareFunc,
+            runItems, fanout, lists, counts))
+        {
+            result = SORT_ERR_NOMEM;
+            break;
+        }
+
+        swap = src;
+        src = dst;
+        dst = swap;
+
+        if (runItems > (numItems / fanout))
+        {
+            break;      /* the runs just merged cover the list */
+        }
+    }
+
+    if (src != (char *)list)
+    {
+        CopyItems(list, src, numItems, itemSize);
+    }
+
+    ContextFree(ctx, counts, fanout * sizeof(size_t));
+    ContextFree(ctx, lists, fanout * sizeof(void *));
+    ContextFree(ctx, temp, itemSize);
+    ContextFree(ctx, buffer, numItems * itemSize);
+    return result;
+}
+
+/***************************************************************************
+*   Function   : MergePass
+*   Description: This function merges each group of fanout adjacent sorted
+*                runs of src into one sorted run of dst.
+*   Parameters : ctx - context providing each loser tree, NULL for the heap
+*                src - array of sorted runs
+*                dst - array receiving the merged runs
+*                numItems - number of items in the arrays
+*                itemSize - size of each item
+*                compareFunc - function used to compare items
+*                runItems - number of items in each run of src (the last
+*                           run may be shorter)
+*                fanout - most runs to merge into one
+*                lists - array of fanout run pointers used for each merge
+*                counts - array of fanout run lengths used for each merge
+*   Effects    : dst holds sorted runs of fanout * runItems items
+*   Returned   : TRUE for success, FALSE if memory couldn't be allocated
+***************************************************************************/
+static bool_t MergePass(sort_context_t *ctx, const char *src, char *dst,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t runItems,
+    size_t fanout, const void **lists, size_t *counts)
+{
+    loser_tree_t *tree;
+    size_t first, next, total, numLists;
+
+    for (first = 0; first < numItems; first += total)
+    {
+        total = 0;
+
+        for (numLists = 0; numLists < fanout; numLists++)
+        {
+            next = first + total;
+
+            if (next >= numItems)
+            {
+                break;
+            }
+
+            lists[numLists] = src + (next * itemSize);
+            counts[numLists] = ((numItems - next) < runItems) ?
+                (numItems - next) : runItems;
+            total += counts[numLists];
+        }
+
+        if (1 == numLists)
+        {
+            /* a run with nothing to merge with is just copied */
+            CopyItems(dst + (first * itemSize), lists[0], total, itemSize);
+            continue;
+        }
+
+        tree = LoserTreeCreate(ctx, lists, counts, numLists, itemSize,
+            compareFunc);
+
+        if (NULL == tree)
+        {
+            return FALSE;
+        }
+
+        LoserTreePop(tree, dst + (first * itemSize), total);
+        LoserTreeFree(tree);
+    }
+
+    return TRUE;
+}
+
+/***************************************************************************
+*   Function   : LoserTreeCreate
+*   Description: This function builds a loser tree over a set of sorted
+*                lists.  The lists are read in place, so they must not
+*                change while the tree is in use.  The leaves of the tree
+*                are numbered numLists to (2 * numLists) - 1, and the
+*                parent of node n is node n / 2, so any number of lists may
+*                be merged.  The tree's memory is allocated from ctx in
+*                stack order, so other scratch memory taken from ctx while
+*                the tree is in use must be freed before the tree is.
+*   Parameters : ctx - context providing memory for the tree, NULL for the
+*                      heap
+*                lists - array of pointers to the sorted lists
+*                numItems - array with the number of items in each list
+*                numLists - number of lists
+*                itemSize - size of each item
+*                compareFunc - function used to compare items
+*   Effects    : Memory is allocated for the tree
+*   Returned   : Pointer to the tree, NULL on failure.
+***************************************************************************/
+loser_tree_t *LoserTreeCreate(sort_context_t *ctx,
+    const void *const *lists, const size_t *numItems, size_t numLists,
+    size_t itemSize, int (*compareFunc) (const void *, const void *))
+{
+    loser_tree_t *tree;
+    size_t *winners;
+    size_t i, a, b;
+
+    if (0 == numLists)
+    {
+        return NULL;
+    }
+
+    tree = (loser_tree_t *)ContextAlloc(ctx, sizeof(loser_tree_t));
+
+    if (NULL == tree)
+    {
+        return NULL;
+    }
+
+    tree->numLists = numLists;
+    tree->itemSize = itemSize;
+    tree->compareFunc = compareFunc;
+    tree->ctx = ctx;
+    tree->heads =
+        (const char **)ContextAlloc(ctx, numLists * sizeof(char *));
+    tree->remaining = (size_t *)ContextAlloc(ctx, numLists * sizeof(size_t));
+    tree->nodes = (size_t *)ContextAlloc(ctx, numLists * sizeof(size_t));
+    winners = (size_t *)ContextAlloc(ctx, 2 * numLists * sizeof(size_t));
+
+    if ((NULL == tree->heads) || (NULL == tree->remaining) ||
+        (NULL == tree->nodes) || (NULL == winners))
+    {
+        ContextFree(ctx, winners, 2 * numLists * sizeof(size_t));
+        LoserTreeFree(tree);
+        return NULL;
+    }
+
+    for (i = 0; i < numLists; i++)
+    {
+        tree->heads[i] = (const char *)lists[i];
+        tree->remaining[i] = numItems[i];
+        winners[numLists + i] = i;
+    }
+
+    /* play the first round of matches from the bottom up */
+    for (i = numLists - 1; i > 0; i--)
+    {
+        a = winners[2 * i];
+        b = winners[(2 * i) + 1];
+
+        if (Beats(tree, a, b))
+        {
+            winners[i] = a;
+            tree->nodes[i] = b;
+        }
+        else
+        {
+            winners[i] = b;
+            tree->nodes[i] = a;
+        }
+    }
+
+    tree->nodes[0] = (1 == numLists) ? 0 : winners[1];
+    ContextFree(ctx, winners, 2 * numLists * sizeof(size_t));
+
+    return tree;
+}
+
+/***************************************************************************
+*   Function   : LoserTreeFree
+*   Description: This function frees a loser tree, in the opposite order
+*                that its memory was allocated.  The lists are not
+*                affected.
+*   Parameters : tree - pointer to the tree
+*   Effects    : The tree's memory is freed
+*   Returned   : NONE
+***************************************************************************/
+void LoserTreeFree(loser_tree_t *tree)
+{
+    ContextFree(tree->ctx, tree->nodes, tree->numLists * sizeof(size_t));
+    ContextFree(tree->ctx, tree->remaining,
+        tree->numLists * sizeof(size_t));
+    ContextFree(tree->ctx, tree->heads, tree->numLists * sizeof(char *));
+    ContextFree(tree->ctx, tree, sizeof(loser_tree_t));
+}
+
+/***************************************************************************
+*   Function   : LoserTreePop
+*   Description: This function removes the next items in merged order from
+*                a loser tree.  After the winner is output, the matches
+*                between its list's new head and the losers on the path to
+*                the root are replayed.
+*   Parameters : tree - pointer to the tree
+*                output - array receiving the items
+*                maxItems - the most items to output
+*   Effects    : Up to maxItems items are copied to output
+*   Returned   : The number of items output, less than maxItems only when
+*                every list is empty.
+***************************************************************************/
+size_t LoserTreePop(loser_tree_t *tree, void *output, size_t maxItems)
+{
+    const char **heads;
+    const char *head;
+    size_t *remaining, *nodes;
+    size_t count, winner, node, loser, numLists, itemSize, left;
+    int (*compareFunc) (const void *, const void *);
+    int result;
+    char *dst;
+
+    /* local copies, so they aren't reloaded after every comparison */
+    heads = tree->heads;
+    remaining = tree->remaining;
+    nodes = tree->nodes;
+    numLists = tree->numLists;
+    itemSize = tree->itemSize;
+    compareFunc = tree->compareFunc;
+    dst = (char *)output;
+
+    for (count = 0; count < maxItems; count++)
+    {
+        winner = nodes[0];
+
+        if (0 == remaining[winner])
+        {
+            break;      /* the best list is empty, so they all are */
+        }
+
+        CopyItem(dst, heads[winner], itemSize);
+        dst += itemSize;
+        heads[winner] += itemSize;
+        remaining[winner]--;
+        head = heads[winner];
+        left = remaining[winner];
+
+        /* replay the winner's path, the new winner moves up (see Beats) */
+        for (node = (winner + numLists) / 2; node > 0; node /= 2)
+        {
+            loser = nodes[node];
+
+            if (0 == remaining[loser])
+            {
+                continue;       /* an empty list can't win */
+            }
+
+            if (0 != left)
+            {
+                result = CompareItems(compareFunc, heads[loser], head);
+
+                if ((result > 0) || ((0 == result) && (loser > winner)))
+                {
+                    continue;   /* the winner stays the winner */
+                }
+            }
+
+            nodes[node] = winner;
+            winner = loser;
+            head = heads[winner];
+            left = remaining[winner];
+        }
+
+        nodes[0] = winner;
+    }
+
+    return count;
+}
+
+/***************************************************************************
+*   Function   : Beats
+*   Description: This function decides the winner of a match between the
+*                heads of two lists.  An empty list loses to any list with
+*                items.  Items that are ordered the same are won by the
+*                list with the lower index, which keeps merges stable.
+*   Parameters : tree - pointer to the tree
+*                a - index of a list
+*                b - index of another list
+*   Effects    : NONE
+*   Returned   : TRUE if list a wins, otherwise FALSE.
+***************************************************************************/
+static bool_t Beats(const loser_tree_t *tree, size_t a, size_t b)
+{
+    int result;
+
+    if (0 == tree->remaining[a])
+    {
+        return ((0 == tree->remaining[b]) && (a < b)) ? TRUE : FALSE;
+    }
+
+    if (0 == tree->remaining[b])
+    {
+        return TRUE;
+    }
+
+    result = CompareItems(tree->compareFunc, tree->heads[a], tree->heads[b]);
+    return ((result < 0) || ((0 == result) && (a < b))) ? TRUE : FALSE;
+}
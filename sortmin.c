@@ -0,0 +1,795 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortmin.c
+*   Purpose : This module implements a sort that makes as few comparisons
+*             as it reasonably can, for comparison functions that are much
+*             more expensive than moving items (collation, decoding
+*             compressed fields, etc.).  Blocks of up to 32 items are sorted
+*             with Ford and Johnson's merge-insertion, which comes within a
+*             few comparisons of the log2(N!) lower bound, and the blocks
+*             are merged with Hwang and Lin's binary merge, which makes
+*             about as many comparisons as a linear merge when the runs are
+*             the same length and about M * log2(N / M) when a run of M
+*             items is merged with a much longer run of N items.  Items
+*             that are already in order are kept as runs instead of being
+*             sorted again.  Ties are broken by position, so the sort is
+*             stable.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "sort.h"
+#include "sortint.h"
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* most items sorted by merge-insertion before merging */
+#define BLOCK_ITEMS         32
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* a block being sorted by merge-insertion */
+typedef struct
+{
+    const char *items;          /* the block's items */
+    size_t itemSize;            /* size of each item */
+    int (*compareFunc) (const void *, const void *);
+} block_t;
+
+/* a sorted run waiting to be merged */
+typedef struct
+{
+    size_t first;               /* index of the run's first item */
+    bool_t natural;             /* some of the run was already in order */
+} run_t;
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static size_t RunEnd(const char *list, size_t first, size_t numItems,
+    size_t itemSize, int (*compareFunc) (const void *, const void *));
+static int Precedes(const block_t *block, size_t a, size_t b);
+static void MergeInsertion(const block_t *block, size_t *order,
+    size_t numItems);
+static void BinaryInsert(const block_t *block, size_t *chain,
+    size_t *chainLength, size_t bound, size_t item);
+static void HwangLinMerge(const char *left, size_t numLeft,
+    const char *right, size_t numRight, char *output, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), bool_t gallop);
+static size_t LeadingBefore(const char *run, size_t numItems,
+    const char *key, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+static size_t TrailingAfter(const char *run, size_t numItems,
+    const char *key, size_t itemSize,
+    int (*compareFunc) (const void *, const void *));
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : MinCompareSort
+*   Description: This function is a wrapper for MinCompareSortCtx that
+*                takes its scratch memory from the heap.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void MinCompareSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sort_error_t result;
+
+    result = MinCompareSortCtx(NULL, list, numItems, itemSize, compareFunc);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : MinCompareSortCtx
+*   Description: This function divides a list into runs and merges them.
+*                At least BLOCK_ITEMS items that are already in ascending
+*                order form a run, so the comparisons that find the run
+*                aren't wasted.  Where the order ends sooner, a block of
+*                BLOCK_ITEMS items is sorted by merge-insertion instead.
+*                If the item after a block follows its last item, the
+*                items in order from there (if there are enough for a run)
+*                extend the block's run.  The runs are copied to a buffer,
+*                then pairs of runs are merged back and forth between the
+*                buffer and the list until there's only one.  If the last
+*                pass leaves the items in the buffer, they're copied back.
+*   Parameters : ctx - sort context for scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                isn't available.
+***************************************************************************/
+sort_error_t MinCompareSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    char *src, *dst, *swap, *buffer;
+    size_t order[BLOCK_ITEMS];
+    run_t *runs;                /* the runs, then one starting at numItems */
+    size_t numRuns, maxRuns, first, end, count, i, j;
+    bool_t haveRun;             /* list[first .. end) is in order */
+    bool_t follows;             /* list[first] follows the last run */
+    block_t block;
+
+    if (numItems < 2)
+    {
+        /* singleton lists are already sorted */
+        return SORT_OK;
+    }
+
+    end = RunEnd((char *)list, 0, numItems, itemSize, compareFunc);
+
+    if (numItems == end)
+    {
+        /* the whole list is one run */
+        return SORT_OK;
+    }
+
+    buffer = (char *)ContextAlloc(ctx, numItems * itemSize);
+
+    if (NULL == buffer)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    /* every run but the last has at least BLOCK_ITEMS items */
+    maxRuns = (numItems / BLOCK_ITEMS) + 1;
+    runs = (run_t *)ContextAlloc(ctx, (maxRuns + 1) * sizeof(run_t));
+
+    if (NULL == runs)
+    {
+        ContextFree(ctx, buffer, numItems * itemSize);
+        return SORT_ERR_NOMEM;
+    }
+
+    block.itemSize = itemSize;
+    block.compareFunc = compareFunc;
+
+    /* copy the runs to the buffer, sorting blocks where there's no order */
+    numRuns = 0;
+    first = 0;
+    haveRun = TRUE;
+    follows = FALSE;
+
+    while (first < numItems)
+    {
+        if (haveRun && (((end - first) >= BLOCK_ITEMS) || (numItems == end)))
+        {
+            if (!follows)
+            {
+                runs[numRuns].first = first;
+                numRuns++;
+            }
+
+            runs[numRuns - 1].natural = TRUE;
+            CopyItems(buffer + (first * itemSize),
+                (char *)list + (first * itemSize), end - first, itemSize);
+            first = end;
+            follows = FALSE;
+
+            if (first < numItems)
+            {
+                end = RunEnd((char *)list, first, numItems, itemSize,
+                    compareFunc);
+            }
+
+            continue;
+        }
+
+        count = numItems - first;
+
+        if (count > BLOCK_ITEMS)
+        {
+            count = BLOCK_ITEMS;
+        }
+
+        block.items = (char *)list + (first * itemSize);
+
+        for (i = 0; i < count; i++)
+        {
+            order[i] = i;
+        }
+
+        MergeInsertion(&block, order, count);
+
+        for (i = 0; i < count; i++)
+        {
+            CopyItem(buffer + ((first + i) * itemSize),
+                block.items + (order[i] * itemSize), itemSize);
+        }
+
+        runs[numRuns].first = first;
+        runs[numRuns].natural = FALSE;
+        numRuns++;
+        first += count;
+
+        /* items that follow the block in order may extend its run */
+        follows = (first < numItems) &&
+            (CompareItems(compareFunc, buffer + ((first - 1) * itemSize),
+                (char *)list + (first * itemSize)) <= 0);
+        haveRun = follows;
+
+        if (follows)
+        {
+            end = RunEnd((char *)list, first, numItems, itemSize,
+                compareFunc);
+        }
+    }
+
+    runs[numRuns].first = numItems;
+    src = buffer;
+    dst = (char *)list;
+
+    while (numRuns > 1)
+    {
+        for (i = 0, j = 0; i < numRuns; i += 2, j++)
+        {
+            first = runs[i].first;
+            runs[j] = runs[i];
+
+            if (i + 1 == numRuns)
+            {
+                /* a run without a partner */
+                CopyItems(dst + (first * itemSize), src + (first * itemSize),
+                    numItems - first, itemSize);
+                break;
+            }
+
+            HwangLinMerge(src + (first * itemSize), runs[i + 1].first - first,
+                src + (runs[i + 1].first * itemSize),
+                runs[i + 2].first - runs[i + 1].first,
+                dst + (first * itemSize), itemSize, compareFunc,
+                runs[i].natural || runs[i + 1].natural);
+            runs[j].natural = runs[i].natural || runs[i + 1].natural;
+        }
+
+        numRuns = (numRuns + 1) / 2;
+        runs[numRuns].first = numItems;
+
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src == buffer)
+    {
+        CopyItems(list, buffer, numItems, itemSize);
+    }
+
+    ContextFree(ctx, runs, (maxRuns + 1) * sizeof(run_t));
+    ContextFree(ctx, buffer, numItems * itemSize);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : RunEnd
+*   Description: This function finds the end of the run of items in
+*                ascending order that starts at list[first].
+*   Parameters : list - a pointer of an array of items
+*                first - index of the first item of the run
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function (see MinCompareSort)
+*   Effects    : NONE
+*   Returned   : Index of the first item after the run.
+***************************************************************************/
+static size_t RunEnd(const char *list, size_t first, size_t numItems,
+    size_t itemSize, int (*compareFunc) (const void *, const void *))
+{
+    const char *item;
+
+    item = list + (first * itemSize);
+
+    for (first++; first < numItems; first++)
+    {
+        if (CompareItems(compareFunc, item, item + itemSize) > 0)
+        {
+            break;
+        }
+
+        item += itemSize;
+    }
+
+    return first;
+}
+
+/***************************************************************************
+*   Function   : Precedes
+*   Description: This function compares two items of a block.  Items that
+*                are ordered the same are ordered by their position, so
+*                merge-insertion keeps them in their original order.
+*   Parameters : block - the block
+*                a, b - positions of the items in the block
+*   Effects    : NONE
+*   Returned   : Non-zero if item a goes before item b.
+***************************************************************************/
+static int Precedes(const block_t *block, size_t a, size_t b)
+{
+    int result;
+
+    result = CompareItems(block->compareFunc,
+        block->items + (a * block->itemSize),
+        block->items + (b * block->itemSize));
+
+    return ((result < 0) || ((0 == result) && (a < b))) ? 1 : 0;
+}
+
+/***************************************************************************
+*   Function   : MergeInsertion
+*   Description: This function sorts the positions of a block's items with
+*                Ford and Johnson's merge-insertion.  The items are paired
+*                and each pair is compared.  The larger items of the pairs
+*                are sorted recursively to start a chain.  The smaller item
+*                of the smallest pair goes in front of the chain for free,
+*                and the rest are binary inserted in groups whose sizes
+*                follow the Jacobsthal numbers (2, 2, 6, 10, 22, ...), last
+*                to first within each group.  Every item of a group is then
+*                inserted into a part of the chain shorter than a power of
+*                two, so no comparison is wasted.
+*   Parameters : block - the block
+*                order - positions of the items to sort, sorted on return
+*                numItems - number of positions (at most BLOCK_ITEMS)
+*   Effects    : order is sorted by the items at its positions
+*   Returned   : NONE
+***************************************************************************/
+static void MergeInsertion(const block_t *block, size_t *order,
+    size_t numItems)
+{
+    size_t partner[BLOCK_ITEMS];        /* smaller item paired with each */
+    size_t chain[BLOCK_ITEMS];
+    size_t chainLength, numPairs, numInserts, i, temp;
+    size_t previous, last, power, bound;
+
+    if (numItems < 2)
+    {
+        return;
+    }
+
+    /* the larger item of each pair goes first */
+    numPairs = numItems / 2;
+
+    for (i = 0; i < numPairs; i++)
+    {
+        if (Precedes(block, order[i], order[i + numPairs]))
+        {
+            temp = order[i];
+            order[i] = order[i + numPairs];
+            order[i + numPairs] = temp;
+        }
+
+        partner[order[i]] = order[i + numPairs];
+    }
+
+    MergeInsertion(block, order, numPairs);
+
+    /* b1 < a1 < a2 < ... */
+    chain[0] = partner[order[0]];
+
+    for (i = 0; i < numPairs; i++)
+    {
+        chain[i + 1] = order[i];
+    }
+
+    chainLength = numPairs + 1;
+
+    /* b(k) for k = 2 .. numPairs is bounded by a(k), and b(numPairs + 1)
+     * is the unpaired item of an odd block.  The groups end at the
+     * Jacobsthal numbers t(k) = 2 ^ k - t(k - 1): 3, 5, 11, 21, ... */
+    numInserts = numPairs + (numItems % 2);
+    previous = 1;
+    power = 4;
+
+    while (previous < numInserts)
+    {
+        last = power - previous;
+
+        if (last > numInserts)
+        {
+            last = numInserts;
+        }
+
+        for (i = last; i > previous; i--)
+        {
+            if (i <= numPairs)
+            {
+                /* b(i) goes in front of a(i) */
+                for (bound = 0; chain[bound] != order[i - 1]; bound++)
+                {
+                }
+
+                BinaryInsert(block, chain, &chainLength, bound,
+                    partner[order[i - 1]]);
+            }
+            else
+            {
+                BinaryInsert(block, chain, &chainLength, chainLength,
+                    order[numItems - 1]);
+            }
+        }
+
+        previous = last;
+        power *= 2;
+    }
+
+    memcpy(order, chain, numItems * sizeof(size_t));
+}
+
+/***************************************************************************
+*   Function   : BinaryInsert
+*   Description: This function inserts an item into the chain of sorted
+*                items of a merge-insertion, searching only the part of
+*                the chain that the item is known to go before.
+*   Parameters : block - the block
+*                chain - positions of the sorted items
+*                chainLength - number of positions in chain, incremented
+*                bound - the item goes before chain[bound]
+*                item - position of the item to insert
+*   Effects    : item is inserted into chain in sorted order
+*   Returned   : NONE
+***************************************************************************/
+static void BinaryInsert(const block_t *block, size_t *chain,
+    size_t *chainLength, size_t bound, size_t item)
+{
+    size_t low, high, middle;
+
+    low = 0;
+    high = bound;
+
+    while (low < high)
+    {
+        middle = low + ((high - low) / 2);
+
+        if (Precedes(block, item, chain[middle]))
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+
+    memmove(chain + low + 1, chain + low,
+        (*chainLength - low) * sizeof(size_t));
+    chain[low] = item;
+    (*chainLength)++;
+}
+
+/***************************************************************************
+*   Function   : HwangLinMerge
+*   Description: This function merges two sorted runs with Hwang and Lin's
+*                binary merge, filling the output from its end.  When the
+*                left run has M items and the right run has N >= M, the
+*                last left item is compared with the right item 2 ^ t from
+*                the end, where t = floor(log2(N / M)).  If the right item
+*                isn't smaller, it and the 2 ^ t - 1 items after it are
+*                output at once; otherwise a binary search of those items
+*                finds where the left item goes.  The same is done with the
+*                runs' roles swapped when the left run is longer.  Runs
+*                that are already in order cost one comparison.  If gallop
+*                is set, the left items that go before the first right item
+*                and the right items that go after the last left item are
+*                found by galloping first, so runs that only overlap near
+*                where they meet cost a few comparisons more.  That wastes
+*                a few comparisons when the runs are interleaved, so it's
+*                only done for runs that were partly in order to start
+*                with.  Items of the left run go first when items are
+*                ordered the same.
+*   Parameters : left - the left run
+*                numLeft - number of items in the left run
+*                right - the right run
+*                numRight - number of items in the right run
+*                output - receives numLeft + numRight merged items
+*                itemSize - size of each item
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                gallop - TRUE to gallop over items already in place
+*   Effects    : output holds the merged runs
+*   Returned   : NONE
+***************************************************************************/
+static void HwangLinMerge(const char *left, size_t numLeft,
+    const char *right, size_t numRight, char *output, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), bool_t gallop)
+{
+    size_t tail, step, first, low, high, middle;
+    const char *key;
+
+    if (CompareItems(compareFunc, left + ((numLeft - 1) * itemSize),
+        right) <= 0)
+    {
+        CopyItems(output, left, numLeft, itemSize);
+        CopyItems(output + (numLeft * itemSize), right, numRight, itemSize);
+        return;
+    }
+
+    if (gallop)
+    {
+        /* left items before right[0] are already in place */
+        first = LeadingBefore(left, numLeft, right, itemSize, compareFunc);
+        CopyItems(output, left, first, itemSize);
+        left += first * itemSize;
+        numLeft -= first;
+        output += first * itemSize;
+
+        /* so are the right items after the last left item */
+        first = numRight - TrailingAfter(right, numRight,
+            left + ((numLeft - 1) * itemSize), itemSize, compareFunc);
+        CopyItems(output + ((numLeft + first) * itemSize),
+            right + (first * itemSize), numRight - first, itemSize);
+        numRight = first;
+    }
+
+    tail = numLeft + numRight;
+
+    while ((numLeft > 0) && (numRight > 0))
+    {
+        if (numLeft <= numRight)
+        {
+            for (step = 1; (2 * step * numLeft) <= numRight; step *= 2)
+            {
+            }
+
+            first = numRight - step;
+            key = left + ((numLeft - 1) * itemSize);
+
+            if (CompareItems(compareFunc, key,
+                right + (first * itemSize)) > 0)
+            {
+                /* find the first of the right items after first that
+                 * isn't smaller than key */
+                low = first + 1;
+                high = numRight;
+
+                while (low < high)
+                {
+                    middle = low + ((high - low) / 2);
+
+                    if (CompareItems(compareFunc,
+                        right + (middle * itemSize), key) < 0)
+                    {
+                        low = middle + 1;
+                    }
+                    else
+                    {
+                        high = middle;
+                    }
+                }
+
+                first = low;
+                numLeft--;
+            }
+
+            tail -= numRight - first;
+            CopyItems(output + (tail * itemSize), right + (first * itemSize),
+                numRight - first, itemSize);
+            numRight = first;
+
+            if (tail > numLeft + numRight)
+            {
+                /* the left item whose place was found */
+                tail--;
+                CopyItem(output + (tail * itemSize), key, itemSize);
+            }
+        }
+        else
+        {
+            for (step = 1; (2 * step * numRight) <= numLeft; step *= 2)
+            {
+            }
+
+            first = numLeft - step;
+            key = right + ((numRight - 1) * itemSize);
+
+            if (CompareItems(compareFunc, left + (first * itemSize),
+                key) <= 0)
+            {
+                /* find the first of the left items after first that
+                 * is larger than key */
+                low = first + 1;
+                high = numLeft;
+
+                while (low < high)
+                {
+                    middle = low + ((high - low) / 2);
+
+                    if (CompareItems(compareFunc,
+                        left + (middle * itemSize), key) <= 0)
+                    {
+                        low = middle + 1;
+                    }
+                    else
+                    {
+                        high = middle;
+                    }
+                }
+
+                first = low;
+                numRight--;
+            }
+
+            tail -= numLeft - first;
+            CopyItems(output + (tail * itemSize), left + (first * itemSize),
+                numLeft - first, itemSize);
+            numLeft = first;
+
+            if (tail > numLeft + numRight)
+            {
+                /* the right item whose place was found */
+                tail--;
+                CopyItem(output + (tail * itemSize), key, itemSize);
+            }
+        }
+    }
+
+    /* the rest of one run is already in place at the front */
+    CopyItems(output, left, numLeft, itemSize);
+    CopyItems(output, right, numRight, itemSize);
+}
+
+/***************************************************************************
+*   Function   : LeadingBefore
+*   Description: This function gallops from the start of a run to count
+*                the items that go before key.  Items 0, 2, 6, 14, ... are
+*                compared with key until one goes after it, then a binary
+*                search finds the first such item between the last two
+*                compared.  Counting k items takes about 2 * log2(k)
+*                comparisons.  Items ordered the same as key go before it.
+*   Parameters : run - the sorted run
+*                numItems - number of items in the run
+*                key - the item being placed
+*                itemSize - size of each item
+*                compareFunc - a comparison function (see MinCompareSort)
+*   Effects    : NONE
+*   Returned   : Number of items at the start of run that go before key.
+***************************************************************************/
+static size_t LeadingBefore(const char *run, size_t numItems,
+    const char *key, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    size_t low, high, step, middle;
+
+    /* run[0 .. low) go before key, run[high] doesn't */
+    low = 0;
+    high = numItems;
+
+    for (step = 1; low + step <= numItems; step *= 2)
+    {
+        if (CompareItems(compareFunc,
+            run + ((low + step - 1) * itemSize), key) > 0)
+        {
+            high = low + step - 1;
+            break;
+        }
+
+        low += step;
+    }
+
+    while (low < high)
+    {
+        middle = low + ((high - low) / 2);
+
+        if (CompareItems(compareFunc, run + (middle * itemSize), key) > 0)
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+
+    return low;
+}
+
+/***************************************************************************
+*   Function   : TrailingAfter
+*   Description: This function gallops from the end of a run to count the
+*                items that go after key, the mirror of LeadingBefore.
+*                Items ordered the same as key go after it.
+*   Parameters : run - the sorted run
+*                numItems - number of items in the run
+*                key - the item being placed
+*                itemSize - size of each item
+*                compareFunc - a comparison function (see MinCompareSort)
+*   Effects    : NONE
+*   Returned   : Number of items at the end of run that go after key.
+***************************************************************************/
+static size_t TrailingAfter(const char *run, size_t numItems,
+    const char *key, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    size_t low, high, step, middle;
+
+    /* the last low items go after key, the last high + 1 don't */
+    low = 0;
+    high = numItems;
+
+    for (step = 1; low + step <= numItems; step *= 2)
+    {
+        if (CompareItems(compareFunc, key,
+            run + ((numItems - low - step) * itemSize)) > 0)
+        {
+            high = low + step - 1;
+            break;
+        }
+
+        low += step;
+    }
+
+    while (low < high)
+    {
+        middle = low + ((high - low) / 2);
+
+        if (CompareItems(compareFunc, key,
+            run + ((numItems - 1 - middle) * itemSize)) > 0)
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+
+    return low;
+}
@@ -0,0 +1,1199 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortpar.c
+*   Purpose : This module provides the threads and locks used by the
+*             parallel sorts.  POSIX threads are used where they are
+*             available.  The work of the parallel sorts is handed to a
+*             pool of worker threads that is started the first time it's
+*             needed and kept between sorts, so sorts don't pay to create
+*             threads.  The pool is sized by the processors the process
+*             may use, including any cgroup CPU quota, and its workers
+*             may be pinned to processors.  When the library is built
+*             with SORT_NO_THREADS
+*             (or for Windows), work meant for several threads is run one
+*             piece after another by the calling thread, background work
+*             is run when it's started, and locks do nothing.  The
+*             parallel sorts only hand threads work that may be completed
+*             in any order, so the results are the same.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+#if defined(_WIN32) && !defined(SORT_NO_THREADS)
+#define SORT_NO_THREADS
+#endif
+
+#ifndef SORT_NO_THREADS
+/* pthreads and sysconf are not declared in strict ANSI mode */
+#define _POSIX_C_SOURCE 200112L
+
+#ifdef __linux__
+/* CPU affinity is a GNU extension */
+#define _GNU_SOURCE
+#endif
+#endif
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sort.h"
+#include "sortint.h"
+
+#ifndef SORT_NO_THREADS
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+#endif
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+#ifndef SORT_NO_THREADS
+/* cgroup v2 CPU limits, "quota period" or "max period" */
+#define CGROUP_ROOT         "/sys/fs/cgroup"
+#define CGROUP_CPU_MAX      "/cpu.max"
+#define CGROUP_SELF         "/proc/self/cgroup"
+
+/* cgroup v1 CPU limits, quota is -1 if there's no limit */
+#define CGROUP_CFS_QUOTA    "/sys/fs/cgroup/cpu/cpu.cfs_quota_us"
+#define CGROUP_CFS_PERIOD   "/sys/fs/cgroup/cpu/cpu.cfs_period_us"
+
+#define CGROUP_PATH_LEN     512
+#endif
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+struct sort_lock_t
+{
+#ifndef SORT_NO_THREADS
+    pthread_mutex_t mutex;
+#else
+    int unused;
+#endif
+};
+
+/* a thread started by SortThreadStart */
+struct sort_thread_t
+{
+    void (*func)(void *arg);
+    void *arg;
+#ifndef SORT_NO_THREADS
+    pthread_t id;
+#endif
+#ifdef SORT_STATS
+    sort_stats_t stats;             /* the thread's statistics */
+    bool_t collect;                 /* TRUE if the starter collects them */
+#endif
+};
+
+#ifndef SORT_NO_THREADS
+/* what a thread started by SortRunThreads needs to know */
+typedef struct
+{
+    void (*func)(void *arg, unsigned int thread);
+    void *arg;
+    unsigned int thread;            /* index passed to func */
+    bool_t started;                 /* TRUE if the thread was created */
+    pthread_t id;
+#ifdef SORT_STATS
+    sort_stats_t *stats;            /* NULL if not collecting statistics */
+#endif
+} thread_start_t;
+
+/* a worker thread of the pool */
+typedef struct
+{
+    pthread_t id;
+    int cpu;                        /* processor to run on, -1 for any */
+    unsigned long generation;       /* last job the worker has seen */
+#ifdef SORT_STATS
+    bool_t busy;                    /* TRUE if it made calls for the job */
+    sort_stats_t stats;             /* statistics of the calls */
+#endif
+} pool_worker_t;
+
+/***************************************************************************
+* Threads kept between sorts to make the calls of SortRunThreads.  The
+* thread that owns the pool posts a job and makes calls along with the
+* workers.  Each call is claimed by whichever thread gets to it first, so
+* a job finishes even if the workers are slow to wake.
+***************************************************************************/
+typedef struct
+{
+    pool_worker_t *workers;
+    unsigned int numWorkers;
+    bool_t running;                 /* TRUE if the workers were started */
+    bool_t stopping;                /* TRUE when the workers should exit */
+    unsigned long generation;       /* incremented for each job */
+    void (*func)(void *arg, unsigned int thread);
+    void *arg;
+    unsigned int numCalls;          /* calls to make for the job */
+    unsigned int nextCall;          /* next call to be claimed */
+    unsigned int callsDone;         /* calls that have returned */
+#ifdef SORT_STATS
+    bool_t collect;                 /* TRUE if collecting statistics */
+#endif
+} sort_pool_t;
+#endif
+
+/***************************************************************************
+*                            GLOBAL VARIABLES
+***************************************************************************/
+#ifndef SORT_NO_THREADS
+static sort_pool_t pool;
+
+/* held by the thread that is using, starting, or stopping the pool */
+static pthread_mutex_t poolOwner = PTHREAD_MUTEX_INITIALIZER;
+
+/* protects the pool's job */
+static pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t poolWake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t poolDone = PTHREAD_COND_INITIALIZER;
+
+/* the processors this process may use are only counted once */
+static pthread_once_t countOnce = PTHREAD_ONCE_INIT;
+static unsigned int processorCount;
+#endif
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+#ifndef SORT_NO_THREADS
+static void CountProcessors(void);
+static long CgroupCpuLimit(void);
+static long CgroupFileLimit(const char *fileName);
+static long ReadLong(const char *fileName);
+
+static bool_t PoolStart(unsigned int numThreads, unsigned int flags);
+static void PoolStop(void);
+static void PoolRun(unsigned int numCalls,
+    void (*func)(void *arg, unsigned int thread), void *arg);
+static void PoolMakeCalls(pool_worker_t *worker);
+static void *WorkerStart(void *arg);
+
+static void RunNewThreads(unsigned int numThreads,
+    void (*func)(void *arg, unsigned int thread), void *arg);
+static void *ThreadStart(void *arg);
+static void *BackgroundStart(void *arg);
+#endif
+
+#ifdef SORT_STATS
+static void StatMerge(const sort_stats_t *stats);
+#endif
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : SortDefaultThreads
+*   Description: This function returns the number of threads that the
+*                parallel sorts use when the caller doesn't specify one;
+*                the number of processors that this process may use.  That
+*                is the smallest of the number of processors online, the
+*                number in the process's affinity mask, and the processor
+*                time allowed by the process's cgroup CPU quota.  The
+*                count is only made once.
+*   Parameters : NONE
+*   Effects    : NONE
+*   Returned   : Number of threads (at least 1)
+***************************************************************************/
+unsigned int SortDefaultThreads(void)
+{
+#ifndef SORT_NO_THREADS
+    pthread_once(&countOnce, CountProcessors);
+    return processorCount;
+#else
+    return 1;
+#endif
+}
+
+/***************************************************************************
+*   Function   : SortPoolStart
+*   Description: This function starts the pool of worker threads used by
+*                the parallel sorts, stopping any pool that was already
+*                running.  The calling thread works along with the pool,
+*                so numThreads - 1 workers are started.  Calling this
+*                function is optional; the parallel sorts start a pool of
+*                SortDefaultThreads threads the first time they need one.
+*   Parameters : numThreads - threads in the pool, 0 for
+*                             SortDefaultThreads()
+*                flags - SORT_POOL_PIN_THREADS to keep each worker on its
+*                        own processor
+*   Effects    : Worker threads are started
+*   Returned   : 1 if every worker was started, otherwise 0.  The sorts
+*                run correctly either way.
+***************************************************************************/
+int SortPoolStart(unsigned int numThreads, unsigned int flags)
+{
+#ifndef SORT_NO_THREADS
+    bool_t started;
+
+    pthread_mutex_lock(&poolOwner);
+    PoolStop();
+    started = PoolStart(numThreads, flags);
+    pthread_mutex_unlock(&poolOwner);
+
+    return started;
+#else
+    (void)flags;
+    return (numThreads <= 1) ? TRUE : FALSE;
+#endif
+}
+
+/***************************************************************************
+*   Function   : SortPoolStop
+*   Description: This function stops the pool of worker threads used by
+*                the parallel sorts and waits for the workers to exit.  It
+*                must not be called while a sort is running.  The next
+*                parallel sort starts a new pool.
+*   Parameters : NONE
+*   Effects    : Worker threads exit and their memory is freed
+*   Returned   : NONE
+***************************************************************************/
+void SortPoolStop(void)
+{
+#ifndef SORT_NO_THREADS
+    pthread_mutex_lock(&poolOwner);
+    PoolStop();
+    pthread_mutex_unlock(&poolOwner);
+#endif
+}
+
+/***************************************************************************
+*   Function   : SortRunThreads
+*   Description: This function calls func once for each thread index from
+*                0 to numThreads - 1 and waits for all of the calls to
+*                return.  The calling thread makes the call for index 0,
+*                and the pool's workers and the calling thread make the
+*                rest.  If another thread is using the pool (or
+*                this call is made from a worker), new threads are created
+*                for the calls instead.  When statistics are being
+*                collected, the statistics of every thread are added to
+*                the caller's.
+*   Parameters : numThreads - number of calls to make
+*                func - function to call
+*                arg - argument passed to every call
+*   Effects    : func is called numThreads times
+*   Returned   : NONE
+***************************************************************************/
+void SortRunThreads(unsigned int numThreads,
+    void (*func)(void *arg, unsigned int thread), void *arg)
+{
+    unsigned int i;
+
+#ifndef SORT_NO_THREADS
+    if (numThreads > 1)
+    {
+        if (0 == pthread_mutex_trylock(&poolOwner))
+        {
+            if (!pool.running)
+            {
+                /* start the pool the first time it's needed */
+                PoolStart(0, 0);
+            }
+
+            if (pool.running)
+            {
+                PoolRun(numThreads, func, arg);
+                pthread_mutex_unlock(&poolOwner);
+                return;
+            }
+
+            pthread_mutex_unlock(&poolOwner);
+        }
+
+        RunNewThreads(numThreads, func, arg);
+        return;
+    }
+#endif
+
+    for (i = 0; i < numThreads; i++)
+    {
+        func(arg, i);
+    }
+}
+
+#ifndef SORT_NO_THREADS
+/***************************************************************************
+*   Function   : CountProcessors
+*   Description: This function counts the processors that this process may
+*                use for SortDefaultThreads.  It is called once.
+*   Parameters : NONE
+*   Effects    : processorCount is set (at least 1)
+*   Returned   : NONE
+***************************************************************************/
+static void CountProcessors(void)
+{
+    long count, limit;
+#ifdef __linux__
+    cpu_set_t cpus;
+#endif
+
+    count = 1;
+
+#ifdef _SC_NPROCESSORS_ONLN
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+#ifdef __linux__
+    if (0 == sched_getaffinity(0, sizeof(cpus), &cpus))
+    {
+        limit = CPU_COUNT(&cpus);
+
+        if ((limit > 0) && (limit < count))
+        {
+            count = limit;
+        }
+    }
+#endif
+
+    /* a quota of 2.5 processors keeps 3 threads busy part of the time */
+    limit = CgroupCpuLimit();
+
+    if ((limit > 0) && (limit < count))
+    {
+        count = limit;
+    }
+
+    processorCount = (count > 1) ? (unsigned int)count : 1;
+}
+
+/***************************************************************************
+*   Function   : CgroupCpuLimit
+*   Description: This function finds the number of processors worth of
+*                time allowed by the CPU quotas of this process's cgroup
+*                and the cgroups above it.  cgroup v2 is tried first, then
+*                cgroup v1.
+*   Parameters : NONE
+*   Effects    : NONE
+*   Returned   : Quota rounded up to whole processors, 0 if there isn't
+*                one.
+***************************************************************************/
+static long CgroupCpuLimit(void)
+{
+    FILE *fp;
+    char path[CGROUP_PATH_LEN];
+    char *slash;
+    size_t rootLen, len;
+    long limit, quota, period;
+
+    limit = 0;
+    strcpy(path, CGROUP_ROOT);
+    rootLen = strlen(path);
+
+    /* the v2 cgroup is the line that starts with "0::" */
+    fp = fopen(CGROUP_SELF, "r");
+
+    if (NULL != fp)
+    {
+        while (NULL != fgets(path + rootLen, CGROUP_PATH_LEN - rootLen -
+            sizeof(CGROUP_CPU_MAX), fp))
+        {
+            if (0 == strncmp(path + rootLen, "0::", 3))
+            {
+                len = strlen(path + rootLen + 3);
+                memmove(path + rootLen, path + rootLen + 3, len + 1);
+
+                if ((len > 0) && ('\n' == path[rootLen + len - 1]))
+                {
+                    path[rootLen + len - 1] = '\0';
+                }
+
+                break;
+            }
+
+            path[rootLen] = '\0';
+        }
+
+        fclose(fp);
+    }
+
+    /* use the smallest quota from the process's cgroup up to the root */
+    for (;;)
+    {
+        len = strlen(path);
+        strcpy(path + len, CGROUP_CPU_MAX);
+        quota = CgroupFileLimit(path);
+        path[len] = '\0';
+
+        if ((quota > 0) && ((0 == limit) || (quota < limit)))
+        {
+            limit = quota;
+        }
+
+        slash = strrchr(path, '/');
+
+        if ((NULL == slash) || ((size_t)(slash - path) < rootLen))
+        {
+            break;
+        }
+
+        *slash = '\0';
+    }
+
+    if (0 == limit)
+    {
+        quota = ReadLong(CGROUP_CFS_QUOTA);
+        period = ReadLong(CGROUP_CFS_PERIOD);
+
+        if ((quota > 0) && (period > 0))
+        {
+            limit = (quota + period - 1) / period;
+        }
+    }
+
+    return limit;
+}
+
+/***************************************************************************
+*   Function   : CgroupFileLimit
+*   Description: This function reads a cgroup v2 cpu.max file.
+*   Parameters : fileName - name of the file
+*   Effects    : NONE
+*   Returned   : Quota rounded up to whole processors, 0 if there isn't
+*                one.
+***************************************************************************/
+static long CgroupFileLimit(const char *fileName)
+{
+    FILE *fp;
+    long quota, period;
+    int fields;
+
+    fp = fopen(fileName, "r");
+
+    if (NULL == fp)
+    {
+        return 0;
+    }
+
+    /* "max 100000" doesn't match and means there's no quota */
+    fields = fscanf(fp, "%ld %ld", &quota, &period);
+    fclose(fp);
+
+    if ((2 != fields) || (quota <= 0) || (period <= 0))
+    {
+        return 0;
+    }
+
+    return (quota + period - 1) / period;
+}
+
+/***************************************************************************
+*   Function   : ReadLong
+*   Description: This function reads a number from a file.
+*   Parameters : fileName - name of the file
+*   Effects    : NONE
+*   Returned   : The number, -1 if it couldn't be read.
+***************************************************************************/
+static long ReadLong(const char *fileName)
+{
+    FILE *fp;
+    long value;
+
+    fp = fopen(fileName, "r");
+
+    if (NULL == fp)
+    {
+        return -1;
+    }
+
+    if (1 != fscanf(fp, "%ld", &value))
+    {
+        value = -1;
+    }
+
+    fclose(fp);
+    return value;
+}
+
+/***************************************************************************
+*   Function   : PoolStart
+*   Description: This function starts the pool's worker threads.  When
+*                workers are pinned, each is given the next processor in
+*                the process's affinity mask, skipping the first one, which
+*                is left for the calling thread.
+*   Parameters : numThreads - threads in the pool, 0 for
+*                             SortDefaultThreads()
+*                flags - SORT_POOL_PIN_THREADS to pin workers
+*   Effects    : The pool is running if memory for it was allocated.  The
+*                caller must own the pool.
+*   Returned   : TRUE if every worker was started
+***************************************************************************/
+static bool_t PoolStart(unsigned int numThreads, unsigned int flags)
+{
+    unsigned int i, numWorkers;
+#ifdef __linux__
+    cpu_set_t cpus;
+    int cpu;
+    bool_t pin;
+#endif
+
+    if (0 == numThreads)
+    {
+        numThreads = SortDefaultThreads();
+    }
+
+    numWorkers = numThreads - 1;
+    pool.workers = NULL;
+
+    if (numWorkers > 0)
+    {
+        pool.workers = (pool_worker_t *)malloc(numWorkers *
+            sizeof(pool_worker_t));
+
+        if (NULL == pool.workers)
+        {
+            return FALSE;
+        }
+    }
+
+#ifdef __linux__
+    pin = ((flags & SORT_POOL_PIN_THREADS) &&
+        (0 == sched_getaffinity(0, sizeof(cpus), &cpus))) ? TRUE : FALSE;
+    cpu = -1;
+
+    if (pin)
+    {
+        /* leave the first processor for the calling thread */
+        do
+        {
+            cpu++;
+        } while (!CPU_ISSET(cpu, &cpus));
+    }
+#else
+    (void)flags;
+#endif
+
+    pthread_mutex_lock(&poolLock);
+    pool.stopping = FALSE;
+    pthread_mutex_unlock(&poolLock);
+
+    for (i = 0; i < numWorkers; i++)
+    {
+        pool.workers[i].cpu = -1;
+        pool.workers[i].generation = pool.generation;
+
+#ifdef __linux__
+        if (pin)
+        {
+            /* the next processor in the mask, wrapping around */
+            do
+            {
+                cpu = (cpu + 1) % CPU_SETSIZE;
+            } while (!CPU_ISSET(cpu, &cpus));
+
+            pool.workers[i].cpu = cpu;
+        }
+#endif
+
+        if (0 != pthread_create(&pool.workers[i].id, NULL, WorkerStart,
+            &pool.workers[i]))
+        {
+            break;
+        }
+    }
+
+    pool.numWorkers = i;
+    pool.running = TRUE;
+
+    return (i == numWorkers) ? TRUE : FALSE;
+}
+
+/***************************************************************************
+*   Function   : PoolStop
+*   Description: This function tells the pool's workers to exit and waits
+*                for them.
+*   Parameters : NONE
+*   Effects    : The pool isn't running.  The caller must own the pool.
+*   Returned   : NONE
+***************************************************************************/
+static void PoolStop(void)
+{
+    unsigned int i;
+
+    if (!pool.running)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&poolLock);
+    pool.stopping = TRUE;
+    pthread_cond_broadcast(&poolWake);
+    pthread_mutex_unlock(&poolLock);
+
+    for (i = 0; i < pool.numWorkers; i++)
+    {
+        pthread_join(pool.workers[i].id, NULL);
+    }
+
+    free(pool.workers);
+    pool.workers = NULL;
+    pool.numWorkers = 0;
+    pool.running = FALSE;
+}
+
+/***************************************************************************
+*   Function   : PoolRun
+*   Description: This function posts a job to the pool, makes call 0 and
+*                then calls along with the workers until every call has
+*                been claimed, and waits for the workers' calls to return.
+*                Only as many workers as there are calls left are woken.
+*   Parameters : numCalls - number of calls to make
+*                func - function to call
+*                arg - argument passed to every call
+*   Effects    : func is called numCalls times.  The caller must own the
+*                pool.
+*   Returned   : NONE
+***************************************************************************/
+static void PoolRun(unsigned int numCalls,
+    void (*func)(void *arg, unsigned int thread), void *arg)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&poolLock);
+    pool.func = func;
+    pool.arg = arg;
+    pool.numCalls = numCalls;
+    pool.nextCall = 1;              /* call 0 is made by this thread */
+    pool.callsDone = 0;
+    pool.generation++;
+
+#ifdef SORT_STATS
+    pool.collect = (NULL != sortStats) ? TRUE : FALSE;
+
+    for (i = 0; i < pool.numWorkers; i++)
+    {
+        pool.workers[i].busy = FALSE;
+    }
+#endif
+
+    if (numCalls - 1 >= pool.numWorkers)
+    {
+        pthread_cond_broadcast(&poolWake);
+    }
+    else
+    {
+        for (i = 1; i < numCalls; i++)
+        {
+            pthread_cond_signal(&poolWake);
+        }
+    }
+
+    pthread_mutex_unlock(&poolLock);
+    func(arg, 0);
+    pthread_mutex_lock(&poolLock);
+    pool.callsDone++;
+    PoolMakeCalls(NULL);
+
+    while (pool.callsDone < pool.numCalls)
+    {
+        pthread_cond_wait(&poolDone, &poolLock);
+    }
+
+#ifdef SORT_STATS
+    for (i = 0; i < pool.numWorkers; i++)
+    {
+        if (pool.workers[i].busy)
+        {
+            StatMerge(&pool.workers[i].stats);
+        }
+    }
+#endif
+
+    pthread_mutex_unlock(&poolLock);
+}
+
+/***************************************************************************
+*   Function   : PoolMakeCalls
+*   Description: This function claims and makes calls for the pool's job
+*                until there are none left.  A worker stops when a new job
+*                is posted, so that it starts the new job afresh.
+*   Parameters : worker - the worker making the calls, NULL for the thread
+*                         that owns the pool
+*   Effects    : Calls are made.  poolLock is held on entry and exit, but
+*                not during the calls.
+*   Returned   : NONE
+***************************************************************************/
+static void PoolMakeCalls(pool_worker_t *worker)
+{
+    void (*func)(void *arg, unsigned int thread);
+    void *arg;
+    unsigned int call;
+
+    while ((pool.nextCall < pool.numCalls) &&
+        ((NULL == worker) || (worker->generation == pool.generation)))
+    {
+        call = pool.nextCall;
+        pool.nextCall++;
+        func = pool.func;
+        arg = pool.arg;
+
+#ifdef SORT_STATS
+        if ((NULL != worker) && pool.collect && !worker->busy)
+        {
+            worker->busy = TRUE;
+            SortStatsAttach(&worker->stats);
+        }
+#endif
+
+        pthread_mutex_unlock(&poolLock);
+        func(arg, call);
+        pthread_mutex_lock(&poolLock);
+
+        pool.callsDone++;
+
+        if (pool.callsDone == pool.numCalls)
+        {
+            pthread_cond_signal(&poolDone);
+        }
+    }
+
+#ifdef SORT_STATS
+    if (NULL != worker)
+    {
+        SortStatsAttach(NULL);
+    }
+#endif
+}
+
+/***************************************************************************
+*   Function   : WorkerStart
+*   Description: This function is the entry point of the pool's workers.
+*                A worker pins itself to its processor, then sleeps until
+*                a job is posted, makes calls for it, and goes back to
+*                sleep until the pool is stopped.
+*   Parameters : arg - pointer to the worker's pool_worker_t
+*   Effects    : Calls are made for the pool's jobs
+*   Returned   : NULL
+***************************************************************************/
+static void *WorkerStart(void *arg)
+{
+    pool_worker_t *worker;
+#ifdef __linux__
+    cpu_set_t cpus;
+#endif
+
+    worker = (pool_worker_t *)arg;
+
+#ifdef __linux__
+    if (worker->cpu >= 0)
+    {
+        /* pinning is a hint, the worker runs anywhere if it fails */
+        CPU_ZERO(&cpus);
+        CPU_SET(worker->cpu, &cpus);
+        sched_setaffinity(0, sizeof(cpus), &cpus);
+    }
+#endif
+
+    pthread_mutex_lock(&poolLock);
+
+    for (;;)
+    {
+        while ((worker->generation == pool.generation) && !pool.stopping)
+        {
+            pthread_cond_wait(&poolWake, &poolLock);
+        }
+
+        if (pool.stopping)
+        {
+            break;
+        }
+
+        worker->generation = pool.generation;
+        PoolMakeCalls(worker);
+    }
+
+    pthread_mutex_unlock(&poolLock);
+    return NULL;
+}
+
+/***************************************************************************
+*   Function   : RunNewThreads
+*   Description: This function makes the calls of SortRunThreads with new
+*                threads when the pool isn't available.  The calling
+*                thread makes the call for index 0, and the others are made
+*                by new threads.  If a thread can't be created, the calling
+*                thread makes its call too.
+*   Parameters : numThreads - number of calls to make
+*                func - function to call
+*                arg - argument passed to every call
+*   Effects    : func is called numThreads times
+*   Returned   : NONE
+***************************************************************************/
+static void RunNewThreads(unsigned int numThreads,
+    void (*func)(void *arg, unsigned int thread), void *arg)
+{
+    unsigned int i;
+    thread_start_t *starts;
+
+    starts = NULL;
+
+    if (numThreads > 1)
+    {
+        starts = (thread_start_t *)ScratchAlloc(numThreads *
+            sizeof(thread_start_t));
+    }
+
+    if (NULL == starts)
+    {
+        /* no threads, make every call from this one */
+        for (i = 0; i < numThreads; i++)
+        {
+            func(arg, i);
+        }
+
+        return;
+    }
+
+    for (i = 1; i < numThreads; i++)
+    {
+        starts[i].func = func;
+        starts[i].arg = arg;
+        starts[i].thread = i;
+        starts[i].started = FALSE;
+#ifdef SORT_STATS
+        starts[i].stats = NULL;
+
+        if (NULL != sortStats)
+        {
+            starts[i].stats = (sort_stats_t *)malloc(sizeof(sort_stats_t));
+        }
+#endif
+
+        if (0 == pthread_create(&starts[i].id, NULL, ThreadStart,
+            &starts[i]))
+        {
+            starts[i].started = TRUE;
+        }
+    }
+
+    func(arg, 0);
+
+    for (i = 1; i < numThreads; i++)
+    {
+        if (starts[i].started)
+        {
+            pthread_join(starts[i].id, NULL);
+        }
+        else
+        {
+            func(arg, i);
+        }
+
+#ifdef SORT_STATS
+        if (NULL != starts[i].stats)
+        {
+            if (starts[i].started)
+            {
+                StatMerge(starts[i].stats);
+            }
+
+            free(starts[i].stats);
+        }
+#endif
+    }
+
+    ScratchFree(starts, numThreads * sizeof(thread_start_t));
+}
+
+/***************************************************************************
+*   Function   : ThreadStart
+*   Description: This function is the entry point of the threads created
+*                by SortRunThreads.  It attaches the thread's statistics and
+*                makes its call.
+*   Parameters : arg - pointer to the thread's thread_start_t
+*   Effects    : The thread's function is called
+*   Returned   : NULL
+***************************************************************************/
+static void *ThreadStart(void *arg)
+{
+    thread_start_t *start;
+
+    start = (thread_start_t *)arg;
+
+#ifdef SORT_STATS
+    SortStatsAttach(start->stats);
+#endif
+
+    start->func(start->arg, start->thread);
+
+#ifdef SORT_STATS
+    SortStatsAttach(NULL);
+#endif
+
+    return NULL;
+}
+#endif
+
+/***************************************************************************
+*   Function   : SortThreadStart
+*   Description: This function starts a thread that calls func in the
+*                background.  If a thread can't be started, func is called
+*                before this function returns.
+*   Parameters : func - function for the thread to call
+*                arg - argument passed to func
+*   Effects    : func is called by a new thread (or this one)
+*   Returned   : Handle to pass to SortThreadJoin.  NULL if func has
+*                already been called.
+***************************************************************************/
+sort_thread_t *SortThreadStart(void (*func)(void *arg), void *arg)
+{
+#ifndef SORT_NO_THREADS
+    sort_thread_t *thread;
+
+    thread = (sort_thread_t *)malloc(sizeof(sort_thread_t));
+
+    if (NULL != thread)
+    {
+        thread->func = func;
+        thread->arg = arg;
+#ifdef SORT_STATS
+        thread->collect = (NULL != sortStats) ? TRUE : FALSE;
+#endif
+
+        if (0 == pthread_create(&thread->id, NULL, BackgroundStart, thread))
+        {
+            return thread;
+        }
+
+        free(thread);
+    }
+#endif
+
+    func(arg);
+    return NULL;
+}
+
+/***************************************************************************
+*   Function   : SortThreadJoin
+*   Description: This function waits for a thread started by
+*                SortThreadStart to finish.  When statistics are being
+*                collected, the thread's statistics are added to the
+*                caller's.
+*   Parameters : thread - handle returned by SortThreadStart (may be NULL)
+*   Effects    : The thread's handle is freed
+*   Returned   : NONE
+***************************************************************************/
+void SortThreadJoin(sort_thread_t *thread)
+{
+    if (NULL == thread)
+    {
+        return;
+    }
+
+#ifndef SORT_NO_THREADS
+    pthread_join(thread->id, NULL);
+#endif
+
+#ifdef SORT_STATS
+    if (thread->collect)
+    {
+        StatMerge(&thread->stats);
+    }
+#endif
+
+    free(thread);
+}
+
+#ifndef SORT_NO_THREADS
+/***************************************************************************
+*   Function   : BackgroundStart
+*   Description: This function is the entry point of the threads created
+*                by SortThreadStart.
+*   Parameters : arg - pointer to the thread's sort_thread_t
+*   Effects    : The thread's function is called
+*   Returned   : NULL
+***************************************************************************/
+static void *BackgroundStart(void *arg)
+{
+    sort_thread_t *thread;
+
+    thread = (sort_thread_t *)arg;
+
+#ifdef SORT_STATS
+    SortStatsAttach(thread->collect ? &thread->stats : NULL);
+#endif
+
+    thread->func(thread->arg);
+
+#ifdef SORT_STATS
+    SortStatsAttach(NULL);
+#endif
+
+    return NULL;
+}
+#endif
+
+#ifdef SORT_STATS
+/***************************************************************************
+*   Function   : StatMerge
+*   Description: This function adds the statistics collected by a helper
+*                thread to the calling thread's statistics.  The helper's
+*                recursion and scratch memory are treated as if they were
+*                on top of the caller's.
+*   Parameters : stats - statistics collected by a helper thread
+*   Effects    : The calling thread's statistics are updated
+*   Returned   : NONE
+***************************************************************************/
+static void StatMerge(const sort_stats_t *stats)
+{
+    if (NULL == sortStats)
+    {
+        return;
+    }
+
+    sortStats->comparisons += stats->comparisons;
+    sortStats->moves += stats->moves;
+    sortStats->bytesCopied += stats->bytesCopied;
+    sortStats->mallocs += stats->mallocs;
+    sortStats->radixPassesSkipped += stats->radixPassesSkipped;
+
+    if (sortStats->scratchBytes + stats->peakScratchBytes >
+        sortStats->peakScratchBytes)
+    {
+        sortStats->peakScratchBytes =
+            sortStats->scratchBytes + stats->peakScratchBytes;
+    }
+
+    if (sortStats->depth + stats->maxDepth > sortStats->maxDepth)
+    {
+        sortStats->maxDepth = sortStats->depth + stats->maxDepth;
+    }
+}
+#endif
+
+/***************************************************************************
+*   Function   : SortLocksCreate
+*   Description: This function creates an array of locks.
+*   Parameters : ctx - context providing the memory, NULL for the heap
+*                count - number of locks to create
+*   Effects    : Memory is allocated for the locks
+*   Returned   : Pointer to the locks, NULL on failure.
+***************************************************************************/
+sort_lock_t *SortLocksCreate(sort_context_t *ctx, size_t count)
+{
+    sort_lock_t *locks;
+#ifndef SORT_NO_THREADS
+    size_t i;
+#endif
+
+    locks = (sort_lock_t *)ContextAlloc(ctx, count * sizeof(sort_lock_t));
+
+    if (NULL == locks)
+    {
+        return NULL;
+    }
+
+#ifndef SORT_NO_THREADS
+    for (i = 0; i < count; i++)
+    {
+        if (0 != pthread_mutex_init(&locks[i].mutex, NULL))
+        {
+            while (i > 0)
+            {
+                i--;
+                pthread_mutex_destroy(&locks[i].mutex);
+            }
+
+            ContextFree(ctx, locks, count * sizeof(sort_lock_t));
+            return NULL;
+        }
+    }
+#endif
+
+    return locks;
+}
+
+/***************************************************************************
+*   Function   : SortLocksFree
+*   Description: This function frees an array of locks created by
+*                SortLocksCreate.
+*   Parameters : ctx - context the locks were created with
+*                locks - pointer to the locks
+*                count - number of locks
+*   Effects    : The locks are destroyed and their memory is freed
+*   Returned   : NONE
+***************************************************************************/
+void SortLocksFree(sort_context_t *ctx, sort_lock_t *locks, size_t count)
+{
+#ifndef SORT_NO_THREADS
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        pthread_mutex_destroy(&locks[i].mutex);
+    }
+#endif
+
+    ContextFree(ctx, locks, count * sizeof(sort_lock_t));
+}
+
+/***************************************************************************
+*   Function   : SortLock
+*   Description: This function acquires one of an array of locks.
+*   Parameters : locks - pointer to the locks
+*                index - index of the lock to acquire
+*   Effects    : The calling thread holds the lock
+*   Returned   : NONE
+***************************************************************************/
+void SortLock(sort_lock_t *locks, size_t index)
+{
+#ifndef SORT_NO_THREADS
+    pthread_mutex_lock(&locks[index].mutex);
+#else
+    (void)locks;
+    (void)index;
+#endif
+}
+
+/***************************************************************************
+*   Function   : SortUnlock
+*   Description: This function releases one of an array of locks.
+*   Parameters : locks - pointer to the locks
+*                index - index of the lock to release
+*   Effects    : The lock is released
+*   Returned   : NONE
+***************************************************************************/
+void SortUnlock(sort_lock_t *locks, size_t index)
+{
+#ifndef SORT_NO_THREADS
+    pthread_mutex_unlock(&locks[index].mutex);
+#else
+    (void)locks;
+    (void)index;
+#endif
+}
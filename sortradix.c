@@ -0,0 +1,643 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortradix.c
+*   Purpose : This module implements a least significant digit radix sort
+*             for items with a native numeric key (int, unsigned int,
+*             long, unsigned long, float, or double).  Unlike RadixSort,
+*             the caller doesn't need to provide key functions or make one
+*             call per pass.  Keys are mapped to unsigned values that sort
+*             in the same order as the original keys, and all of the digit
+*             counts are collected in a single pass over the list.  The
+*             digit width (8, 11, or 16 bits) is picked from the number of
+*             items and the cache size, so most int lists take 3 passes.
+*
+*             The items are scattered through small per-bucket staging
+*             buffers, one cache line each, that are written out a whole
+*             line at a time (with non-temporal stores where SSE2 is
+*             available).  Writing to hundreds of destinations an item at a
+*             time thrashes the TLB and store buffers, writing lines
+*             doesn't.  RadixSort uses the same staging buffers.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include "sort.h"
+#include "sortint.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#define SCATTER_STREAM      /* write whole lines with non-temporal stores */
+#endif
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* a digit is only made wide enough to leave this many items per bucket */
+#define RADIX_ITEMS_PER_BUCKET  4
+
+/* bytes staged for each bucket before they're written out, a cache line */
+#define SCATTER_LINE_BYTES  64
+
+/* sign bits of the types keys are read as */
+#define UINT_SIGN_BIT       (UINT_MAX - (UINT_MAX >> 1))
+#define ULONG_SIGN_BIT      (ULONG_MAX - (ULONG_MAX >> 1))
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* items being scattered into buckets a cache line at a time */
+struct radix_scatter_t
+{
+    size_t numBuckets;              /* number of buckets */
+    size_t itemSize;                /* size of each item */
+    size_t lineItems;               /* items that fit in a staging line */
+    size_t size;                    /* bytes allocated for the structure */
+    size_t *fill;                   /* items staged for each bucket */
+    size_t *limit;                  /* items to stage before writing */
+    char *lines;                    /* staging lines, cache line aligned */
+    char *dst;                      /* array receiving the items */
+    size_t *offsets;                /* next position of each bucket */
+#ifdef SCATTER_STREAM
+    bool_t streamed;                /* TRUE if non-temporal stores used */
+#endif
+};
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static unsigned int RadixDigitBits(size_t numItems);
+static void ScatterPut(radix_scatter_t *scatter, size_t bucket,
+    const void *item);
+static void ScatterFlush(radix_scatter_t *scatter, size_t bucket,
+    size_t count);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : RadixKeySize
+*   Description: This function returns the number of bytes in a numeric key
+*                of the specified type, if keys of that type may be radix
+*                sorted on this platform.  Floating point keys require an
+*                unsigned integer type of the same size.
+*   Parameters : keyType - type of the key
+*   Effects    : NONE
+*   Returned   : Size of the key in bytes, 0 if the key can't be radix
+*                sorted.
+***************************************************************************/
+size_t RadixKeySize(sort_key_t keyType)
+{
+    switch (keyType)
+    {
+        case SORT_KEY_INT:
+        case SORT_KEY_UINT:
+            return sizeof(unsigned int);
+
+        case SORT_KEY_LONG:
+        case SORT_KEY_ULONG:
+            return sizeof(unsigned long);
+
+        case SORT_KEY_FLOAT:
+            return (sizeof(float) == sizeof(unsigned int)) ? sizeof(float) : 0;
+
+        case SORT_KEY_DOUBLE:
+            return (sizeof(double) == sizeof(unsigned long)) ?
+                sizeof(double) : 0;
+
+        default:
+            return 0;
+    }
+}
+
+/***************************************************************************
+*   Function   : RadixKey
+*   Description: This function reads a numeric key and maps it to an
+*                unsigned long that sorts in the same order as the key.
+*                Signed integers have their sign bit flipped.  Positive
+*                floating point values have their sign bit set, and
+*                negative values have all of their bits flipped.
+*   Parameters : key - pointer to the key (no alignment is required)
+*                keyType - type of the key
+*   Effects    : NONE
+*   Returned   : The mapped key
+***************************************************************************/
+unsigned long RadixKey(const void *key, sort_key_t keyType)
+{
+    unsigned int ui;
+    unsigned long ul;
+
+    switch (keyType)
+    {
+        case SORT_KEY_INT:
+            memcpy(&ui, key, sizeof(ui));
+            return (unsigned long)(ui ^ UINT_SIGN_BIT);
+
+        case SORT_KEY_UINT:
+            memcpy(&ui, key, sizeof(ui));
+            return (unsigned long)ui;
+
+        case SORT_KEY_LONG:
+            memcpy(&ul, key, sizeof(ul));
+            return ul ^ ULONG_SIGN_BIT;
+
+        case SORT_KEY_ULONG:
+            memcpy(&ul, key, sizeof(ul));
+            return ul;
+
+        case SORT_KEY_FLOAT:
+            memcpy(&ui, key, sizeof(ui));
+            ui = (ui & UINT_SIGN_BIT) ? ~ui : (ui | UINT_SIGN_BIT);
+            return (unsigned long)ui;
+
+        case SORT_KEY_DOUBLE:
+            memcpy(&ul, key, sizeof(ul));
+            return (ul & ULONG_SIGN_BIT) ? ~ul : (ul | ULONG_SIGN_BIT);
+
+        default:
+            return 0;
+    }
+}
+
+/***************************************************************************
+*   Function   : RadixSortNumeric
+*   Description: This function performs a complete radix sort on an array
+*                of items with a native numeric key using scratch memory
+*                from the heap.  See RadixSortNumericCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                keyOffset - offset of the key from the start of an item
+*                keyType - type of the key.  It must be a type for which
+*                          RadixKeySize returns a non-zero size.
+*   Effects    : The contents of list are sorted in ascending key order
+*   Returned   : NONE
+***************************************************************************/
+void RadixSortNumeric(void *list, size_t numItems, size_t itemSize,
+    size_t keyOffset, sort_key_t keyType)
+{
+    sort_error_t result;
+
+    result = RadixSortNumericCtx(NULL, list, numItems, itemSize, keyOffset,
+        keyType);
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : RadixSortNumericCtx
+*   Description: This function performs a complete least significant digit
+*                radix sort on an array of items with a native numeric key.
+*                The counts for every digit are made in a single pass, and
+*                passes where every item has the same digit are skipped.
+*                Items are scattered through staging lines when they fit.
+*                The sort is stable.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                keyOffset - offset of the key from the start of an item
+*                keyType - type of the key.  It must be a type for which
+*                          RadixKeySize returns a non-zero size.
+*   Effects    : The contents of list are sorted in ascending key order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available, SORT_ERR_PARAM if keyType can't be
+*                radix sorted.
+***************************************************************************/
+sort_error_t RadixSortNumericCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize, size_t keyOffset, sort_key_t keyType)
+{
+    size_t *counts;                 /* digit counts, then offsets */
+    size_t *offsets;                /* offsets for the current pass */
+    size_t numPasses, numBuckets, keyBits, pass, i, sum, count;
+    unsigned long key, mask;
+    unsigned int bits, shift, digit;
+    void *buffer, *src, *dst, *swap;
+    radix_scatter_t *scatter;
+
+    keyBits = RadixKeySize(keyType) * CHAR_BIT;
+
+    if (0 == keyBits)
+    {
+        return SORT_ERR_PARAM;
+    }
+
+    if (numItems <= 1)
+    {
+        return SORT_OK;
+    }
+
+    /* one pass per digit, the last digit may be narrower */
+    bits = RadixDigitBits(numItems);
+    numBuckets = (size_t)1 << bits;
+    mask = (unsigned long)numBuckets - 1;
+    numPasses = (keyBits + bits - 1) / bits;
+
+    counts = (size_t *)ContextCalloc(ctx, numPasses * numBuckets,
+        sizeof(size_t));
+
+    if (NULL == counts)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    /* count the digits for every pass at once */
+    for (i = 0; i < numItems; i++)
+    {
+        key = RadixKey(VoidPtrOffset(list, (i * itemSize) + keyOffset),
+            keyType);
+
+        for (pass = 0; pass < numPasses; pass++)
+        {
+            counts[(pass * numBuckets) + (key & mask)]++;
+            key >>= bits;
+        }
+    }
+
+    buffer = ContextAlloc(ctx, numItems * itemSize);
+
+    if (NULL == buffer)
+    {
+        ContextFree(ctx, counts, numPasses * numBuckets * sizeof(size_t));
+        return SORT_ERR_NOMEM;
+    }
+
+    /* without staging lines the items are written directly */
+    scatter = RadixScatterCreate(ctx, numBuckets, itemSize);
+
+    src = list;
+    dst = buffer;
+
+    for (pass = 0; pass < numPasses; pass++)
+    {
+        offsets = &counts[pass * numBuckets];
+        shift = (unsigned int)(pass * bits);
+
+        digit = (unsigned int)((RadixKey(VoidPtrOffset(src, keyOffset),
+            keyType) >> shift) & mask);
+
+        if (offsets[digit] == numItems)
+        {
+            /* every item has the same digit, this pass changes nothing */
+            StatAdd(radixPassesSkipped, 1);
+            continue;
+        }
+
+        /* convert counts to the offset of the first item with each digit */
+        sum = 0;
+
+        for (i = 0; i < numBuckets; i++)
+        {
+            count = offsets[i];
+            offsets[i] = sum;
+            sum += count;
+        }
+
+        /* scatter the items into their positions for this digit */
+        if (NULL != scatter)
+        {
+            RadixScatterStart(scatter, dst, offsets);
+
+            for (i = 0; i < numItems; i++)
+            {
+                digit = (unsigned int)((RadixKey(VoidPtrOffset(src,
+                    (i * itemSize) + keyOffset), keyType) >> shift) & mask);
+
+                ScatterPut(scatter, digit, VoidPtrOffset(src, i * itemSize));
+            }
+
+            RadixScatterFinish(scatter);
+        }
+        else
+        {
+            for (i = 0; i < numItems; i++)
+            {
+                digit = (unsigned int)((RadixKey(VoidPtrOffset(src,
+                    (i * itemSize) + keyOffset), keyType) >> shift) & mask);
+
+                CopyItem(VoidPtrOffset(dst, offsets[digit] * itemSize),
+                    VoidPtrOffset(src, i * itemSize), itemSize);
+                offsets[digit]++;
+            }
+        }
+
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != list)
+    {
+        /* an odd number of passes were made, results are in buffer */
+        CopyItems(list, src, numItems, itemSize);
+    }
+
+    if (NULL != scatter)
+    {
+        RadixScatterFree(ctx, scatter);
+    }
+
+    ContextFree(ctx, buffer, numItems * itemSize);
+    ContextFree(ctx, counts, numPasses * numBuckets * sizeof(size_t));
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : RadixDigitBits
+*   Description: This function picks the width of the digits used to radix
+*                sort a list.  Wider digits mean fewer passes, but more
+*                buckets.  The widest of 16, 11, and 8 bits is used that
+*                is no wider than sortTuning.radixBits, leaves at least a
+*                few items per bucket, and keeps the counts of one digit in
+*                the level 2 cache.  The staging lines of 16 bit digits
+*                won't fit in the cache, so their items are written
+*                directly, which still beats an extra pass of 11 bits.
+*   Parameters : numItems - number of items in the list
+*   Effects    : NONE
+*   Returned   : Number of bits per digit
+***************************************************************************/
+static unsigned int RadixDigitBits(size_t numItems)
+{
+    static const unsigned int widths[] = {16, 11, 8};
+    unsigned int i, bits;
+    size_t numBuckets;
+
+    for (i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+    {
+        bits = widths[i];
+        numBuckets = (size_t)1 << bits;
+
+        /* only the counts of the pass being scattered need to be cached */
+        if ((bits > sortTuning.radixBits) ||
+            ((numItems / RADIX_ITEMS_PER_BUCKET) < numBuckets) ||
+            ((numBuckets * sizeof(size_t)) > sortTuning.l2CacheBytes))
+        {
+            continue;
+        }
+
+        return bits;
+    }
+
+    return (sortTuning.radixBits < 8) ? sortTuning.radixBits : 8;
+}
+
+/***************************************************************************
+*   Function   : RadixScatterCreate
+*   Description: This function allocates staging lines for scattering
+*                items into buckets.  Staging is only worth it if at least
+*                two items fit in a line and the lines for every bucket fit
+*                in half of the level 2 cache.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                numBuckets - number of buckets
+*                itemSize - size of each item
+*   Effects    : Memory is allocated for the staging lines
+*   Returned   : Pointer to the staging lines, NULL if items should be
+*                written directly (or memory wasn't available).
+***************************************************************************/
+radix_scatter_t *RadixScatterCreate(sort_context_t *ctx, size_t numBuckets,
+    size_t itemSize)
+{
+    radix_scatter_t *scatter;
+    size_t size;
+    char *lines;
+
+    if ((itemSize > (SCATTER_LINE_BYTES / 2)) ||
+        ((numBuckets * SCATTER_LINE_BYTES) > (sortTuning.l2CacheBytes / 2)))
+    {
+        return NULL;
+    }
+
+    /* an extra line leaves room to align the lines */
+    size = sizeof(radix_scatter_t) + (2 * numBuckets * sizeof(size_t)) +
+        ((numBuckets + 1) * SCATTER_LINE_BYTES);
+    scatter = (radix_scatter_t *)ContextAlloc(ctx, size);
+
+    if (NULL == scatter)
+    {
+        return NULL;
+    }
+
+    scatter->numBuckets = numBuckets;
+    scatter->itemSize = itemSize;
+    scatter->lineItems = SCATTER_LINE_BYTES / itemSize;
+    scatter->size = size;
+    scatter->fill = (size_t *)(scatter + 1);
+    scatter->limit = scatter->fill + numBuckets;
+
+    lines = (char *)(scatter->limit + numBuckets);
+    scatter->lines = lines + (SCATTER_LINE_BYTES -
+        ((size_t)lines % SCATTER_LINE_BYTES));
+
+    return scatter;
+}
+
+/***************************************************************************
+*   Function   : RadixScatterFree
+*   Description: This function frees staging lines created by
+*                RadixScatterCreate.
+*   Parameters : ctx - context the lines were allocated from
+*                scatter - pointer to the staging lines
+*   Effects    : The staging lines are freed
+*   Returned   : NONE
+***************************************************************************/
+void RadixScatterFree(sort_context_t *ctx, radix_scatter_t *scatter)
+{
+    ContextFree(ctx, scatter, scatter->size);
+}
+
+/***************************************************************************
+*   Function   : RadixScatterStart
+*   Description: This function prepares staging lines for a pass of
+*                scattering.  When whole items fit evenly in a cache line,
+*                each bucket's first write is made short enough that every
+*                write after it fills a line of the destination.
+*   Parameters : scatter - pointer to the staging lines
+*                dst - array receiving the items
+*                offsets - position of the first item of each bucket in
+*                          dst.  They're advanced as items are written.
+*   Effects    : The staging lines are empty
+*   Returned   : NONE
+***************************************************************************/
+void RadixScatterStart(radix_scatter_t *scatter, void *dst, size_t *offsets)
+{
+    size_t i, misalign, itemSize;
+
+    itemSize = scatter->itemSize;
+    scatter->dst = (char *)dst;
+    scatter->offsets = offsets;
+#ifdef SCATTER_STREAM
+    scatter->streamed = FALSE;
+#endif
+
+    for (i = 0; i < scatter->numBuckets; i++)
+    {
+        scatter->fill[i] = 0;
+        scatter->limit[i] = scatter->lineItems;
+
+        if (0 == (SCATTER_LINE_BYTES % itemSize))
+        {
+            misalign = (size_t)(scatter->dst + (offsets[i] * itemSize)) %
+                SCATTER_LINE_BYTES;
+
+            if (0 == (misalign % itemSize))
+            {
+                scatter->limit[i] = (SCATTER_LINE_BYTES - misalign) /
+                    itemSize;
+            }
+        }
+    }
+}
+
+/***************************************************************************
+*   Function   : RadixScatterPut
+*   Description: This function stages an item for a bucket, writing out
+*                the bucket's line when it's full.
+*   Parameters : scatter - pointer to the staging lines
+*                bucket - bucket receiving the item
+*                item - pointer to the item
+*   Effects    : The item is staged or written
+*   Returned   : NONE
+***************************************************************************/
+void RadixScatterPut(radix_scatter_t *scatter, size_t bucket,
+    const void *item)
+{
+    ScatterPut(scatter, bucket, item);
+}
+
+/***************************************************************************
+*   Function   : RadixScatterFinish
+*   Description: This function writes out the items left in the staging
+*                lines at the end of a pass.
+*   Parameters : scatter - pointer to the staging lines
+*   Effects    : Every staged item is written to its position
+*   Returned   : NONE
+***************************************************************************/
+void RadixScatterFinish(radix_scatter_t *scatter)
+{
+    size_t i;
+
+    for (i = 0; i < scatter->numBuckets; i++)
+    {
+        if (0 != scatter->fill[i])
+        {
+            ScatterFlush(scatter, i, scatter->fill[i]);
+            scatter->fill[i] = 0;
+        }
+    }
+
+#ifdef SCATTER_STREAM
+    if (scatter->streamed)
+    {
+        /* non-temporal stores must be visible before the items are read */
+        _mm_sfence();
+    }
+#endif
+}
+
+/***************************************************************************
+*   Function   : ScatterPut
+*   Description: This function does the work of RadixScatterPut, where it
+*                may be inlined into the scatter loop of this module.
+*   Parameters : scatter - pointer to the staging lines
+*                bucket - bucket receiving the item
+*                item - pointer to the item
+*   Effects    : The item is staged or written
+*   Returned   : NONE
+***************************************************************************/
+static void ScatterPut(radix_scatter_t *scatter, size_t bucket,
+    const void *item)
+{
+    size_t count;
+
+    count = scatter->fill[bucket];
+    CopyItem(scatter->lines + (bucket * SCATTER_LINE_BYTES) +
+        (count * scatter->itemSize), item, scatter->itemSize);
+    count++;
+
+    if (count == scatter->limit[bucket])
+    {
+        ScatterFlush(scatter, bucket, count);
+        scatter->limit[bucket] = scatter->lineItems;
+        count = 0;
+    }
+
+    scatter->fill[bucket] = count;
+}
+
+/***************************************************************************
+*   Function   : ScatterFlush
+*   Description: This function writes a bucket's staged items to their
+*                positions.  A full line going to a line aligned position
+*                is written with non-temporal stores when they're
+*                available, so it doesn't displace the cache or need to
+*                be read first.  The copies aren't counted as moves; the
+*                items were counted when they were staged.
+*   Parameters : scatter - pointer to the staging lines
+*                bucket - bucket being written
+*                count - number of items staged for the bucket
+*   Effects    : The items are written and the bucket's offset advanced
+*   Returned   : NONE
+***************************************************************************/
+static void ScatterFlush(radix_scatter_t *scatter, size_t bucket,
+    size_t count)
+{
+    const char *line;
+    char *dst;
+    size_t bytes;
+
+    line = scatter->lines + (bucket * SCATTER_LINE_BYTES);
+    dst = scatter->dst + (scatter->offsets[bucket] * scatter->itemSize);
+    bytes = count * scatter->itemSize;
+    scatter->offsets[bucket] += count;
+
+#ifdef SCATTER_STREAM
+    if ((SCATTER_LINE_BYTES == bytes) &&
+        (0 == ((size_t)dst % SCATTER_LINE_BYTES)))
+    {
+        _mm_stream_si128((__m128i *)dst,
+            _mm_load_si128((const __m128i *)line));
+        _mm_stream_si128((__m128i *)(dst + 16),
+            _mm_load_si128((const __m128i *)(line + 16)));
+        _mm_stream_si128((__m128i *)(dst + 32),
+            _mm_load_si128((const __m128i *)(line + 32)));
+        _mm_stream_si128((__m128i *)(dst + 48),
+            _mm_load_si128((const __m128i *)(line + 48)));
+        scatter->streamed = TRUE;
+        return;
+    }
+#endif
+
+    memcpy(dst, line, bytes);
+}
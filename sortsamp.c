@@ -0,0 +1,1187 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortsamp.c
+*   Purpose : This module implements an in-place parallel samplesort in
+*             the style of IPS4o (In-place Parallel Super Scalar
+*             Samplesort).  Each step draws a sample of the list, builds a
+*             tree of splitters from it, and distributes the items into up
+*             to 256 buckets:
+*             1. Each thread classifies a stripe of the list, collecting
+*                items in one small block buffer per bucket.  Full buffers
+*                are written back over the part of the stripe that has
+*                already been read.
+*             2. The full blocks are moved to the front of the list.
+*             3. The threads swap blocks into the part of the list that
+*                belongs to their bucket.
+*             4. Items left in the buffers fill the gaps at bucket edges.
+*             Only the buffers (a few blocks per bucket per thread) are
+*             needed in addition to the list.  Buckets are sorted the same
+*             way until they're small enough for QuickSort3Way.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <string.h>
+#include <assert.h>
+#include "sort.h"
+#include "sortint.h"
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+#define MAX_LOG_BUCKETS     8
+#define MAX_BUCKETS         (1 << MAX_LOG_BUCKETS)
+
+/* items are moved between buckets in blocks of about this many bytes */
+#define BLOCK_BYTES         2048
+
+/* buckets should average at least this many blocks */
+#define BUCKET_BLOCKS       4
+
+/* lists smaller than this (or BASE_CASE_BLOCKS blocks) use QuickSort3Way */
+#define BASE_CASE_ITEMS     512
+#define BASE_CASE_BLOCKS    16
+
+/* the sample has log2(numItems) / OVERSAMPLE_DIVISOR items per bucket */
+#define OVERSAMPLE_DIVISOR  5
+
+/* number of items that are classified together */
+#define CLASSIFY_UNROLL     4
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* the part of a partitioning step that belongs to one thread */
+typedef struct
+{
+    void *buffers;              /* one block buffer for each bucket */
+    size_t *bufferCounts;       /* items in each bucket's buffer */
+    size_t *bucketCounts;       /* items classified into each bucket */
+    void *swap[2];              /* blocks being moved between buckets */
+    size_t begin;               /* first item in the thread's stripe */
+    size_t end;                 /* end of the thread's stripe */
+    size_t written;             /* end of full blocks written to the stripe */
+} stripe_t;
+
+typedef struct
+{
+    void *list;                 /* list being partitioned */
+    size_t numItems;            /* number of items in list */
+    size_t itemSize;            /* size of each item in list */
+    int (*compareFunc) (const void *, const void *);
+    unsigned int numThreads;    /* number of stripes allocated */
+    unsigned int activeThreads; /* threads partitioning list */
+    size_t blockItems;          /* items in a block */
+    unsigned int logBuckets;    /* log2(numBuckets) */
+    size_t numBuckets;          /* buckets list is partitioned into */
+    void *tree;                 /* splitter tree, the root is item 1 */
+    stripe_t *stripes;          /* one stripe for each thread */
+    sort_lock_t *locks;         /* one lock for each bucket */
+    void *overflow;             /* a block that would extend past the list */
+    void *temp;                 /* an item for QuickSort3WayPartition */
+    sort_context_t *ctx;        /* context the memory came from, or NULL */
+    size_t overflowBucket;      /* bucket of overflow, MAX_BUCKETS if none */
+    size_t bucketStart[MAX_BUCKETS + 1];    /* first item of each bucket */
+    size_t writePtr[MAX_BUCKETS];   /* next block written to each bucket */
+    size_t readEnd[MAX_BUCKETS];    /* end of each bucket's unread blocks */
+} samplesort_t;
+
+/* buckets that the threads sort at the same time */
+typedef struct
+{
+    samplesort_t *ss;           /* used by thread 0 */
+    samplesort_t **workers;     /* one for each thread (may be NULL) */
+    void *list;                 /* list that was partitioned */
+    const size_t *bounds;       /* first item in each bucket */
+    size_t numBuckets;          /* number of buckets */
+    size_t largest;             /* buckets larger than this are done */
+    size_t next;                /* next bucket to sort */
+    sort_lock_t *lock;          /* protects next */
+} bucket_job_t;
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static samplesort_t *SampleSortCreate(sort_context_t *ctx, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), unsigned int numThreads);
+static void SampleSortFree(samplesort_t *ss);
+
+static void SampleSortParallel(samplesort_t *ss, void *list,
+    size_t numItems);
+static void SampleSortSequential(samplesort_t *ss, void *list,
+    size_t numItems);
+static void SortBuckets(void *arg, unsigned int thread);
+
+static void Partition(samplesort_t *ss, void *list, size_t numItems,
+    unsigned int numThreads);
+static void SelectSplitters(samplesort_t *ss);
+static void BuildTree(samplesort_t *ss, size_t node, size_t first,
+    size_t last, size_t step);
+static size_t Classify(const samplesort_t *ss, const void *item);
+static void ClassifyStripe(void *arg, unsigned int thread);
+static void AddToBuffer(samplesort_t *ss, stripe_t *stripe, size_t bucket,
+    const void *item);
+static size_t MoveEmptyBlocks(samplesort_t *ss);
+static void SkipPlacedBlocks(samplesort_t *ss, size_t bucket);
+static void PermuteBlocks(void *arg, unsigned int thread);
+static void Cleanup(samplesort_t *ss);
+
+/***************************************************************************
+*                                 MACROS
+***************************************************************************/
+#define ItemPtr(ss, base, index)    VoidPtrOffset(base,         \
+                                        (index) * (ss)->itemSize)
+#define RoundUpBlock(ss, index)     ((((index) + (ss)->blockItems - 1) / \
+                                        (ss)->blockItems) * (ss)->blockItems)
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : ParallelSampleSort
+*   Description: This function performs an in-place samplesort on an array
+*                of items using several threads and scratch memory from the
+*                heap.  See ParallelSampleSortCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                numThreads - number of threads to use, 0 for one per
+*                             processor
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void ParallelSampleSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), unsigned int numThreads)
+{
+    sort_error_t result;
+
+    result = ParallelSampleSortCtx(NULL, list, numItems, itemSize,
+        compareFunc, numThreads);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : ParallelSampleSortCtx
+*   Description: This function performs an in-place samplesort on an array
+*                of items using several threads.  Partitioning steps that
+*                are large enough are shared by all of the threads, and
+*                then the threads sort the resulting buckets independently.
+*                Lists with few items (or every item in a bucket equal to
+*                every other) are sorted with QuickSort3Way.  If the
+*                buffers can't be allocated, the whole list is sorted with
+*                QuickSort3Way.
+*   Parameters : ctx - context providing scratch memory for the calling
+*                      thread, NULL for the heap.  Other threads use the
+*                      heap.
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                numThreads - number of threads to use, 0 for one per
+*                             processor
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t ParallelSampleSortCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), unsigned int numThreads)
+{
+    samplesort_t *ss;
+    size_t blockItems;
+
+    blockItems = (itemSize < BLOCK_BYTES) ? (BLOCK_BYTES / itemSize) : 1;
+
+    if ((numItems <= BASE_CASE_ITEMS) ||
+        (numItems < (BASE_CASE_BLOCKS * blockItems)))
+    {
+        return QuickSort3WayCtx(ctx, list, numItems, itemSize, compareFunc);
+    }
+
+    if (SortIsSorted(list, numItems, itemSize, compareFunc))
+    {
+        return SORT_OK;
+    }
+
+    if (0 == numThreads)
+    {
+        numThreads = SortDefaultThreads();
+    }
+
+    /* there's no point in threads that won't get a grain of work */
+    if ((numItems / sortTuning.parallelGrain) < numThreads)
+    {
+        numThreads = (unsigned int)(numItems / sortTuning.parallelGrain);
+
+        if (0 == numThreads)
+        {
+            numThreads = 1;
+        }
+    }
+
+    ss = SampleSortCreate(ctx, itemSize, compareFunc, numThreads);
+
+    if (NULL == ss)
+    {
+        return QuickSort3WayCtx(ctx, list, numItems, itemSize, compareFunc);
+    }
+
+    SampleSortParallel(ss, list, numItems);
+    SampleSortFree(ss);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : SampleSortCreate
+*   Description: This function allocates the buffers and locks used to
+*                partition lists of items with a number of threads.
+*   Parameters : ctx - context providing the memory, NULL for the heap
+*                itemSize - size of each item
+*                compareFunc - function used to compare items
+*                numThreads - number of threads the buffers are for
+*   Effects    : Memory is allocated
+*   Returned   : Pointer to the samplesort structure, NULL on failure.
+***************************************************************************/
+static samplesort_t *SampleSortCreate(sort_context_t *ctx, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), unsigned int numThreads)
+{
+    samplesort_t *ss;
+    stripe_t *stripe;
+    size_t blockBytes;
+    unsigned int i;
+
+    ss = (samplesort_t *)ContextCalloc(ctx, 1, sizeof(samplesort_t));
+
+    if (NULL == ss)
+    {
+        return NULL;
+    }
+
+    ss->ctx = ctx;
+    ss->itemSize = itemSize;
+    ss->compareFunc = compareFunc;
+    ss->numThreads = numThreads;
+    ss->blockItems = (itemSize < BLOCK_BYTES) ? (BLOCK_BYTES / itemSize) : 1;
+    blockBytes = ss->blockItems * itemSize;
+
+    ss->tree = ContextAlloc(ctx, MAX_BUCKETS * itemSize);
+    ss->overflow = ContextAlloc(ctx, blockBytes);
+    ss->temp = ContextAlloc(ctx, itemSize);
+    ss->locks = SortLocksCreate(ctx, MAX_BUCKETS);
+    ss->stripes =
+        (stripe_t *)ContextCalloc(ctx, numThreads, sizeof(stripe_t));
+
+    if ((NULL == ss->tree) || (NULL == ss->overflow) ||
+        (NULL == ss->temp) || (NULL == ss->locks) || (NULL == ss->stripes))
+    {
+        SampleSortFree(ss);
+        return NULL;
+    }
+
+    for (i = 0; i < numThreads; i++)
+    {
+        stripe = &ss->stripes[i];
+        stripe->buffers = ContextAlloc(ctx, MAX_BUCKETS * blockBytes);
+        stripe->bufferCounts =
+            (size_t *)ContextAlloc(ctx, 2 * MAX_BUCKETS * sizeof(size_t));
+        stripe->swap[0] = ContextAlloc(ctx, 2 * blockBytes);
+
+        if ((NULL == stripe->buffers) || (NULL == stripe->bufferCounts) ||
+            (NULL == stripe->swap[0]))
+        {
+            SampleSortFree(ss);
+            return NULL;
+        }
+
+        stripe->bucketCounts = &stripe->bufferCounts[MAX_BUCKETS];
+        stripe->swap[1] = VoidPtrOffset(stripe->swap[0], blockBytes);
+    }
+
+    return ss;
+}
+
+/***************************************************************************
+*   Function   : SampleSortFree
+*   Description: This function frees a samplesort structure and everything
+*                that was allocated for it (even if allocation failed part
+*                of the way through).  Memory is freed in the opposite
+*                order that it was allocated, as a context requires.
+*   Parameters : ss - pointer to the samplesort structure
+*   Effects    : Memory is freed
+*   Returned   : NONE
+***************************************************************************/
+static void SampleSortFree(samplesort_t *ss)
+{
+    size_t blockBytes;
+    unsigned int i;
+
+    blockBytes = ss->blockItems * ss->itemSize;
+
+    if (NULL != ss->stripes)
+    {
+        for (i = ss->numThreads; i > 0; i--)
+        {
+            ContextFree(ss->ctx, ss->stripes[i - 1].swap[0], 2 * blockBytes);
+            ContextFree(ss->ctx, ss->stripes[i - 1].bufferCounts,
+                2 * MAX_BUCKETS * sizeof(size_t));
+            ContextFree(ss->ctx, ss->stripes[i - 1].buffers,
+                MAX_BUCKETS * blockBytes);
+        }
+
+        ContextFree(ss->ctx, ss->stripes, ss->numThreads * sizeof(stripe_t));
+    }
+
+    if (NULL != ss->locks)
+    {
+        SortLocksFree(ss->ctx, ss->locks, MAX_BUCKETS);
+    }
+
+    ContextFree(ss->ctx, ss->temp, ss->itemSize);
+    ContextFree(ss->ctx, ss->overflow, blockBytes);
+    ContextFree(ss->ctx, ss->tree, MAX_BUCKETS * ss->itemSize);
+    ContextFree(ss->ctx, ss, sizeof(samplesort_t));
+}
+
+/***************************************************************************
+*   Function   : SampleSortParallel
+*   Description: This function sorts a list using all of the threads that
+*                ss was created for.  The list is partitioned by all of the
+*                threads.  Buckets that are larger than a thread's share of
+*                the list are sorted the same way, one after another.  The
+*                remaining buckets are handed out to the threads to sort on
+*                their own.
+*   Parameters : ss - samplesort structure
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+static void SampleSortParallel(samplesort_t *ss, void *list,
+    size_t numItems)
+{
+    size_t bounds[MAX_BUCKETS + 1];
+    size_t numBuckets, bucket, count;
+    unsigned int numThreads, i;
+    bucket_job_t job;
+
+    numThreads = ss->numThreads;
+
+    if ((numItems / sortTuning.parallelGrain) < numThreads)
+    {
+        numThreads = (unsigned int)(numItems / sortTuning.parallelGrain);
+    }
+
+    if ((numThreads <= 1) || (numItems <= BASE_CASE_ITEMS) ||
+        (numItems < (BASE_CASE_BLOCKS * ss->blockItems)))
+    {
+        SampleSortSequential(ss, list, numItems);
+        return;
+    }
+
+    StatEnter();
+    Partition(ss, list, numItems, numThreads);
+    numBuckets = ss->numBuckets;
+    memcpy(bounds, ss->bucketStart, (numBuckets + 1) * sizeof(size_t));
+
+    job.largest = numItems / ss->numThreads;
+
+    /* buckets with more than a thread's share use all of the threads */
+    for (bucket = 0; bucket < numBuckets; bucket++)
+    {
+        count = bounds[bucket + 1] - bounds[bucket];
+
+        if (count == numItems)
+        {
+            /* no progress was made, the items are probably all equal */
+            QuickSort3WayPartition(list, numItems, ss->itemSize,
+                ss->compareFunc, ss->temp);
+        }
+        else if (count > job.largest)
+        {
+            SampleSortParallel(ss, ItemPtr(ss, list, bounds[bucket]), count);
+        }
+    }
+
+    /* the workers can't share ss->ctx, so take their memory from it now */
+    job.workers = (samplesort_t **)ContextCalloc(ss->ctx, ss->numThreads,
+        sizeof(samplesort_t *));
+
+    if (NULL != job.workers)
+    {
+        job.workers[0] = ss;
+
+        for (i = 1; i < ss->numThreads; i++)
+        {
+            job.workers[i] = SampleSortCreate(ss->ctx, ss->itemSize,
+                ss->compareFunc, 1);
+        }
+    }
+
+    /* without a lock this thread has to sort the rest by itself */
+    job.lock = SortLocksCreate(ss->ctx, 1);
+    job.ss = ss;
+    job.list = list;
+    job.bounds = bounds;
+    job.numBuckets = numBuckets;
+    job.next = 0;
+
+    SortRunThreads((NULL == job.lock) ? 1 : ss->numThreads, SortBuckets,
+        &job);
+
+    if (NULL != job.lock)
+    {
+        SortLocksFree(ss->ctx, job.lock, 1);
+    }
+
+    if (NULL != job.workers)
+    {
+        for (i = ss->numThreads - 1; i > 0; i--)
+        {
+            if (NULL != job.workers[i])
+            {
+                SampleSortFree(job.workers[i]);
+            }
+        }
+
+        ContextFree(ss->ctx, job.workers,
+            ss->numThreads * sizeof(samplesort_t *));
+    }
+
+    StatLeave();
+}
+
+/***************************************************************************
+*   Function   : SortBuckets
+*   Description: This function is run by each thread to sort the buckets
+*                left over by SampleSortParallel.  Threads take the next
+*                unsorted bucket until there are none left.  Thread 0 uses
+*                job->ss, and the other threads use their samplesort
+*                structures in job->workers.  A thread without one sorts
+*                its buckets with QuickSort3Way.
+*   Parameters : arg - pointer to the bucket_job_t
+*                thread - index of the thread
+*   Effects    : The buckets are sorted
+*   Returned   : NONE
+***************************************************************************/
+static void SortBuckets(void *arg, unsigned int thread)
+{
+    bucket_job_t *job;
+    samplesort_t *ss;
+    size_t bucket, count;
+    void *bucketList;
+
+    job = (bucket_job_t *)arg;
+    if (0 == thread)
+    {
+        ss = job->ss;
+    }
+    else
+    {
+        ss = (NULL == job->workers) ? NULL : job->workers[thread];
+    }
+
+    for (;;)
+    {
+        if (NULL != job->lock)
+        {
+            SortLock(job->lock, 0);
+        }
+
+        bucket = job->next;
+        job->next++;
+
+        if (NULL != job->lock)
+        {
+            SortUnlock(job->lock, 0);
+        }
+
+        if (bucket >= job->numBuckets)
+        {
+            break;
+        }
+
+        count = job->bounds[bucket + 1] - job->bounds[bucket];
+
+        if ((count <= 1) || (count > job->largest))
+        {
+            continue;       /* already sorted */
+        }
+
+        bucketList = ItemPtr(job->ss, job->list, job->bounds[bucket]);
+
+        if (NULL == ss)
+        {
+            /* the partitioning is done, so the thread's swap is free */
+            QuickSort3WayPartition(bucketList, count, job->ss->itemSize,
+                job->ss->compareFunc, job->ss->stripes[thread].swap[0]);
+        }
+        else
+        {
+            SampleSortSequential(ss, bucketList, count);
+        }
+    }
+}
+
+/***************************************************************************
+*   Function   : SampleSortSequential
+*   Description: This function sorts a list with a single thread by
+*                partitioning it and sorting each of the buckets the same
+*                way.
+*   Parameters : ss - samplesort structure
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+static void SampleSortSequential(samplesort_t *ss, void *list,
+    size_t numItems)
+{
+    size_t bounds[MAX_BUCKETS + 1];
+    size_t numBuckets, bucket, count;
+
+    if ((numItems <= BASE_CASE_ITEMS) ||
+        (numItems < (BASE_CASE_BLOCKS * ss->blockItems)))
+    {
+        QuickSort3WayPartition(list, numItems, ss->itemSize,
+            ss->compareFunc, ss->temp);
+        return;
+    }
+
+    StatEnter();
+    Partition(ss, list, numItems, 1);
+    numBuckets = ss->numBuckets;
+    memcpy(bounds, ss->bucketStart, (numBuckets + 1) * sizeof(size_t));
+
+    for (bucket = 0; bucket < numBuckets; bucket++)
+    {
+        count = bounds[bucket + 1] - bounds[bucket];
+
+        if (count == numItems)
+        {
+            /* no progress was made, the items are probably all equal */
+            QuickSort3WayPartition(list, numItems, ss->itemSize,
+                ss->compareFunc, ss->temp);
+        }
+        else if (count > 1)
+        {
+            SampleSortSequential(ss, ItemPtr(ss, list, bounds[bucket]),
+                count);
+        }
+    }
+
+    StatLeave();
+}
+
+/***************************************************************************
+*   Function   : Partition
+*   Description: This function partitions a list into buckets so that
+*                every item in a bucket precedes or is ordered the same as
+*                every item in the following buckets.
+*   Parameters : ss - samplesort structure
+*                list - a pointer of an array of items to partition
+*                numItems - number of items in the array
+*                numThreads - number of threads to use (no more than
+*                             ss->numThreads)
+*   Effects    : The contents of list are partitioned and ss->bucketStart
+*                holds the index of the first item of each bucket, followed
+*                by numItems.
+*   Returned   : NONE
+***************************************************************************/
+static void Partition(samplesort_t *ss, void *list, size_t numItems,
+    unsigned int numThreads)
+{
+    size_t stripeItems, fullEnd, sum, bucket, start, stop;
+    unsigned int i;
+
+    ss->list = list;
+    ss->numItems = numItems;
+    ss->activeThreads = numThreads;
+
+    /* use as many buckets as will average BUCKET_BLOCKS blocks */
+    ss->logBuckets = 1;
+
+    while ((ss->logBuckets < MAX_LOG_BUCKETS) &&
+        (((size_t)2 << ss->logBuckets) * BUCKET_BLOCKS * ss->blockItems <=
+        numItems))
+    {
+        ss->logBuckets++;
+    }
+
+    ss->numBuckets = (size_t)1 << ss->logBuckets;
+    SelectSplitters(ss);
+
+    /* each thread classifies a stripe made of whole blocks */
+    stripeItems = RoundUpBlock(ss, (numItems + numThreads - 1) / numThreads);
+
+    for (i = 0; i < numThreads; i++)
+    {
+        start = i * stripeItems;
+        ss->stripes[i].begin = (start < numItems) ? start : numItems;
+        stop = ss->stripes[i].begin + stripeItems;
+        ss->stripes[i].end = (stop < numItems) ? stop : numItems;
+    }
+
+    if (numThreads > 1)
+    {
+        SortRunThreads(numThreads, ClassifyStripe, ss);
+    }
+    else
+    {
+        ClassifyStripe(ss, 0);
+    }
+
+    fullEnd = MoveEmptyBlocks(ss);
+
+    /* find where each bucket starts and the blocks that are in its way */
+    sum = 0;
+
+    for (bucket = 0; bucket < ss->numBuckets; bucket++)
+    {
+        ss->bucketStart[bucket] = sum;
+
+        for (i = 0; i < numThreads; i++)
+        {
+            sum += ss->stripes[i].bucketCounts[bucket];
+        }
+    }
+
+    ss->bucketStart[ss->numBuckets] = numItems;
+
+    for (bucket = 0; bucket < ss->numBuckets; bucket++)
+    {
+        start = RoundUpBlock(ss, ss->bucketStart[bucket]);
+        stop = RoundUpBlock(ss, ss->bucketStart[bucket + 1]);
+        ss->writePtr[bucket] = start;
+
+        if (fullEnd < stop)
+        {
+            stop = fullEnd;
+        }
+
+        ss->readEnd[bucket] = (stop > start) ? stop : start;
+    }
+
+    ss->overflowBucket = MAX_BUCKETS;
+
+    if (numThreads > 1)
+    {
+        SortRunThreads(numThreads, PermuteBlocks, ss);
+    }
+    else
+    {
+        PermuteBlocks(ss, 0);
+    }
+
+    Cleanup(ss);
+}
+
+/***************************************************************************
+*   Function   : SelectSplitters
+*   Description: This function draws a random sample from the list being
+*                partitioned, sorts it, and builds the splitter tree from
+*                evenly spaced sample items.  The sample is swapped to the
+*                front of the list, so it is still partitioned with the
+*                other items.
+*   Parameters : ss - samplesort structure
+*   Effects    : Items are moved to the front of the list and the splitter
+*                tree is built.
+*   Returned   : NONE
+***************************************************************************/
+static void SelectSplitters(samplesort_t *ss)
+{
+    size_t sampleSize, oversample, i, j, log2Items;
+    unsigned long seed, random;
+    void *temp;
+
+    for (log2Items = 0; ((size_t)1 << log2Items) < ss->numItems; log2Items++)
+    {
+        /* find log2(numItems) */
+    }
+
+    oversample = 1 + (log2Items / OVERSAMPLE_DIVISOR);
+    sampleSize = (ss->numBuckets * oversample) - 1;
+
+    if (sampleSize > (ss->numItems / 2))
+    {
+        sampleSize = ss->numItems / 2;
+    }
+
+    /* swap random items to the front (the seed makes sorts repeatable) */
+    temp = ss->stripes[0].swap[0];
+    seed = (unsigned long)ss->numItems;
+
+    for (i = 0; i < sampleSize; i++)
+    {
+        random = 0;
+
+        for (j = 0; j < 3; j++)
+        {
+            seed = (seed * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+            random = (random << 15) ^ ((seed >> 16) & 0x7FFF);
+        }
+
+        j = i + (size_t)(random % (unsigned long)(ss->numItems - i));
+
+        if (j != i)
+        {
+            Swap(ItemPtr(ss, ss->list, i), ItemPtr(ss, ss->list, j), temp,
+                ss->itemSize);
+        }
+    }
+
+    QuickSort3WayPartition(ss->list, sampleSize, ss->itemSize,
+        ss->compareFunc, ss->temp);
+
+    /* splitter r is sample item ((r + 1) * (sampleSize + 1) / buckets) - 1 */
+    BuildTree(ss, 1, 0, ss->numBuckets - 2, sampleSize + 1);
+}
+
+/***************************************************************************
+*   Function   : BuildTree
+*   Description: This function stores splitters in an implicit binary
+*                search tree (the children of node n are nodes 2n and
+*                2n + 1), so that classifying an item takes the same
+*                sequence of steps regardless of its value.
+*   Parameters : ss - samplesort structure with a sorted sample at the
+*                     front of its list
+*                node - tree node to fill
+*                first - rank of the first splitter in the subtree
+*                last - rank of the last splitter in the subtree
+*                step - sample size + 1
+*   Effects    : The subtree rooted at node is filled
+*   Returned   : NONE
+***************************************************************************/
+static void BuildTree(samplesort_t *ss, size_t node, size_t first,
+    size_t last, size_t step)
+{
+    size_t mid;
+
+    mid = first + ((last - first) / 2);
+
+    CopyItem(ItemPtr(ss, ss->tree, node),
+        ItemPtr(ss, ss->list, (((mid + 1) * step) / ss->numBuckets) - 1),
+        ss->itemSize);
+
+    if ((2 * node) < ss->numBuckets)
+    {
+        BuildTree(ss, 2 * node, first, mid - 1, step);
+        BuildTree(ss, (2 * node) + 1, mid + 1, last, step);
+    }
+}
+
+/***************************************************************************
+*   Function   : Classify
+*   Description: This function finds the bucket an item belongs in by
+*                walking the splitter tree.  The bucket is the number of
+*                splitters that precede the item.
+*   Parameters : ss - samplesort structure
+*                item - item to classify
+*   Effects    : NONE
+*   Returned   : The item's bucket
+***************************************************************************/
+static size_t Classify(const samplesort_t *ss, const void *item)
+{
+    size_t node;
+    unsigned int level;
+
+    node = 1;
+
+    for (level = 0; level < ss->logBuckets; level++)
+    {
+        node = (2 * node) + (CompareItems(ss->compareFunc,
+            ItemPtr(ss, ss->tree, node), item) < 0);
+    }
+
+    return node - ss->numBuckets;
+}
+
+/***************************************************************************
+*   Function   : ClassifyStripe
+*   Description: This function is run by each thread to classify the items
+*                in its stripe.  CLASSIFY_UNROLL items walk the splitter
+*                tree together, so the comparisons for different items
+*                don't have to wait on each other.  Items are collected in
+*                the bucket buffers, and full buffers are written back to
+*                the stripe.
+*   Parameters : arg - pointer to the samplesort structure
+*                thread - index of the thread (and stripe)
+*   Effects    : The stripe begins with full blocks, the buffers hold the
+*                remaining items, and the counts are updated.
+*   Returned   : NONE
+***************************************************************************/
+static void ClassifyStripe(void *arg, unsigned int thread)
+{
+    samplesort_t *ss;
+    stripe_t *stripe;
+    size_t i, node[CLASSIFY_UNROLL];
+    unsigned int level, j;
+
+    ss = (samplesort_t *)arg;
+    stripe = &ss->stripes[thread];
+
+    memset(stripe->bufferCounts, 0, ss->numBuckets * sizeof(size_t));
+    memset(stripe->bucketCounts, 0, ss->numBuckets * sizeof(size_t));
+    stripe->written = stripe->begin;
+
+    for (i = stripe->begin; (i + CLASSIFY_UNROLL) <= stripe->end;
+        i += CLASSIFY_UNROLL)
+    {
+        for (j = 0; j < CLASSIFY_UNROLL; j++)
+        {
+            node[j] = 1;
+        }
+
+        for (level = 0; level < ss->logBuckets; level++)
+        {
+            for (j = 0; j < CLASSIFY_UNROLL; j++)
+            {
+                node[j] = (2 * node[j]) + (CompareItems(ss->compareFunc,
+                    ItemPtr(ss, ss->tree, node[j]),
+                    ItemPtr(ss, ss->list, i + j)) < 0);
+            }
+        }
+
+        for (j = 0; j < CLASSIFY_UNROLL; j++)
+        {
+            AddToBuffer(ss, stripe, node[j] - ss->numBuckets,
+                ItemPtr(ss, ss->list, i + j));
+        }
+    }
+
+    for (; i < stripe->end; i++)
+    {
+        AddToBuffer(ss, stripe, Classify(ss, ItemPtr(ss, ss->list, i)),
+            ItemPtr(ss, ss->list, i));
+    }
+}
+
+/***************************************************************************
+*   Function   : AddToBuffer
+*   Description: This function adds an item to a bucket's buffer.  When the
+*                buffer is full, it is written to the next block of the
+*                stripe.  At least a block of items has been read past the
+*                end of the written blocks, so nothing unread is
+*                overwritten.
+*   Parameters : ss - samplesort structure
+*                stripe - the stripe being classified
+*                bucket - the item's bucket
+*                item - the item
+*   Effects    : The item is buffered and the buffer may be written
+*   Returned   : NONE
+***************************************************************************/
+static void AddToBuffer(samplesort_t *ss, stripe_t *stripe, size_t bucket,
+    const void *item)
+{
+    void *buffer;
+
+    buffer = ItemPtr(ss, stripe->buffers, bucket * ss->blockItems);
+    CopyItem(ItemPtr(ss, buffer, stripe->bufferCounts[bucket]), item,
+        ss->itemSize);
+    stripe->bucketCounts[bucket]++;
+    stripe->bufferCounts[bucket]++;
+
+    if (stripe->bufferCounts[bucket] == ss->blockItems)
+    {
+        CopyItems(ItemPtr(ss, ss->list, stripe->written), buffer,
+            ss->blockItems, ss->itemSize);
+        stripe->written += ss->blockItems;
+        stripe->bufferCounts[bucket] = 0;
+    }
+}
+
+/***************************************************************************
+*   Function   : MoveEmptyBlocks
+*   Description: This function moves full blocks from the end of the last
+*                stripes into the empty blocks at the end of the first
+*                stripes, so that all of the full blocks are at the front
+*                of the list.
+*   Parameters : ss - samplesort structure
+*   Effects    : Full blocks are moved
+*   Returned   : The end of the full blocks
+***************************************************************************/
+static size_t MoveEmptyBlocks(samplesort_t *ss)
+{
+    size_t fullEnd, dstPos, srcPos;
+    unsigned int dst, src;
+
+    fullEnd = 0;
+
+    for (dst = 0; dst < ss->activeThreads; dst++)
+    {
+        fullEnd += ss->stripes[dst].written - ss->stripes[dst].begin;
+    }
+
+    dst = 0;
+    dstPos = ss->stripes[dst].written;
+    src = ss->activeThreads - 1;
+    srcPos = ss->stripes[src].written;
+
+    for (;;)
+    {
+        /* find an empty block */
+        while ((dst < src) && (dstPos == ss->stripes[dst].end))
+        {
+            dst++;
+            dstPos = ss->stripes[dst].written;
+        }
+
+        /* find the last full block after it */
+        while ((src > dst) && (srcPos == ss->stripes[src].begin))
+        {
+            src--;
+            srcPos = ss->stripes[src].written;
+        }
+
+        if (dst >= src)
+        {
+            break;
+        }
+
+        srcPos -= ss->blockItems;
+        CopyItems(ItemPtr(ss, ss->list, dstPos),
+            ItemPtr(ss, ss->list, srcPos), ss->blockItems, ss->itemSize);
+        dstPos += ss->blockItems;
+    }
+
+    return fullEnd;
+}
+
+/***************************************************************************
+*   Function   : SkipPlacedBlocks
+*   Description: This function advances a bucket's write pointer past any
+*                unread blocks that already belong in the bucket.  The
+*                caller must hold the bucket's lock.
+*   Parameters : ss - samplesort structure
+*                bucket - the bucket
+*   Effects    : ss->writePtr[bucket] may advance
+*   Returned   : NONE
+***************************************************************************/
+static void SkipPlacedBlocks(samplesort_t *ss, size_t bucket)
+{
+    while ((ss->writePtr[bucket] < ss->readEnd[bucket]) &&
+        (Classify(ss, ItemPtr(ss, ss->list, ss->writePtr[bucket])) == bucket))
+    {
+        ss->writePtr[bucket] += ss->blockItems;
+    }
+}
+
+/***************************************************************************
+*   Function   : PermuteBlocks
+*   Description: This function is run by each thread to move the full
+*                blocks into the buckets they belong to.  A thread reads an
+*                unplaced block from the end of a bucket's unread blocks,
+*                then swaps it with the block at its bucket's write pointer
+*                until it lands in an empty block.  Reading and moving the
+*                pointers is done while holding the bucket's lock.  Blocks
+*                behind a write pointer belong to the thread that moved the
+*                pointer, so they are swapped without holding the lock.
+*                The only block that might extend past the end of the list
+*                goes to the overflow buffer.
+*   Parameters : arg - pointer to the samplesort structure
+*                thread - index of the thread
+*   Effects    : The blocks of each bucket are between its first block and
+*                its write pointer.
+*   Returned   : NONE
+***************************************************************************/
+static void PermuteBlocks(void *arg, unsigned int thread)
+{
+    samplesort_t *ss;
+    stripe_t *stripe;
+    size_t bucket, visited, dest, pos;
+    void *block, *spare, *swap;
+    bool_t occupied;
+
+    ss = (samplesort_t *)arg;
+    stripe = &ss->stripes[thread];
+    block = stripe->swap[0];
+    spare = stripe->swap[1];
+
+    /* spread the threads out over the buckets */
+    bucket = (thread * ss->numBuckets) / ss->activeThreads;
+
+    for (visited = 0; visited < ss->numBuckets; visited++)
+    {
+        for (;;)
+        {
+            SortLock(ss->locks, bucket);
+            SkipPlacedBlocks(ss, bucket);
+
+            if (ss->writePtr[bucket] >= ss->readEnd[bucket])
+            {
+                SortUnlock(ss->locks, bucket);
+                break;
+            }
+
+            ss->readEnd[bucket] -= ss->blockItems;
+            CopyItems(block, ItemPtr(ss, ss->list, ss->readEnd[bucket]),
+                ss->blockItems, ss->itemSize);
+            SortUnlock(ss->locks, bucket);
+
+            /* move the block until it lands in an empty block */
+            do
+            {
+                dest = Classify(ss, block);
+
+                SortLock(ss->locks, dest);
+                SkipPlacedBlocks(ss, dest);
+                pos = ss->writePtr[dest];
+                occupied = (pos < ss->readEnd[dest]);
+                ss->writePtr[dest] += ss->blockItems;
+                SortUnlock(ss->locks, dest);
+
+                if (occupied)
+                {
+                    CopyItems(spare, ItemPtr(ss, ss->list, pos),
+                        ss->blockItems, ss->itemSize);
+                    CopyItems(ItemPtr(ss, ss->list, pos), block,
+                        ss->blockItems, ss->itemSize);
+
+                    swap = block;
+                    block = spare;
+                    spare = swap;
+                }
+                else if ((pos + ss->blockItems) > ss->numItems)
+                {
+                    CopyItems(ss->overflow, block, ss->blockItems,
+                        ss->itemSize);
+                    ss->overflowBucket = dest;
+                }
+                else
+                {
+                    CopyItems(ItemPtr(ss, ss->list, pos), block,
+                        ss->blockItems, ss->itemSize);
+                }
+            } while (occupied);
+        }
+
+        bucket = (bucket + 1) % ss->numBuckets;
+    }
+}
+
+/***************************************************************************
+*   Function   : Cleanup
+*   Description: This function finishes partitioning.  The blocks of a
+*                bucket start at the first block boundary in the bucket, so
+*                the last block may run into the next bucket.  Items that
+*                ran over are moved to the front of the bucket, and the
+*                items left in the buffers (and the overflow block) fill in
+*                whatever space remains in the bucket.
+*   Parameters : ss - samplesort structure
+*   Effects    : Every item is in its bucket
+*   Returned   : NONE
+***************************************************************************/
+static void Cleanup(samplesort_t *ss)
+{
+    size_t bucket, start, stop, blockStart, blockEnd, spill;
+    size_t pos, end, tailStart, count, n;
+    unsigned int i;
+    void *src;
+
+    for (bucket = 0; bucket < ss->numBuckets; bucket++)
+    {
+        start = ss->bucketStart[bucket];
+        stop = ss->bucketStart[bucket + 1];
+        blockStart = RoundUpBlock(ss, start);
+        blockEnd = ss->writePtr[bucket];
+
+        if (ss->overflowBucket == bucket)
+        {
+            blockEnd -= ss->blockItems;
+        }
+
+        pos = start;
+
+        if ((blockEnd > blockStart) && (blockEnd > stop))
+        {
+            /* move items that ran into the next bucket to the front */
+            spill = blockEnd - stop;
+            CopyItems(ItemPtr(ss, ss->list, start),
+                ItemPtr(ss, ss->list, stop), spill, ss->itemSize);
+            pos += spill;
+            blockEnd = stop;
+        }
+
+        /* fill [pos, end) then [tailStart, stop) */
+        end = (blockStart < stop) ? blockStart : stop;
+        tailStart = (blockEnd < stop) ? blockEnd : stop;
+
+        for (i = 0; i <= ss->activeThreads; i++)
+        {
+            if (i < ss->activeThreads)
+            {
+                src = ItemPtr(ss, ss->stripes[i].buffers,
+                    bucket * ss->blockItems);
+                count = ss->stripes[i].bufferCounts[bucket];
+            }
+            else if (ss->overflowBucket == bucket)
+            {
+                src = ss->overflow;
+                count = ss->blockItems;
+            }
+            else
+            {
+                break;
+            }
+
+            while (count > 0)
+            {
+                if (pos == end)
+                {
+                    pos = tailStart;
+                    end = stop;
+                }
+
+                n = ((end - pos) < count) ? (end - pos) : count;
+                CopyItems(ItemPtr(ss, ss->list, pos), src, n, ss->itemSize);
+                pos += n;
+                src = ItemPtr(ss, src, n);
+                count -= n;
+            }
+        }
+    }
+}
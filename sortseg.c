@@ -0,0 +1,395 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortseg.c
+*   Purpose : This module implements a segmented sort, which sorts many
+*             small independent segments of one list in a single call.
+*             Segments of up to 8 items are sorted with sorting networks,
+*             short segments with insertion sort, and longer ones with a
+*             three-way quick sort.  The segments are put in order of
+*             size, so segments sorted the same way are sorted one after
+*             another, and the work may be divided among several threads.
+*             No memory is allocated for each segment.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <assert.h>
+#include "sort.h"
+#include "sortint.h"
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* segments this small are sorted with a sorting network */
+#define MAX_NETWORK_ITEMS   8
+
+/* size classes, one for each bit length of a segment size */
+#define NUM_CLASSES         ((sizeof(size_t) * 8) + 1)
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* segments shared by the threads sorting them */
+typedef struct
+{
+    void *list;                 /* list holding the segments */
+    size_t itemSize;            /* size of each item */
+    int (*compareFunc) (const void *, const void *);
+    const size_t *offsets;      /* segment i is [offsets[i], offsets[i+1]) */
+    const size_t *order;        /* segment indices from smallest to largest */
+    const size_t *bounds;       /* thread i sorts order[bounds[i]] .. */
+    void *temps;                /* a temporary item for each thread */
+} segment_job_t;
+
+/***************************************************************************
+*                            GLOBAL VARIABLES
+***************************************************************************/
+/* compare-exchange pairs of the smallest known sorting networks */
+static const unsigned char networkPairs[][2] =
+{
+    /* 2 items */
+    {0, 1},
+    /* 3 items */
+    {0, 2}, {0, 1}, {1, 2},
+    /* 4 items */
+    {0, 2}, {1, 3}, {0, 1}, {2, 3}, {1, 2},
+    /* 5 items */
+    {0, 3}, {1, 4}, {0, 2}, {1, 3}, {0, 1}, {2, 4}, {1, 2}, {3, 4},
+    {2, 3},
+    /* 6 items */
+    {0, 5}, {1, 3}, {2, 4}, {1, 2}, {3, 4}, {0, 3}, {2, 5}, {0, 1},
+    {2, 3}, {4, 5}, {1, 2}, {3, 4},
+    /* 7 items */
+    {0, 6}, {2, 3}, {4, 5}, {0, 2}, {1, 4}, {3, 6}, {0, 1}, {2, 5},
+    {3, 4}, {1, 2}, {4, 6}, {2, 3}, {4, 5}, {1, 2}, {3, 4}, {5, 6},
+    /* 8 items */
+    {0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7},
+    {0, 1}, {2, 3}, {4, 5}, {6, 7}, {2, 4}, {3, 5}, {1, 4}, {3, 6},
+    {1, 2}, {3, 4}, {5, 6}
+};
+
+/* index of the first pair of the network for N items, N = 0 .. 9 */
+static const unsigned char networkStart[MAX_NETWORK_ITEMS + 2] =
+{
+    0, 0, 0, 1, 4, 9, 18, 30, 46, 65
+};
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static unsigned int SizeClass(size_t numItems);
+static void SortSegmentRange(void *arg, unsigned int thread);
+static void SortSegment(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), void *temp);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : SortSegments
+*   Description: This function sorts each segment of a list using scratch
+*                memory from the heap.  See SortSegmentsCtx.
+*   Parameters : list - a pointer to an array of items holding the segments
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                offsets - numSegments + 1 non-decreasing indices, segment
+*                          i is list[offsets[i]] .. list[offsets[i+1] - 1]
+*                numSegments - number of segments
+*                numThreads - threads sorting segments, 0 for one per
+*                             processor
+*   Effects    : Each segment of list is sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void SortSegments(void *list, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), const size_t *offsets,
+    size_t numSegments, unsigned int numThreads)
+{
+    sort_error_t result;
+    size_t i;
+
+    result = SortSegmentsCtx(NULL, list, itemSize, compareFunc, offsets,
+        numSegments, numThreads);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        for (i = 0; i < numSegments; i++)
+        {
+            result = HeapSortCtx(NULL,
+                VoidPtrOffset(list, offsets[i] * itemSize),
+                offsets[i + 1] - offsets[i], itemSize, compareFunc);
+        }
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : SortSegmentsCtx
+*   Description: This function sorts each segment of a list.  The segment
+*                indices are counting sorted by the bit length of their
+*                sizes, so segments of similar size are sorted together.
+*                When more than one thread is used, each thread is given a
+*                range of the ordered segments holding about the same
+*                number of items.  The sort isn't stable.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer to an array of items holding the segments
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                offsets - numSegments + 1 non-decreasing indices, segment
+*                          i is list[offsets[i]] .. list[offsets[i+1] - 1]
+*                numSegments - number of segments
+*                numThreads - threads sorting segments, 0 for one per
+*                             processor
+*   Effects    : Each segment of list is sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available, SORT_ERR_PARAM if offsets decrease.
+***************************************************************************/
+sort_error_t SortSegmentsCtx(sort_context_t *ctx, void *list,
+    size_t itemSize, int (*compareFunc) (const void *, const void *),
+    const size_t *offsets, size_t numSegments, unsigned int numThreads)
+{
+    size_t classStart[NUM_CLASSES + 1];     /* counts, then first index */
+    size_t *order, *bounds;
+    size_t i, totalItems, items;
+    unsigned int thread, c;
+    segment_job_t job;
+
+    for (c = 0; c <= NUM_CLASSES; c++)
+    {
+        classStart[c] = 0;
+    }
+
+    /* count the segments in each size class */
+    for (i = 0; i < numSegments; i++)
+    {
+        if (offsets[i + 1] < offsets[i])
+        {
+            return SORT_ERR_PARAM;
+        }
+
+        classStart[SizeClass(offsets[i + 1] - offsets[i]) + 1]++;
+    }
+
+    if ((0 == numSegments) || (offsets[numSegments] == offsets[0]))
+    {
+        return SORT_OK;
+    }
+
+    totalItems = offsets[numSegments] - offsets[0];
+
+    if (0 == numThreads)
+    {
+        numThreads = SortDefaultThreads();
+    }
+
+    /* there's no point in threads that won't get a grain of work */
+    if ((totalItems / sortTuning.parallelGrain) < numThreads)
+    {
+        numThreads = (unsigned int)(totalItems / sortTuning.parallelGrain);
+
+        if (0 == numThreads)
+        {
+            numThreads = 1;
+        }
+    }
+
+    job.temps = ContextAlloc(ctx, numThreads * itemSize);
+
+    if (NULL == job.temps)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    order = (size_t *)ContextAlloc(ctx, numSegments * sizeof(size_t));
+
+    if (NULL == order)
+    {
+        ContextFree(ctx, job.temps, numThreads * itemSize);
+        return SORT_ERR_NOMEM;
+    }
+
+    bounds = (size_t *)ContextAlloc(ctx, (numThreads + 1) * sizeof(size_t));
+
+    if (NULL == bounds)
+    {
+        ContextFree(ctx, order, numSegments * sizeof(size_t));
+        ContextFree(ctx, job.temps, numThreads * itemSize);
+        return SORT_ERR_NOMEM;
+    }
+
+    /* counting sort the segment indices by size class */
+    for (c = 1; c <= NUM_CLASSES; c++)
+    {
+        classStart[c] += classStart[c - 1];
+    }
+
+    for (i = 0; i < numSegments; i++)
+    {
+        c = SizeClass(offsets[i + 1] - offsets[i]);
+        order[classStart[c]] = i;
+        classStart[c]++;
+    }
+
+    /* give each thread about the same number of items */
+    bounds[0] = 0;
+    thread = 1;
+    items = 0;
+
+    for (i = 0; (i < numSegments) && (thread < numThreads); i++)
+    {
+        items += offsets[order[i] + 1] - offsets[order[i]];
+
+        while ((thread < numThreads) &&
+            (items >= ((totalItems / numThreads) * thread)))
+        {
+            bounds[thread] = i + 1;
+            thread++;
+        }
+    }
+
+    for (; thread <= numThreads; thread++)
+    {
+        bounds[thread] = numSegments;
+    }
+
+    job.list = list;
+    job.itemSize = itemSize;
+    job.compareFunc = compareFunc;
+    job.offsets = offsets;
+    job.order = order;
+    job.bounds = bounds;
+
+    SortRunThreads(numThreads, SortSegmentRange, &job);
+
+    ContextFree(ctx, bounds, (numThreads + 1) * sizeof(size_t));
+    ContextFree(ctx, order, numSegments * sizeof(size_t));
+    ContextFree(ctx, job.temps, numThreads * itemSize);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : SizeClass
+*   Description: This function returns the size class of a segment, the
+*                number of bits needed to hold its size.
+*   Parameters : numItems - number of items in the segment
+*   Effects    : NONE
+*   Returned   : 0 for an empty segment, otherwise floor(log2(N)) + 1.
+***************************************************************************/
+static unsigned int SizeClass(size_t numItems)
+{
+    unsigned int bits;
+
+    for (bits = 0; numItems > 0; numItems >>= 1)
+    {
+        bits++;
+    }
+
+    return bits;
+}
+
+/***************************************************************************
+*   Function   : SortSegmentRange
+*   Description: This function is called by each thread of a segmented
+*                sort.  It sorts the segments from order[bounds[thread]] up
+*                to order[bounds[thread + 1]].
+*   Parameters : arg - pointer to the segment_job_t
+*                thread - index of this thread
+*   Effects    : The thread's segments are sorted
+*   Returned   : NONE
+***************************************************************************/
+static void SortSegmentRange(void *arg, unsigned int thread)
+{
+    segment_job_t *job;
+    size_t i, segment;
+    void *temp;
+
+    job = (segment_job_t *)arg;
+    temp = VoidPtrOffset(job->temps, thread * job->itemSize);
+
+    for (i = job->bounds[thread]; i < job->bounds[thread + 1]; i++)
+    {
+        segment = job->order[i];
+        SortSegment(VoidPtrOffset(job->list,
+            job->offsets[segment] * job->itemSize),
+            job->offsets[segment + 1] - job->offsets[segment],
+            job->itemSize, job->compareFunc, temp);
+    }
+}
+
+/***************************************************************************
+*   Function   : SortSegment
+*   Description: This function sorts one segment with the method suited to
+*                its size: a sorting network for up to MAX_NETWORK_ITEMS
+*                items, otherwise a three-way quick sort, which insertion
+*                sorts lists of up to the insertion sort cutoff.
+*   Parameters : list - a pointer to the first item of the segment
+*                numItems - number of items in the segment
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function (see SortSegments)
+*                temp - a temporary item
+*   Effects    : The segment is sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+static void SortSegment(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), void *temp)
+{
+    unsigned int pair;
+    void *a, *b;
+
+    if (numItems > MAX_NETWORK_ITEMS)
+    {
+        QuickSort3WayPartition(list, numItems, itemSize, compareFunc, temp);
+        return;
+    }
+
+    for (pair = networkStart[numItems];
+        pair < networkStart[numItems + 1];
+        pair++)
+    {
+        a = VoidPtrOffset(list, networkPairs[pair][0] * itemSize);
+        b = VoidPtrOffset(list, networkPairs[pair][1] * itemSize);
+
+        if (CompareItems(compareFunc, a, b) > 0)
+        {
+            Swap(a, b, temp, itemSize);
+        }
+    }
+}
@@ -0,0 +1,492 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortshell.c
+*   Purpose : This module implements a Shell sort with a selectable gap
+*             sequence (Knuth, Sedgewick, Tokuda, Ciura, or one supplied
+*             by the caller).  For each gap h, the list is made up of h
+*             interleaved chains that may be insertion sorted
+*             independently.  The chains are grouped into tiles of
+*             neighboring chains, so each row of a tile is a contiguous
+*             run of memory, and the tiles may be sorted by several
+*             threads at once.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <assert.h>
+#include "sort.h"
+#include "sortint.h"
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* enough for any generated sequence with gaps below 2^64 */
+#define MAX_GAPS            64
+
+/* tiles are at least this many bytes wide, so threads don't share lines */
+#define CACHE_LINE_BYTES    64
+
+/* a tile row is at most this fraction of the level 1 data cache */
+#define TILE_L1D_DIVISOR    8
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* one gap's h-sort, shared by the threads sorting its tiles */
+typedef struct
+{
+    void *list;                 /* list being sorted */
+    size_t numItems;            /* number of items in list */
+    size_t itemSize;            /* size of each item */
+    int (*compareFunc) (const void *, const void *);
+    size_t gap;                 /* distance between items in a chain */
+    size_t tileChains;          /* chains in each tile */
+    size_t numTiles;            /* tiles for this gap */
+    unsigned int numThreads;    /* threads sorting tiles */
+    void *temps;                /* a temporary item for each thread */
+} h_sort_t;
+
+/***************************************************************************
+*                            GLOBAL VARIABLES
+***************************************************************************/
+/* gaps found experimentally by Marcin Ciura, extended by 2.25x */
+static const size_t ciuraGaps[] =
+{
+    1, 4, 10, 23, 57, 132, 301, 701, 1750
+};
+
+#define NUM_CIURA_GAPS  (sizeof(ciuraGaps) / sizeof(ciuraGaps[0]))
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static size_t MakeGaps(sort_gaps_t gapType, size_t numItems, size_t *gaps);
+static void HSortChains(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t gap,
+    size_t first, size_t last, void *temp);
+static void HSortTiles(void *arg, unsigned int thread);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : ShellSortGaps
+*   Description: This function performs a Shell sort with the requested
+*                gap sequence using scratch memory from the heap.  See
+*                ShellSortGapsCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                gapType - gap sequence to use
+*                gaps - increasing gaps starting with 1 (SORT_GAPS_CUSTOM)
+*                numGaps - number of gaps in gaps (SORT_GAPS_CUSTOM)
+*                numThreads - threads sorting tiles of chains, 0 for one
+*                             per processor
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+void ShellSortGaps(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), sort_gaps_t gapType,
+    const size_t *gaps, size_t numGaps, unsigned int numThreads)
+{
+    sort_error_t result;
+
+    result = ShellSortGapsCtx(NULL, list, numItems, itemSize, compareFunc,
+        gapType, gaps, numGaps, numThreads);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        result = HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+}
+
+/***************************************************************************
+*   Function   : ShellSortGapsCtx
+*   Description: This function performs a Shell sort with the requested
+*                gap sequence.  For each gap, the chains of items that are
+*                gap apart are insertion sorted.  Neighboring chains are
+*                grouped into tiles and sorted a row at a time, so the
+*                items compared and moved together share cache lines.
+*                When more than one thread is requested and the list is
+*                large enough, the tiles of the larger gaps are divided
+*                among the threads.  The smaller gaps are always sorted by
+*                the calling thread.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                gapType - gap sequence to use
+*                gaps - increasing gaps starting with 1 (SORT_GAPS_CUSTOM)
+*                numGaps - number of gaps in gaps (SORT_GAPS_CUSTOM)
+*                numThreads - threads sorting tiles of chains, 0 for one
+*                             per processor
+*   Effects    : The contents of list are sorted in ascending order
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available, SORT_ERR_PARAM if the custom gaps don't
+*                start with 1 or aren't increasing.
+***************************************************************************/
+sort_error_t ShellSortGapsCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), sort_gaps_t gapType,
+    const size_t *gaps, size_t numGaps, unsigned int numThreads)
+{
+    size_t madeGaps[MAX_GAPS];
+    size_t maxTileChains, lineChains, i;
+    h_sort_t job;
+
+    if (SORT_GAPS_CUSTOM == gapType)
+    {
+        if ((0 == numGaps) || (NULL == gaps) || (1 != gaps[0]))
+        {
+            return SORT_ERR_PARAM;
+        }
+
+        for (i = 1; i < numGaps; i++)
+        {
+            if (gaps[i] <= gaps[i - 1])
+            {
+                return SORT_ERR_PARAM;
+            }
+        }
+
+        /* gaps at least as large as the list don't do anything */
+        while (gaps[numGaps - 1] >= numItems)
+        {
+            numGaps--;
+
+            if (0 == numGaps)
+            {
+                return SORT_OK;     /* 0 or 1 items */
+            }
+        }
+    }
+    else
+    {
+        numGaps = MakeGaps(gapType, numItems, madeGaps);
+        gaps = madeGaps;
+
+        if (0 == numGaps)
+        {
+            return SORT_OK;
+        }
+    }
+
+    if (0 == numThreads)
+    {
+        numThreads = SortDefaultThreads();
+    }
+
+    /* there's no point in threads that won't get a grain of work */
+    if ((numItems / sortTuning.parallelGrain) < numThreads)
+    {
+        numThreads = (unsigned int)(numItems / sortTuning.parallelGrain);
+
+        if (0 == numThreads)
+        {
+            numThreads = 1;
+        }
+    }
+
+    job.temps = ContextAlloc(ctx, numThreads * itemSize);
+
+    if (NULL == job.temps)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    job.list = list;
+    job.numItems = numItems;
+    job.itemSize = itemSize;
+    job.compareFunc = compareFunc;
+
+    /* tile rows are whole cache lines that fit in a part of L1 */
+    lineChains = (itemSize < CACHE_LINE_BYTES) ?
+        (CACHE_LINE_BYTES / itemSize) : 1;
+    maxTileChains = sortTuning.l1dCacheBytes / (TILE_L1D_DIVISOR * itemSize);
+
+    if (maxTileChains < lineChains)
+    {
+        maxTileChains = lineChains;
+    }
+
+    /* loop through partial sorts, largest gap first */
+    while (numGaps > 0)
+    {
+        numGaps--;
+        job.gap = gaps[numGaps];
+
+        /* give each thread a share of the chains, a line at a time */
+        job.tileChains = (job.gap + numThreads - 1) / numThreads;
+        job.tileChains =
+            ((job.tileChains + lineChains - 1) / lineChains) * lineChains;
+
+        if (job.tileChains > maxTileChains)
+        {
+            job.tileChains = maxTileChains;
+        }
+
+        job.numTiles = (job.gap + job.tileChains - 1) / job.tileChains;
+        job.numThreads = numThreads;
+
+        if (job.numTiles < numThreads)
+        {
+            job.numThreads = (unsigned int)job.numTiles;
+        }
+
+        if (job.numThreads > 1)
+        {
+            SortRunThreads(job.numThreads, HSortTiles, &job);
+        }
+        else
+        {
+            /* one tile of every chain is the ordinary h-sort */
+            HSortChains(list, numItems, itemSize, compareFunc, job.gap,
+                0, job.gap, job.temps);
+        }
+    }
+
+    ContextFree(ctx, job.temps, numThreads * itemSize);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : MakeGaps
+*   Description: This function makes the gaps of a generated sequence that
+*                are smaller than the number of items being sorted.
+*                  Knuth:     (3^k - 1) / 2 = 1, 4, 13, 40, 121, ...
+*                  Sedgewick: 1, 4^k + 3 * 2^(k - 1) + 1 = 8, 23, 77, ...
+*                  Tokuda:    ceil(h(k)), h(k) = 2.25 * h(k - 1) + 1
+*                             = 1, 4, 9, 20, 46, 103, ...
+*                  Ciura:     1, 4, 10, 23, 57, 132, 301, 701, 1750, then
+*                             2.25 times the previous gap
+*   Parameters : gapType - gap sequence to make
+*                numItems - number of items being sorted
+*                gaps - array of at least MAX_GAPS receiving the gaps
+*   Effects    : The gaps are written to gaps in increasing order
+*   Returned   : Number of gaps (0 if there are fewer than 2 items).
+***************************************************************************/
+static size_t MakeGaps(sort_gaps_t gapType, size_t numItems, size_t *gaps)
+{
+    size_t count, gap, power;
+    double exact;
+
+    count = 0;
+
+    if (numItems < 2)
+    {
+        return 0;
+    }
+
+    switch (gapType)
+    {
+        case SORT_GAPS_KNUTH:
+            for (gap = 1;
+                (gap < numItems) && (count < MAX_GAPS);
+                gap = (gap * 3) + 1)
+            {
+                gaps[count] = gap;
+                count++;
+
+                if (gap > (((size_t)-1 - 1) / 3))
+                {
+                    break;      /* next gap would overflow */
+                }
+            }
+            break;
+
+        case SORT_GAPS_SEDGEWICK:
+            gaps[count] = 1;
+            count++;
+
+            for (power = 1; count < MAX_GAPS; power *= 2)
+            {
+                exact = (4.0 * power * power) + (3.0 * power) + 1.0;
+
+                if (exact >= (double)numItems)
+                {
+                    break;
+                }
+
+                gaps[count] = (size_t)exact;
+                count++;
+            }
+            break;
+
+        case SORT_GAPS_TOKUDA:
+            for (exact = 1.0;
+                (exact < (double)numItems) && (count < MAX_GAPS);
+                exact = (2.25 * exact) + 1.0)
+            {
+                gap = (size_t)exact;
+                gaps[count] = ((double)gap < exact) ? gap + 1 : gap;
+
+                if (gaps[count] >= numItems)
+                {
+                    break;
+                }
+
+                count++;
+            }
+            break;
+
+        case SORT_GAPS_CIURA:
+        default:
+            for (count = 0;
+                (count < NUM_CIURA_GAPS) && (ciuraGaps[count] < numItems);
+                count++)
+            {
+                gaps[count] = ciuraGaps[count];
+            }
+
+            if (NUM_CIURA_GAPS == count)
+            {
+                for (gap = ciuraGaps[count - 1];
+                    (gap <= (((size_t)-1) / 9)) && (count < MAX_GAPS);
+                    count++)
+                {
+                    gap = (gap * 9) / 4;
+
+                    if (gap >= numItems)
+                    {
+                        break;
+                    }
+
+                    gaps[count] = gap;
+                }
+            }
+            break;
+    }
+
+    return count;
+}
+
+/***************************************************************************
+*   Function   : HSortChains
+*   Description: This function insertion sorts the chains of items that
+*                are gap apart, starting with chains first through
+*                last - 1.  The chains are sorted together a row at a
+*                time, so each row touches a contiguous run of items.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function (see ShellSortGaps)
+*                gap - distance between items in a chain
+*                first - index of the first chain to sort
+*                last - index after the last chain to sort (at most gap)
+*                temp - a temporary item
+*   Effects    : Each of the chains is sorted in ascending order
+*   Returned   : NONE
+***************************************************************************/
+static void HSortChains(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t gap,
+    size_t first, size_t last, void *temp)
+{
+    size_t row, i, j, end, gapItem;
+
+    gapItem = gap * itemSize;
+
+    for (row = gap; row < numItems; row += gap)
+    {
+        end = row + last;
+
+        if (end > numItems)
+        {
+            end = numItems;
+        }
+
+        /* insertion sort each chain's item in this row */
+        for (i = (row + first) * itemSize; i < end * itemSize; i += itemSize)
+        {
+            j = i;
+            CopyItem(temp, VoidPtrOffset(list, i), itemSize);
+
+            /* look for a place to insert list[i] using gap spacing */
+            while ((j >= gapItem) &&
+                (CompareItems(compareFunc, temp,
+                    VoidPtrOffset(list, (j - gapItem))) < 0))
+            {
+                CopyItem(VoidPtrOffset(list, j),
+                    VoidPtrOffset(list, (j - gapItem)), itemSize);
+                j = j - gapItem;
+            }
+
+            CopyItem(VoidPtrOffset(list, j), temp, itemSize);
+        }
+    }
+}
+
+/***************************************************************************
+*   Function   : HSortTiles
+*   Description: This function is called by each thread of an h-sort.  The
+*                thread sorts every numThreads-th tile of chains, starting
+*                with the tile matching its index.  Tiles never share an
+*                item, so no locking is needed.
+*   Parameters : arg - pointer to the h_sort_t
+*                thread - index of this thread
+*   Effects    : The thread's tiles are sorted
+*   Returned   : NONE
+***************************************************************************/
+static void HSortTiles(void *arg, unsigned int thread)
+{
+    h_sort_t *job;
+    size_t tile, first, last;
+
+    job = (h_sort_t *)arg;
+
+    for (tile = thread; tile < job->numTiles; tile += job->numThreads)
+    {
+        first = tile * job->tileChains;
+        last = first + job->tileChains;
+
+        if (last > job->gap)
+        {
+            last = job->gap;
+        }
+
+        HSortChains(job->list, job->numItems, job->itemSize,
+            job->compareFunc, job->gap, first, last,
+            VoidPtrOffset(job->temps, thread * job->itemSize));
+    }
+}
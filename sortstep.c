@@ -0,0 +1,439 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortstep.c
+*   Purpose : This module implements a sort that is done a slice at a time,
+*             so a single threaded event loop may sort a large list
+*             without blocking its other work.  The sort is a bottom-up
+*             merge sort kept as a state machine.  Each call to SortStep
+*             places a bounded number of items and returns, and the next
+*             call picks up where the last one stopped.  Short runs are
+*             binary insertion sorted in place, then runs twice as long are
+*             merged back and forth between the list and a buffer until one
+*             run remains.  The sort is stable.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "sort.h"
+#include "sortint.h"
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+typedef enum
+{
+    JOB_RUNS,                   /* insertion sorting the first runs */
+    JOB_MERGE,                  /* merging pairs of runs */
+    JOB_COPY_BACK,              /* copying the sorted buffer to the list */
+    JOB_DONE                    /* the list is sorted */
+} job_phase_t;
+
+struct sort_job_t
+{
+    void *list;                 /* the list being sorted */
+    size_t numItems;            /* number of items in the list */
+    size_t itemSize;            /* size of each item */
+    int (*compareFunc) (const void *, const void *);
+    void *buffer;               /* holds the items after odd passes */
+    void *temp;                 /* item being insertion sorted */
+    void *src;                  /* items the current pass reads */
+    void *dst;                  /* items the current pass writes */
+    job_phase_t phase;          /* what the next step does */
+    size_t width;               /* items in each run */
+    size_t next;                /* next item placed by this phase */
+    size_t left, leftEnd;       /* rest of the left run being merged */
+    size_t right, rightEnd;     /* rest of the right run being merged */
+    size_t done;                /* items placed so far */
+    size_t total;               /* items placed by the whole sort */
+};
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static size_t SortRuns(sort_job_t *job);
+static size_t MergeRuns(sort_job_t *job, size_t budget);
+static void EndPass(sort_job_t *job);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : SortJobCreate
+*   Description: This function creates a job that sorts a list a slice at
+*                a time with calls to SortStep.  The list must not be used
+*                until the job is done or freed.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : Memory is allocated for the job and a copy of the list
+*   Returned   : Pointer to the job, NULL on failure.
+***************************************************************************/
+sort_job_t *SortJobCreate(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sort_job_t *job;
+    size_t width;
+    unsigned int passes;
+
+    job = (sort_job_t *)calloc(1, sizeof(sort_job_t));
+
+    if (NULL == job)
+    {
+        return NULL;
+    }
+
+    job->list = list;
+    job->numItems = numItems;
+    job->itemSize = itemSize;
+    job->compareFunc = compareFunc;
+    job->width = sortTuning.insertionCutoff;
+
+    if (numItems < 2)
+    {
+        job->phase = JOB_DONE;
+        return job;
+    }
+
+    job->buffer = malloc(numItems * itemSize);
+    job->temp = malloc(itemSize);
+
+    if ((NULL == job->buffer) || (NULL == job->temp))
+    {
+        SortJobFree(job);
+        return NULL;
+    }
+
+    /* place every item once for the runs and once per merge pass */
+    passes = 0;
+
+    for (width = job->width; width < numItems; width *= 2)
+    {
+        passes++;
+    }
+
+    job->total = numItems * (1 + passes + (passes % 2));
+    job->src = list;
+    job->dst = job->buffer;
+    job->phase = JOB_RUNS;
+    return job;
+}
+
+/***************************************************************************
+*   Function   : SortJobFree
+*   Description: This function frees a job.  Freeing a job that isn't done
+*                cancels it; the list is left holding the same items, but
+*                they may not be sorted.
+*   Parameters : job - pointer to the job
+*   Effects    : Items held by the buffer are copied back to the list, and
+*                the job's memory is freed
+*   Returned   : NONE
+***************************************************************************/
+void SortJobFree(sort_job_t *job)
+{
+    size_t size;
+
+    if (NULL == job)
+    {
+        return;
+    }
+
+    size = job->itemSize;
+
+    if ((JOB_MERGE == job->phase) && (job->src == job->buffer))
+    {
+        /* the unmerged items fill the list from next on */
+        CopyItems(VoidPtrOffset(job->list, job->next * size),
+            VoidPtrOffset(job->buffer, job->left * size),
+            job->leftEnd - job->left, size);
+        CopyItems(VoidPtrOffset(job->list,
+            (job->next + job->leftEnd - job->left) * size),
+            VoidPtrOffset(job->buffer, job->right * size),
+            job->rightEnd - job->right, size);
+        CopyItems(VoidPtrOffset(job->list, job->rightEnd * size),
+            VoidPtrOffset(job->buffer, job->rightEnd * size),
+            job->numItems - job->rightEnd, size);
+    }
+    else if (JOB_COPY_BACK == job->phase)
+    {
+        CopyItems(VoidPtrOffset(job->list, job->next * size),
+            VoidPtrOffset(job->buffer, job->next * size),
+            job->numItems - job->next, size);
+    }
+
+    free(job->buffer);
+    free(job->temp);
+    free(job);
+}
+
+/***************************************************************************
+*   Function   : SortStep
+*   Description: This function does the next slice of a job's sort and
+*                returns.  A slice places about budget items: a merged
+*                item costs one comparison and one copy, and an item
+*                insertion sorted into one of the first runs costs at most
+*                sortTuning.insertionCutoff of each.  Every call makes some
+*                progress, even with a budget of 0.
+*   Parameters : job - pointer to the job
+*                budget - number of items to place
+*   Effects    : More of the list is sorted
+*   Returned   : 1 if the list is sorted, 0 if more steps are needed.
+***************************************************************************/
+int SortStep(sort_job_t *job, size_t budget)
+{
+    size_t placed, count;
+
+    if (0 == budget)
+    {
+        budget = 1;
+    }
+
+    while ((budget > 0) && (JOB_DONE != job->phase))
+    {
+        switch (job->phase)
+        {
+            case JOB_RUNS:
+                placed = SortRuns(job);
+                break;
+
+            case JOB_MERGE:
+                placed = MergeRuns(job, budget);
+                break;
+
+            default:    /* JOB_COPY_BACK */
+                count = job->numItems - job->next;
+
+                if (count > budget)
+                {
+                    count = budget;
+                }
+
+                CopyItems(VoidPtrOffset(job->list, job->next * job->itemSize),
+                    VoidPtrOffset(job->buffer, job->next * job->itemSize),
+                    count, job->itemSize);
+                job->next += count;
+                placed = count;
+                break;
+        }
+
+        job->done += placed;
+        budget = (placed < budget) ? (budget - placed) : 0;
+
+        if (job->next == job->numItems)
+        {
+            EndPass(job);
+        }
+    }
+
+    return (JOB_DONE == job->phase) ? 1 : 0;
+}
+
+/***************************************************************************
+*   Function   : SortJobProgress
+*   Description: This function reports how much of a job's sort is done.
+*                Items are counted each time they're placed, so done
+*                reaches total when the list is sorted.
+*   Parameters : job - pointer to the job
+*                done - receives the number of items placed so far
+*                total - receives the number placed by the whole sort
+*   Effects    : NONE
+*   Returned   : NONE
+***************************************************************************/
+void SortJobProgress(const sort_job_t *job, size_t *done, size_t *total)
+{
+    *done = job->done;
+    *total = job->total;
+}
+
+/***************************************************************************
+*   Function   : SortRuns
+*   Description: This function binary insertion sorts the next of the
+*                first runs in place.
+*   Parameters : job - pointer to the job
+*   Effects    : The run starting at job->next is sorted
+*   Returned   : Number of items in the run
+***************************************************************************/
+static size_t SortRuns(sort_job_t *job)
+{
+    size_t count;
+
+    count = job->numItems - job->next;
+
+    if (count > job->width)
+    {
+        count = job->width;
+    }
+
+    BinaryInsertionSortTemp(VoidPtrOffset(job->list,
+        job->next * job->itemSize), count, 1, job->itemSize,
+        job->compareFunc, job->temp);
+    job->next += count;
+    return count;
+}
+
+/***************************************************************************
+*   Function   : MergeRuns
+*   Description: This function merges pairs of runs from src into dst,
+*                stopping after budget items or at the end of the pass.
+*                Once one run of a pair is used up, the rest of the other
+*                is copied without comparisons.  A run without a partner
+*                at the end of the list is copied.  Items of the left run
+*                are taken first when items are ordered the same.
+*   Parameters : job - pointer to the job
+*                budget - most items to place
+*   Effects    : Up to budget more items are merged
+*   Returned   : Number of items placed
+***************************************************************************/
+static size_t MergeRuns(sort_job_t *job, size_t budget)
+{
+    size_t placed, count, size;
+    char *src, *dst;
+
+    src = (char *)job->src;
+    dst = (char *)job->dst;
+    size = job->itemSize;
+    placed = 0;
+
+    while ((placed < budget) && (job->next < job->numItems))
+    {
+        if ((job->left == job->leftEnd) && (job->right == job->rightEnd))
+        {
+            /* start the next pair of runs */
+            job->left = job->next;
+            job->leftEnd = job->next + job->width;
+
+            if (job->leftEnd > job->numItems)
+            {
+                job->leftEnd = job->numItems;
+            }
+
+            job->right = job->leftEnd;
+            job->rightEnd = job->leftEnd + job->width;
+
+            if (job->rightEnd > job->numItems)
+            {
+                job->rightEnd = job->numItems;
+            }
+        }
+
+        if ((job->left < job->leftEnd) && (job->right < job->rightEnd))
+        {
+            if (CompareItems(job->compareFunc, src + (job->right * size),
+                src + (job->left * size)) < 0)
+            {
+                CopyItem(dst + (job->next * size), src + (job->right * size),
+                    size);
+                job->right++;
+            }
+            else
+            {
+                CopyItem(dst + (job->next * size), src + (job->left * size),
+                    size);
+                job->left++;
+            }
+
+            job->next++;
+            placed++;
+        }
+        else if (job->left < job->leftEnd)
+        {
+            count = job->leftEnd - job->left;
+            count = (count < (budget - placed)) ? count : (budget - placed);
+            CopyItems(dst + (job->next * size), src + (job->left * size),
+                count, size);
+            job->left += count;
+            job->next += count;
+            placed += count;
+        }
+        else
+        {
+            count = job->rightEnd - job->right;
+            count = (count < (budget - placed)) ? count : (budget - placed);
+            CopyItems(dst + (job->next * size), src + (job->right * size),
+                count, size);
+            job->right += count;
+            job->next += count;
+            placed += count;
+        }
+    }
+
+    return placed;
+}
+
+/***************************************************************************
+*   Function   : EndPass
+*   Description: This function starts the phase that follows a completed
+*                pass over the list.  Merge passes alternate direction
+*                between the list and the buffer, doubling the run width,
+*                until the runs are as long as the list.  If the last pass
+*                left the sorted items in the buffer, they're copied back.
+*   Parameters : job - pointer to the job
+*   Effects    : The job moves to its next pass or phase
+*   Returned   : NONE
+***************************************************************************/
+static void EndPass(sort_job_t *job)
+{
+    void *swap;
+
+    if (JOB_MERGE == job->phase)
+    {
+        swap = job->src;
+        job->src = job->dst;
+        job->dst = swap;
+        job->width *= 2;
+    }
+
+    job->next = 0;
+    job->left = 0;
+    job->leftEnd = 0;
+    job->right = 0;
+    job->rightEnd = 0;
+
+    if (JOB_COPY_BACK == job->phase)
+    {
+        job->phase = JOB_DONE;
+    }
+    else if (job->width < job->numItems)
+    {
+        job->phase = JOB_MERGE;
+    }
+    else
+    {
+        job->phase = (job->src == job->list) ? JOB_DONE : JOB_COPY_BACK;
+    }
+}
@@ -0,0 +1,442 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortstrm.c
+*   Purpose : This module implements a streaming sort.  The caller pushes
+*             items as they arrive.  Items are collected in chunks, and
+*             each full chunk is sorted into a run by a background thread
+*             while the caller keeps pushing.  When the input ends, the
+*             runs are merged with a loser tree, and the caller pulls the
+*             sorted items a few at a time.  Sorting overlaps reading the
+*             input, and the first sorted items are available as soon as
+*             the last run is sorted.  Items that are ordered the same are
+*             pulled in the order that they were pushed.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdlib.h>
+#include "sort.h"
+#include "sortint.h"
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* runs are at least this many items */
+#define MIN_CHUNK_ITEMS     1024
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* a chunk of pushed items that is (or will be) a sorted run */
+typedef struct
+{
+    void *items;                /* the items */
+    size_t numItems;            /* number of items */
+    size_t itemSize;            /* size of each item */
+    int (*compareFunc) (const void *, const void *);
+    sort_thread_t *thread;      /* thread sorting the run, NULL if done */
+    sort_error_t result;        /* result of sorting the run */
+} stream_run_t;
+
+struct sort_stream_t
+{
+    size_t itemSize;            /* size of each item */
+    int (*compareFunc) (const void *, const void *);
+    size_t chunkItems;          /* items in a full chunk */
+    unsigned int numThreads;    /* most runs sorted at once */
+    stream_run_t **runs;        /* runs in the order they were pushed */
+    size_t numRuns;             /* number of runs */
+    size_t runCapacity;         /* runs that fit in runs */
+    size_t joined;              /* runs before this are sorted */
+    void *chunk;                /* chunk being filled, NULL if none */
+    size_t chunkFill;           /* items in chunk */
+    loser_tree_t *tree;         /* merges the runs once input ends */
+    bool_t finished;            /* TRUE once input ends */
+    sort_error_t error;         /* first error sorting a joined run */
+};
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static bool_t StartRun(sort_stream_t *stream);
+static void SortRun(void *arg);
+static void JoinRun(sort_stream_t *stream);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : SortStreamCreate
+*   Description: This function creates a stream that items may be pushed
+*                to and pulled from in sorted order.
+*   Parameters : itemSize - size of each item
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                chunkItems - items in each run, 0 for runs about half the
+*                             size of the last level cache
+*                numThreads - most runs to sort at once, 0 for one per
+*                             processor
+*   Effects    : Memory is allocated for the stream
+*   Returned   : Pointer to the stream, NULL on failure.
+***************************************************************************/
+sort_stream_t *SortStreamCreate(size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t chunkItems,
+    unsigned int numThreads)
+{
+    sort_stream_t *stream;
+
+    stream = (sort_stream_t *)calloc(1, sizeof(sort_stream_t));
+
+    if (NULL == stream)
+    {
+        return NULL;
+    }
+
+    if (0 == chunkItems)
+    {
+        chunkItems = sortTuning.llcCacheBytes / (2 * itemSize);
+    }
+
+    if (chunkItems < MIN_CHUNK_ITEMS)
+    {
+        chunkItems = MIN_CHUNK_ITEMS;
+    }
+
+    stream->itemSize = itemSize;
+    stream->compareFunc = compareFunc;
+    stream->chunkItems = chunkItems;
+    stream->numThreads = (0 == numThreads) ? SortDefaultThreads() :
+        numThreads;
+    stream->error = SORT_OK;
+
+    return stream;
+}
+
+/***************************************************************************
+*   Function   : SortStreamFree
+*   Description: This function frees a stream.  Any runs still being
+*                sorted are waited for.
+*   Parameters : stream - pointer to the stream
+*   Effects    : The stream's memory is freed
+*   Returned   : NONE
+***************************************************************************/
+void SortStreamFree(sort_stream_t *stream)
+{
+    size_t i;
+
+    if (NULL == stream)
+    {
+        return;
+    }
+
+    while (stream->joined < stream->numRuns)
+    {
+        JoinRun(stream);
+    }
+
+    if (NULL != stream->tree)
+    {
+        LoserTreeFree(stream->tree);
+    }
+
+    for (i = 0; i < stream->numRuns; i++)
+    {
+        free(stream->runs[i]->items);
+        free(stream->runs[i]);
+    }
+
+    free(stream->runs);
+    free(stream->chunk);
+    free(stream);
+}
+
+/***************************************************************************
+*   Function   : SortStreamPush
+*   Description: This function adds items to a stream.  Each time a chunk
+*                fills, a background thread is started to sort it.  If the
+*                most threads are already sorting, the oldest is waited
+*                for first.
+*   Parameters : stream - pointer to the stream
+*                items - array of items to add (in any order)
+*                numItems - number of items in the array
+*   Effects    : The items are copied into the stream
+*   Returned   : 1 for success, 0 if memory couldn't be allocated (here or
+*                while sorting an earlier run) or the input has already
+*                ended.
+***************************************************************************/
+int SortStreamPush(sort_stream_t *stream, const void *items,
+    size_t numItems)
+{
+    const char *src;
+    size_t count;
+
+    if (stream->finished || (SORT_OK != stream->error))
+    {
+        return 0;
+    }
+
+    src = (const char *)items;
+
+    while (numItems > 0)
+    {
+        if (NULL == stream->chunk)
+        {
+            stream->chunk = malloc(stream->chunkItems * stream->itemSize);
+
+            if (NULL == stream->chunk)
+            {
+                return 0;
+            }
+
+            stream->chunkFill = 0;
+        }
+
+        count = stream->chunkItems - stream->chunkFill;
+
+        if (count > numItems)
+        {
+            count = numItems;
+        }
+
+        CopyItems(VoidPtrOffset(stream->chunk,
+            stream->chunkFill * stream->itemSize), src, count,
+            stream->itemSize);
+        stream->chunkFill += count;
+        src += count * stream->itemSize;
+        numItems -= count;
+
+        if ((stream->chunkFill == stream->chunkItems) && !StartRun(stream))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/***************************************************************************
+*   Function   : SortStreamFinish
+*   Description: This function ends a stream's input.  The last partial
+*                chunk is sorted, every run is waited for, and the loser
+*                tree that merges the runs is built.  SortStreamPull calls
+*                this function if it hasn't been called.
+*   Parameters : stream - pointer to the stream
+*   Effects    : No more items may be pushed
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if memory couldn't be
+*                allocated (here or by a background thread sorting a run).
+***************************************************************************/
+sort_error_t SortStreamFinish(sort_stream_t *stream)
+{
+    const void **lists;
+    size_t *counts;
+    size_t i;
+
+    if (stream->finished)
+    {
+        return SORT_OK;
+    }
+
+    if ((NULL != stream->chunk) && (stream->chunkFill > 0) &&
+        !StartRun(stream))
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    while (stream->joined < stream->numRuns)
+    {
+        JoinRun(stream);
+    }
+
+    if (SORT_OK != stream->error)
+    {
+        /* an unsorted run can't be merged */
+        return stream->error;
+    }
+
+    if (stream->numRuns > 0)
+    {
+        lists = (const void **)ScratchAlloc(stream->numRuns *
+            sizeof(void *));
+        counts = (size_t *)ScratchAlloc(stream->numRuns * sizeof(size_t));
+
+        if ((NULL != lists) && (NULL != counts))
+        {
+            for (i = 0; i < stream->numRuns; i++)
+            {
+                lists[i] = stream->runs[i]->items;
+                counts[i] = stream->runs[i]->numItems;
+            }
+
+            stream->tree = LoserTreeCreate(NULL, lists, counts,
+                stream->numRuns, stream->itemSize, stream->compareFunc);
+        }
+
+        ScratchFree(lists, stream->numRuns * sizeof(void *));
+        ScratchFree(counts, stream->numRuns * sizeof(size_t));
+
+        if (NULL == stream->tree)
+        {
+            return SORT_ERR_NOMEM;
+        }
+    }
+
+    stream->finished = TRUE;
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : SortStreamPull
+*   Description: This function removes the next items in sorted order from
+*                a stream.  The first pull ends the input if
+*                SortStreamFinish hasn't been called.
+*   Parameters : stream - pointer to the stream
+*                output - array receiving the items
+*                maxItems - the most items to output
+*   Effects    : Up to maxItems items are copied to output
+*   Returned   : The number of items output.  0 once every item has been
+*                pulled (or if the input couldn't be finished).
+***************************************************************************/
+size_t SortStreamPull(sort_stream_t *stream, void *output, size_t maxItems)
+{
+    if (!stream->finished && (SORT_OK != SortStreamFinish(stream)))
+    {
+        return 0;
+    }
+
+    if (NULL == stream->tree)
+    {
+        return 0;       /* nothing was pushed */
+    }
+
+    return LoserTreePop(stream->tree, output, maxItems);
+}
+
+/***************************************************************************
+*   Function   : StartRun
+*   Description: This function turns the chunk being filled into a run and
+*                starts a background thread to sort it.  If the most
+*                threads are already running, the oldest is waited for.
+*   Parameters : stream - pointer to the stream
+*   Effects    : The chunk becomes the newest run
+*   Returned   : TRUE for success, FALSE if memory couldn't be allocated.
+***************************************************************************/
+static bool_t StartRun(sort_stream_t *stream)
+{
+    stream_run_t *run, **runs;
+    size_t capacity;
+
+    if (stream->numRuns == stream->runCapacity)
+    {
+        capacity = (0 == stream->runCapacity) ? 16 : 2 * stream->runCapacity;
+        runs = (stream_run_t **)realloc(stream->runs,
+            capacity * sizeof(stream_run_t *));
+
+        if (NULL == runs)
+        {
+            return FALSE;
+        }
+
+        stream->runs = runs;
+        stream->runCapacity = capacity;
+    }
+
+    run = (stream_run_t *)malloc(sizeof(stream_run_t));
+
+    if (NULL == run)
+    {
+        return FALSE;
+    }
+
+    while ((stream->numRuns - stream->joined) >= stream->numThreads)
+    {
+        JoinRun(stream);
+    }
+
+    run->items = stream->chunk;
+    run->numItems = stream->chunkFill;
+    run->itemSize = stream->itemSize;
+    run->compareFunc = stream->compareFunc;
+    run->result = SORT_OK;
+    stream->runs[stream->numRuns] = run;
+    stream->numRuns++;
+    stream->chunk = NULL;
+    stream->chunkFill = 0;
+
+    run->thread = SortThreadStart(SortRun, run);
+    return TRUE;
+}
+
+/***************************************************************************
+*   Function   : SortRun
+*   Description: This function is called by a background thread to sort a
+*                run.  NaturalMergeSortCtx is used because it is stable,
+*                and its result is kept for JoinRun rather than asserting
+*                in the background thread.
+*   Parameters : arg - pointer to the stream_run_t
+*   Effects    : The run is sorted and run->result is set
+*   Returned   : NONE
+***************************************************************************/
+static void SortRun(void *arg)
+{
+    stream_run_t *run;
+
+    run = (stream_run_t *)arg;
+    run->result = NaturalMergeSortCtx(NULL, run->items, run->numItems,
+        run->itemSize, run->compareFunc);
+}
+
+/***************************************************************************
+*   Function   : JoinRun
+*   Description: This function waits for the oldest run that may still be
+*                being sorted.
+*   Parameters : stream - pointer to the stream
+*   Effects    : One more run is known to be sorted (or stream->error is
+*                set if it couldn't be)
+*   Returned   : NONE
+***************************************************************************/
+static void JoinRun(sort_stream_t *stream)
+{
+    stream_run_t *run;
+
+    run = stream->runs[stream->joined];
+    SortThreadJoin(run->thread);
+    run->thread = NULL;
+    stream->joined++;
+
+    if ((SORT_OK != run->result) && (SORT_OK == stream->error))
+    {
+        stream->error = run->result;
+    }
+}
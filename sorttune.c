@@ -0,0 +1,814 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sorttune.c
+*   Purpose : This module manages the machine dependent thresholds used by
+*             the sort library.  Thresholds start out as compiled-in
+*             defaults, and may be replaced by values loaded from a
+*             profile file.  The profile named by the SORT_TUNING_FILE
+*             environment variable is loaded the first time the thresholds
+*             are used.  A calibration function measures the library's
+*             own kernels to find the best thresholds for the machine it
+*             runs on, so that they may be saved to a profile.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+#if defined(_WIN32) && !defined(SORT_NO_THREADS)
+#define SORT_NO_THREADS
+#endif
+
+#ifndef SORT_NO_THREADS
+/* pthreads are not declared in strict ANSI mode */
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sort.h"
+#include "sortint.h"
+
+#ifndef SORT_NO_THREADS
+#include <pthread.h>
+#endif
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* compiled-in defaults (typical of a current x86 server core) */
+#define DEFAULT_L1D_CACHE       (32UL * 1024UL)
+#define DEFAULT_L2_CACHE        (256UL * 1024UL)
+#define DEFAULT_LLC_CACHE       (8UL * 1024UL * 1024UL)
+#define DEFAULT_INSERTION_CUTOFF    12
+#define DEFAULT_RADIX_BITS      16
+#define DEFAULT_PARALLEL_GRAIN  (64UL * 1024UL)
+
+/* limits on thresholds from profiles and SortSetTuning */
+#define MAX_INSERTION_CUTOFF    64
+#define MIN_CACHE_BYTES         (4UL * 1024UL)
+#define MAX_CACHE_BYTES         (1UL << 30)
+
+/* environment variable naming a profile when SortLoadTuning gets NULL */
+#define TUNING_FILE_ENV         "SORT_TUNING_FILE"
+
+/* number of items sorted when timing candidate thresholds */
+#define CALIBRATION_ITEMS       (1UL << 17)
+#define CALIBRATION_LARGE_ITEMS (1UL << 20)
+#define CALIBRATION_RUNS        3
+
+static const size_t cutoffCandidates[] = {1, 4, 8, 12, 16, 24, 32, 48, 64};
+static const unsigned int radixCandidates[] = {8, 11, 16};
+static const size_t blockCandidates[] = {4, 2, 1};   /* L2 divisors */
+static const size_t grainCandidates[] =
+    {4096, 8192, 16384, 32768, 65536, 131072, 262144};
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* sorts timed by the calibration */
+typedef enum
+{
+    TIME_QUICK_SORT,
+    TIME_RADIX_SORT,
+    TIME_BLOCK_MERGE_SORT,
+    TIME_PARALLEL_SORT
+} timed_sort_t;
+
+/***************************************************************************
+*                            GLOBAL VARIABLES
+***************************************************************************/
+/* use SortTuningValues() (the sortTuning macro) so the profile is loaded */
+static sort_tuning_t tuningValues =
+{
+    DEFAULT_L1D_CACHE,
+    DEFAULT_L2_CACHE,
+    DEFAULT_LLC_CACHE,
+    DEFAULT_INSERTION_CUTOFF,
+    DEFAULT_RADIX_BITS,
+    DEFAULT_PARALLEL_GRAIN,
+    DEFAULT_L2_CACHE / 2
+};
+
+/* thresholds SortCalibrate is timing on this thread, NULL if it isn't */
+static SORT_TLS sort_tuning_t *threadTuning = NULL;
+
+#ifndef SORT_NO_THREADS
+static pthread_once_t profileOnce = PTHREAD_ONCE_INIT;
+#else
+static int profileLoaded = 0;
+#endif
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static void LoadDefaultProfile(void);
+static int ReadProfile(const char *fileName, sort_tuning_t *tuning);
+static void LimitTuning(sort_tuning_t *tuning);
+static size_t LimitCache(size_t bytes, size_t defaultBytes);
+static void ReadCacheSizes(sort_tuning_t *tuning);
+static int CompareInt(const void *x, const void *y);
+static double TimeSort(const int *unsorted, int *list, size_t numItems,
+    timed_sort_t sort);
+static double Seconds(void);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : SortTuningDefaults
+*   Description: This function fills in a tuning structure with the
+*                compiled-in default thresholds.
+*   Parameters : tuning - pointer to the structure to fill in
+*   Effects    : tuning is overwritten
+*   Returned   : NONE
+***************************************************************************/
+void SortTuningDefaults(sort_tuning_t *tuning)
+{
+    tuning->l1dCacheBytes = DEFAULT_L1D_CACHE;
+    tuning->l2CacheBytes = DEFAULT_L2_CACHE;
+    tuning->llcCacheBytes = DEFAULT_LLC_CACHE;
+    tuning->insertionCutoff = DEFAULT_INSERTION_CUTOFF;
+    tuning->radixBits = DEFAULT_RADIX_BITS;
+    tuning->parallelGrain = DEFAULT_PARALLEL_GRAIN;
+    tuning->mergeBlockBytes = DEFAULT_L2_CACHE / 2;
+}
+
+/***************************************************************************
+*   Function   : SortTuningValues
+*   Description: This function returns the thresholds used by the library.
+*                The first call loads the profile named by the
+*                SORT_TUNING_FILE environment variable (if there is one),
+*                so the library uses it without the program calling
+*                SortLoadTuning.  While SortCalibrate times a candidate,
+*                the calibrating thread sees the candidate instead, so
+*                sorts running on other threads aren't affected.  The
+*                sortTuning macro calls this function.
+*   Parameters : NONE
+*   Effects    : The default profile is loaded on the first call
+*   Returned   : Pointer to the thresholds used by the calling thread
+***************************************************************************/
+sort_tuning_t *SortTuningValues(void)
+{
+#ifndef SORT_NO_THREADS
+    pthread_once(&profileOnce, LoadDefaultProfile);
+#else
+    if (!profileLoaded)
+    {
+        profileLoaded = 1;
+        LoadDefaultProfile();
+    }
+#endif
+
+    return (NULL != threadTuning) ? threadTuning : &tuningValues;
+}
+
+/***************************************************************************
+*   Function   : SortGetTuning
+*   Description: This function copies the thresholds currently used by the
+*                library.
+*   Parameters : tuning - pointer to the structure receiving the thresholds
+*   Effects    : tuning is overwritten
+*   Returned   : NONE
+***************************************************************************/
+void SortGetTuning(sort_tuning_t *tuning)
+{
+    *tuning = sortTuning;
+}
+
+/***************************************************************************
+*   Function   : SortSetTuning
+*   Description: This function replaces the thresholds used by the
+*                library.  Values outside of the ranges that the algorithms
+*                handle well (such as insertion sort cutoffs over 64) are
+*                limited.  It should not be called while other threads are
+*                sorting.
+*   Parameters : tuning - pointer to the new thresholds
+*   Effects    : Future sorts use the new thresholds
+*   Returned   : NONE
+***************************************************************************/
+void SortSetTuning(const sort_tuning_t *tuning)
+{
+    sortTuning = *tuning;
+    LimitTuning(&sortTuning);
+}
+
+/***************************************************************************
+*   Function   : SortLoadTuning
+*   Description: This function loads thresholds from a profile written by
+*                SortSaveTuning.  Each line of a profile contains a name and
+*                a value.  Lines starting with '#' and unknown names are
+*                ignored, and thresholds that aren't in the profile keep
+*                their current values.  Programs only need to call it for a
+*                profile other than the one named by SORT_TUNING_FILE,
+*                which is loaded the first time the thresholds are used.
+*   Parameters : fileName - name of the profile.  If NULL, the profile
+*                           named by the SORT_TUNING_FILE environment
+*                           variable is used.
+*   Effects    : Future sorts use the loaded thresholds
+*   Returned   : 1 if the profile was loaded, 0 if it couldn't be read (the
+*                current thresholds are unchanged).
+***************************************************************************/
+int SortLoadTuning(const char *fileName)
+{
+    if (NULL == fileName)
+    {
+        fileName = getenv(TUNING_FILE_ENV);
+    }
+
+    return ReadProfile(fileName, SortTuningValues());
+}
+
+/***************************************************************************
+*   Function   : SortSaveTuning
+*   Description: This function writes thresholds to a profile that may be
+*                read by SortLoadTuning.
+*   Parameters : fileName - name of the profile to write
+*                tuning - pointer to the thresholds to write
+*   Effects    : The profile is created or overwritten
+*   Returned   : 1 for success, 0 if the profile couldn't be written.
+***************************************************************************/
+int SortSaveTuning(const char *fileName, const sort_tuning_t *tuning)
+{
+    FILE *fp;
+    int result;
+
+    if (NULL == fileName)
+    {
+        return 0;
+    }
+
+    fp = fopen(fileName, "w");
+
+    if (NULL == fp)
+    {
+        return 0;
+    }
+
+    fprintf(fp, "# sort library tuning profile\n");
+    fprintf(fp, "l1d_cache_bytes %lu\n", (unsigned long)tuning->l1dCacheBytes);
+    fprintf(fp, "l2_cache_bytes %lu\n", (unsigned long)tuning->l2CacheBytes);
+    fprintf(fp, "llc_cache_bytes %lu\n", (unsigned long)tuning->llcCacheBytes);
+    fprintf(fp, "insertion_cutoff %lu\n",
+        (unsigned long)tuning->insertionCutoff);
+    fprintf(fp, "radix_bits %u\n", tuning->radixBits);
+    fprintf(fp, "parallel_grain %lu\n", (unsigned long)tuning->parallelGrain);
+    fprintf(fp, "merge_block_bytes %lu\n",
+        (unsigned long)tuning->mergeBlockBytes);
+
+    result = !ferror(fp);
+
+    if (0 != fclose(fp))
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+/***************************************************************************
+*   Function   : SortCalibrate
+*   Description: This function determines thresholds for the machine that
+*                it is running on.  Cache sizes are read from sysfs (the
+*                defaults are kept if sysfs isn't available).  Each of the
+*                other thresholds is found by timing the kernel that uses it
+*                on random data with each of its candidate values:
+*                QuickSort for the insertion sort cutoff, RadixSortNumeric
+*                for the digit width, BlockMergeSort for the merge block
+*                size, and ParallelSampleSort against QuickSort for the
+*                smallest list worth giving to each thread.  Values derived
+*                from the cache sizes are kept if the timing lists can't be
+*                allocated (or, for the grain, if there's one processor).
+*                The thresholds used by the library are left unchanged.
+*                Use SortSetTuning or SortSaveTuning to apply the results.
+*   Parameters : tuning - pointer to the structure receiving the thresholds
+*   Effects    : tuning is overwritten
+*   Returned   : NONE
+***************************************************************************/
+void SortCalibrate(sort_tuning_t *tuning)
+{
+    sort_tuning_t candidate;
+    int *unsorted, *list;
+    unsigned long seed;
+    double elapsed, best;
+    size_t i;
+
+    SortTuningDefaults(tuning);
+    ReadCacheSizes(tuning);
+    LimitTuning(tuning);
+
+    /* sort merge blocks in half of L2 to leave room for the output */
+    tuning->mergeBlockBytes = tuning->l2CacheBytes / 2;
+
+    /* use the widest digit whose counters for one pass fit in L2 */
+    if (((1UL << 16) * sizeof(size_t)) <= tuning->l2CacheBytes)
+    {
+        tuning->radixBits = 16;
+    }
+    else if (((1UL << 11) * sizeof(size_t)) <= tuning->l2CacheBytes)
+    {
+        tuning->radixBits = 11;
+    }
+    else
+    {
+        tuning->radixBits = 8;
+    }
+
+    /* give each thread at least an L2 worth of ints */
+    tuning->parallelGrain = tuning->l2CacheBytes / sizeof(int);
+
+    /* the timings below need room for the largest kernel's list */
+    unsorted = (int *)malloc(CALIBRATION_LARGE_ITEMS * sizeof(int));
+    list = (int *)malloc(CALIBRATION_LARGE_ITEMS * sizeof(int));
+
+    if ((NULL == unsorted) || (NULL == list))
+    {
+        /* can't time the kernels, keep the derived values */
+        free(unsorted);
+        free(list);
+        return;
+    }
+
+    seed = 1;
+
+    for (i = 0; i < CALIBRATION_LARGE_ITEMS; i++)
+    {
+        seed = (seed * 1103515245UL) + 12345UL;
+        unsorted[i] = (int)((seed >> 16) & 0x7FFFFFFFUL);
+    }
+
+    /* time the kernels with the candidates, on this thread only */
+    candidate = *tuning;
+    threadTuning = &candidate;
+
+    /* time the candidate insertion sort cutoffs */
+    best = -1.0;
+
+    for (i = 0; i < sizeof(cutoffCandidates) / sizeof(size_t); i++)
+    {
+        candidate.insertionCutoff = cutoffCandidates[i];
+        elapsed = TimeSort(unsorted, list, CALIBRATION_ITEMS,
+            TIME_QUICK_SORT);
+
+        if ((best < 0.0) || (elapsed < best))
+        {
+            best = elapsed;
+            tuning->insertionCutoff = cutoffCandidates[i];
+        }
+    }
+
+    candidate.insertionCutoff = tuning->insertionCutoff;
+
+    /* time the candidate radix digit widths */
+    best = -1.0;
+
+    for (i = 0; i < sizeof(radixCandidates) / sizeof(unsigned int); i++)
+    {
+        candidate.radixBits = radixCandidates[i];
+        elapsed = TimeSort(unsorted, list, CALIBRATION_LARGE_ITEMS,
+            TIME_RADIX_SORT);
+
+        if ((best < 0.0) || (elapsed < best))
+        {
+            best = elapsed;
+            tuning->radixBits = radixCandidates[i];
+        }
+    }
+
+    candidate.radixBits = tuning->radixBits;
+
+    /* time the candidate merge block sizes */
+    best = -1.0;
+
+    for (i = 0; i < sizeof(blockCandidates) / sizeof(size_t); i++)
+    {
+        candidate.mergeBlockBytes =
+            tuning->l2CacheBytes / blockCandidates[i];
+        elapsed = TimeSort(unsorted, list, CALIBRATION_LARGE_ITEMS,
+            TIME_BLOCK_MERGE_SORT);
+
+        if ((best < 0.0) || (elapsed < best))
+        {
+            best = elapsed;
+            tuning->mergeBlockBytes = candidate.mergeBlockBytes;
+        }
+    }
+
+    candidate.mergeBlockBytes = tuning->mergeBlockBytes;
+
+    /* find the smallest grain where two threads beat one */
+    if (SortDefaultThreads() > 1)
+    {
+        for (i = 0; i < sizeof(grainCandidates) / sizeof(size_t); i++)
+        {
+            candidate.parallelGrain = grainCandidates[i];
+            elapsed = TimeSort(unsorted, list, 2 * grainCandidates[i],
+                TIME_PARALLEL_SORT);
+            best = TimeSort(unsorted, list, 2 * grainCandidates[i],
+                TIME_QUICK_SORT);
+
+            if (elapsed < best)
+            {
+                tuning->parallelGrain = grainCandidates[i];
+                break;
+            }
+        }
+    }
+
+    threadTuning = NULL;
+    free(unsorted);
+    free(list);
+}
+
+/***************************************************************************
+*   Function   : LoadDefaultProfile
+*   Description: This function loads the profile named by the
+*                SORT_TUNING_FILE environment variable, if there is one.
+*                It is called once, the first time the thresholds are used.
+*   Parameters : NONE
+*   Effects    : The library's thresholds are updated from the profile
+*   Returned   : NONE
+***************************************************************************/
+static void LoadDefaultProfile(void)
+{
+    ReadProfile(getenv(TUNING_FILE_ENV), &tuningValues);
+}
+
+/***************************************************************************
+*   Function   : ReadProfile
+*   Description: This function reads thresholds from a profile written by
+*                SortSaveTuning.  See SortLoadTuning.
+*   Parameters : fileName - name of the profile, may be NULL
+*                tuning - thresholds updated by the profile
+*   Effects    : tuning is updated with the values in the profile
+*   Returned   : 1 if the profile was read, 0 if it couldn't be read (tuning
+*                is unchanged).
+***************************************************************************/
+static int ReadProfile(const char *fileName, sort_tuning_t *tuning)
+{
+    FILE *fp;
+    char line[128];
+    char name[64];
+    unsigned long value;
+    sort_tuning_t loaded;
+
+    if (NULL == fileName)
+    {
+        return 0;
+    }
+
+    fp = fopen(fileName, "r");
+
+    if (NULL == fp)
+    {
+        return 0;
+    }
+
+    loaded = *tuning;
+
+    while (NULL != fgets(line, sizeof(line), fp))
+    {
+        if (('#' == line[0]) ||
+            (2 != sscanf(line, "%63s %lu", name, &value)))
+        {
+            continue;
+        }
+
+        if (0 == strcmp(name, "l1d_cache_bytes"))
+        {
+            loaded.l1dCacheBytes = (size_t)value;
+        }
+        else if (0 == strcmp(name, "l2_cache_bytes"))
+        {
+            loaded.l2CacheBytes = (size_t)value;
+        }
+        else if (0 == strcmp(name, "llc_cache_bytes"))
+        {
+            loaded.llcCacheBytes = (size_t)value;
+        }
+        else if (0 == strcmp(name, "insertion_cutoff"))
+        {
+            loaded.insertionCutoff = (size_t)value;
+        }
+        else if (0 == strcmp(name, "radix_bits"))
+        {
+            loaded.radixBits = (unsigned int)value;
+        }
+        else if (0 == strcmp(name, "parallel_grain"))
+        {
+            loaded.parallelGrain = (size_t)value;
+        }
+        else if (0 == strcmp(name, "merge_block_bytes"))
+        {
+            loaded.mergeBlockBytes = (size_t)value;
+        }
+    }
+
+    fclose(fp);
+    LimitTuning(&loaded);
+    *tuning = loaded;
+    return 1;
+}
+
+/***************************************************************************
+*   Function   : LimitTuning
+*   Description: This function keeps thresholds inside the ranges that the
+*                algorithms can handle.
+*   Parameters : tuning - thresholds to limit
+*   Effects    : Out of range values in tuning are replaced
+*   Returned   : NONE
+***************************************************************************/
+static void LimitTuning(sort_tuning_t *tuning)
+{
+    tuning->l1dCacheBytes = LimitCache(tuning->l1dCacheBytes,
+        DEFAULT_L1D_CACHE);
+    tuning->l2CacheBytes = LimitCache(tuning->l2CacheBytes,
+        DEFAULT_L2_CACHE);
+    tuning->llcCacheBytes = LimitCache(tuning->llcCacheBytes,
+        DEFAULT_LLC_CACHE);
+
+    if (0 == tuning->insertionCutoff)
+    {
+        tuning->insertionCutoff = 1;
+    }
+    else if (tuning->insertionCutoff > MAX_INSERTION_CUTOFF)
+    {
+        /* larger cutoffs turn the O(N log N) sorts into insertion sorts */
+        tuning->insertionCutoff = MAX_INSERTION_CUTOFF;
+    }
+
+    if (tuning->radixBits < 1)
+    {
+        tuning->radixBits = 1;
+    }
+    else if (tuning->radixBits > 16)
+    {
+        tuning->radixBits = 16;
+    }
+
+    if (0 == tuning->parallelGrain)
+    {
+        tuning->parallelGrain = 1;
+    }
+
+    tuning->mergeBlockBytes = LimitCache(tuning->mergeBlockBytes,
+        DEFAULT_L2_CACHE / 2);
+}
+
+/***************************************************************************
+*   Function   : LimitCache
+*   Description: This function keeps a cache (or block) size between
+*                MIN_CACHE_BYTES and MAX_CACHE_BYTES.  0 means the size is
+*                unknown, and the default is used.
+*   Parameters : bytes - the size to limit
+*                defaultBytes - the size to use if bytes is 0
+*   Effects    : NONE
+*   Returned   : The limited size
+***************************************************************************/
+static size_t LimitCache(size_t bytes, size_t defaultBytes)
+{
+    if (0 == bytes)
+    {
+        return defaultBytes;
+    }
+
+    if (bytes < MIN_CACHE_BYTES)
+    {
+        return MIN_CACHE_BYTES;
+    }
+
+    if (bytes > MAX_CACHE_BYTES)
+    {
+        return MAX_CACHE_BYTES;
+    }
+
+    return bytes;
+}
+
+/***************************************************************************
+*   Function   : ReadCacheSizes
+*   Description: This function reads the data cache sizes of the first CPU
+*                from sysfs (/sys/devices/system/cpu/cpu0/cache).
+*   Parameters : tuning - pointer to the structure receiving the sizes
+*   Effects    : The cache sizes in tuning are updated for every cache
+*                that sysfs describes.
+*   Returned   : NONE
+***************************************************************************/
+static void ReadCacheSizes(sort_tuning_t *tuning)
+{
+    FILE *fp;
+    char path[80];
+    char type[32];
+    unsigned long size;
+    char units;
+    int index, level;
+
+    for (index = 0; index < 16; index++)
+    {
+        sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/level",
+            index);
+        fp = fopen(path, "r");
+
+        if (NULL == fp)
+        {
+            break;      /* no more caches (or no sysfs) */
+        }
+
+        if (1 != fscanf(fp, "%d", &level))
+        {
+            level = 0;
+        }
+
+        fclose(fp);
+
+        sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/type",
+            index);
+        fp = fopen(path, "r");
+
+        if ((NULL == fp) || (1 != fscanf(fp, "%31s", type)))
+        {
+            type[0] = '\0';
+        }
+
+        if (NULL != fp)
+        {
+            fclose(fp);
+        }
+
+        if (0 == strcmp(type, "Instruction"))
+        {
+            continue;   /* only data and unified caches matter */
+        }
+
+        sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/size",
+            index);
+        fp = fopen(path, "r");
+
+        if (NULL == fp)
+        {
+            continue;
+        }
+
+        units = '\0';
+
+        if (fscanf(fp, "%lu%c", &size, &units) < 1)
+        {
+            size = 0;
+        }
+
+        fclose(fp);
+
+        if ('K' == units)
+        {
+            size *= 1024UL;
+        }
+        else if ('M' == units)
+        {
+            size *= 1024UL * 1024UL;
+        }
+
+        if (0 == size)
+        {
+            continue;
+        }
+
+        if (1 == level)
+        {
+            tuning->l1dCacheBytes = (size_t)size;
+        }
+        else if (2 == level)
+        {
+            tuning->l2CacheBytes = (size_t)size;
+        }
+
+        if (level >= 2)
+        {
+            /* the highest level seen is the last level cache */
+            tuning->llcCacheBytes = (size_t)size;
+        }
+    }
+}
+
+/***************************************************************************
+*   Function   : CompareInt
+*   Description: This function orders integers in ascending order.  It is
+*                used when timing candidate thresholds.
+*   Parameters : x - a pointer to an integer recast as a pointer to void
+*                y - a pointer to an integer recast as a pointer to void
+*   Effects    : NONE
+*   Returned   : < 0 if x < y, 0 if x == y, > 0 if x > y
+***************************************************************************/
+static int CompareInt(const void *x, const void *y)
+{
+    return (*(const int *)x > *(const int *)y) -
+        (*(const int *)x < *(const int *)y);
+}
+
+/***************************************************************************
+*   Function   : TimeSort
+*   Description: This function times one of the library's kernels on a
+*                copy of an unsorted list with the current thresholds.  The
+*                best of several runs is returned to reduce noise.
+*   Parameters : unsorted - the list of integers to sort
+*                list - storage for a copy of the list
+*                numItems - number of items in the list
+*                sort - the kernel to time
+*   Effects    : list is overwritten
+*   Returned   : The shortest time taken to sort the list (in seconds).
+***************************************************************************/
+static double TimeSort(const int *unsorted, int *list, size_t numItems,
+    timed_sort_t sort)
+{
+    double start, elapsed, best;
+    int run;
+
+    best = -1.0;
+
+    for (run = 0; run < CALIBRATION_RUNS; run++)
+    {
+        memcpy(list, unsorted, numItems * sizeof(int));
+
+        start = Seconds();
+
+        switch (sort)
+        {
+            case TIME_QUICK_SORT:
+                QuickSort(list, numItems, sizeof(int), CompareInt);
+                break;
+
+            case TIME_RADIX_SORT:
+                RadixSortNumeric(list, numItems, sizeof(int), 0,
+                    SORT_KEY_INT);
+                break;
+
+            case TIME_BLOCK_MERGE_SORT:
+                BlockMergeSort(list, numItems, sizeof(int), CompareInt);
+                break;
+
+            case TIME_PARALLEL_SORT:
+                ParallelSampleSort(list, numItems, sizeof(int), CompareInt,
+                    2);
+                break;
+        }
+
+        elapsed = Seconds() - start;
+
+        if ((best < 0.0) || (elapsed < best))
+        {
+            best = elapsed;
+        }
+    }
+
+    return best;
+}
+
+/***************************************************************************
+*   Function   : Seconds
+*   Description: This function reads a clock for timing the kernels.  The
+*                parallel kernel needs elapsed time rather than the CPU time
+*                used by all of the threads, so a monotonic wall clock is
+*                used when threads are available.
+*   Parameters : NONE
+*   Effects    : NONE
+*   Returned   : The current time in seconds from an arbitrary start
+***************************************************************************/
+static double Seconds(void)
+{
+#ifndef SORT_NO_THREADS
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
@@ -0,0 +1,574 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortuniq.c
+*   Purpose : This module implements sorts that remove or count equal
+*             items while they sort.  They are merge sorts where each half
+*             of a list is sorted and stripped of duplicates before the
+*             halves are merged.  Two items that compare equal while
+*             merging can only be one from each half, so the merge keeps
+*             one of them (adding their counts) and no extra comparisons
+*             or passes over the list are needed to find duplicates.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <assert.h>
+#include "sort.h"
+#include "sortint.h"
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* buffers shared by every level of the recursion */
+typedef struct
+{
+    size_t itemSize;            /* size of each item */
+    int (*compareFunc) (const void *, const void *);
+    void *merged;               /* merge buffer for items */
+    size_t *mergedCounts;       /* merge buffer for counts, NULL if none */
+    void *temp;                 /* temporary item */
+} unique_sort_t;
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static sort_error_t UniqueSort(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t *counts,
+    size_t *numUnique);
+static size_t UniqueSortRecursive(const unique_sort_t *us, void *list,
+    size_t *counts, size_t numItems);
+static size_t UniqueInsertionSort(const unique_sort_t *us, void *list,
+    size_t *counts, size_t numItems);
+static size_t UniqueHeapSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t *counts);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : SortUnique
+*   Description: This function sorts an array of items and removes the
+*                duplicates using scratch memory from the heap.  See
+*                SortUniqueCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : The first items of list are its distinct items in
+*                ascending order.  The rest are undefined.
+*   Returned   : The number of distinct items.
+***************************************************************************/
+size_t SortUnique(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    sort_error_t result;
+    size_t numUnique;
+
+    result = SortUniqueCtx(NULL, list, numItems, itemSize, compareFunc,
+        &numUnique);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        numUnique = UniqueHeapSort(list, numItems, itemSize, compareFunc,
+            NULL);
+        result = SORT_OK;
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+    return numUnique;
+}
+
+/***************************************************************************
+*   Function   : SortUniqueCtx
+*   Description: This function sorts an array of items and removes the
+*                duplicates.  Of each group of equal items, the one that
+*                came first in the list is kept.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                numUnique - receives the number of distinct items
+*   Effects    : The first *numUnique items of list are its distinct items
+*                in ascending order.  The rest are undefined.
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t SortUniqueCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t *numUnique)
+{
+    return UniqueSort(ctx, list, numItems, itemSize, compareFunc, NULL,
+        numUnique);
+}
+
+/***************************************************************************
+*   Function   : SortCountRuns
+*   Description: This function sorts an array of items and counts each
+*                group of equal items using scratch memory from the heap.
+*                See SortCountRunsCtx.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                counts - array of numItems counts
+*   Effects    : The first items of list are its distinct items in
+*                ascending order, and counts[i] is the number of items
+*                equal to list[i].
+*   Returned   : The number of distinct items.
+***************************************************************************/
+size_t SortCountRuns(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t *counts)
+{
+    sort_error_t result;
+    size_t numUnique;
+
+    result = SortCountRunsCtx(NULL, list, numItems, itemSize, compareFunc,
+        counts, &numUnique);
+
+    if (SORT_ERR_NOMEM == result)
+    {
+        /* no scratch memory, use a sort that doesn't need any */
+        numUnique = UniqueHeapSort(list, numItems, itemSize, compareFunc,
+            counts);
+        result = SORT_OK;
+    }
+
+    assert(SORT_OK == result);
+    (void)result;       /* unused if NDEBUG is defined */
+    return numUnique;
+}
+
+/***************************************************************************
+*   Function   : SortCountRunsCtx
+*   Description: This function sorts an array of items and counts each
+*                group of equal items, giving the (key, count) pairs of a
+*                group by.  Of each group of equal items, the one that came
+*                first in the list is kept.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                counts - array of numItems counts
+*                numUnique - receives the number of distinct items
+*   Effects    : The first *numUnique items of list are its distinct items
+*                in ascending order, and counts[i] is the number of items
+*                equal to list[i].
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+sort_error_t SortCountRunsCtx(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t *counts,
+    size_t *numUnique)
+{
+    return UniqueSort(ctx, list, numItems, itemSize, compareFunc, counts,
+        numUnique);
+}
+
+/***************************************************************************
+*   Function   : UniqueSort
+*   Description: This function allocates the buffers used by SortUnique
+*                and SortCountRuns and sorts the list.
+*   Parameters : ctx - context providing scratch memory, NULL for the heap
+*                list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function (see SortUnique)
+*                counts - array of numItems counts, NULL if not counting
+*                numUnique - receives the number of distinct items
+*   Effects    : The distinct items are sorted to the start of list
+*   Returned   : SORT_OK for success, SORT_ERR_NOMEM if scratch memory
+*                wasn't available.
+***************************************************************************/
+static sort_error_t UniqueSort(sort_context_t *ctx, void *list,
+    size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t *counts,
+    size_t *numUnique)
+{
+    unique_sort_t us;
+
+    *numUnique = numItems;
+
+    if (numItems <= 1)
+    {
+        if ((1 == numItems) && (NULL != counts))
+        {
+            counts[0] = 1;
+        }
+
+        return SORT_OK;
+    }
+
+    us.itemSize = itemSize;
+    us.compareFunc = compareFunc;
+    us.mergedCounts = NULL;
+    us.temp = ContextAlloc(ctx, itemSize);
+
+    if (NULL == us.temp)
+    {
+        return SORT_ERR_NOMEM;
+    }
+
+    us.merged = ContextAlloc(ctx, numItems * itemSize);
+
+    if (NULL == us.merged)
+    {
+        ContextFree(ctx, us.temp, itemSize);
+        return SORT_ERR_NOMEM;
+    }
+
+    if (NULL != counts)
+    {
+        us.mergedCounts = (size_t *)ContextAlloc(ctx,
+            numItems * sizeof(size_t));
+
+        if (NULL == us.mergedCounts)
+        {
+            ContextFree(ctx, us.merged, numItems * itemSize);
+            ContextFree(ctx, us.temp, itemSize);
+            return SORT_ERR_NOMEM;
+        }
+    }
+
+    *numUnique = UniqueSortRecursive(&us, list, counts, numItems);
+
+    if (NULL != counts)
+    {
+        ContextFree(ctx, us.mergedCounts, numItems * sizeof(size_t));
+    }
+
+    ContextFree(ctx, us.merged, numItems * itemSize);
+    ContextFree(ctx, us.temp, itemSize);
+    return SORT_OK;
+}
+
+/***************************************************************************
+*   Function   : UniqueSortRecursive
+*   Description: This function sorts each half of a list and removes its
+*                duplicates, then merges the distinct items of the halves.
+*                When an item from each half compares equal, the one from
+*                the first half is kept and the counts are added.
+*   Parameters : us - buffers and parameters of the sort
+*                list - a pointer of an array of items to sort
+*                counts - counts of the items in list, NULL if not counting
+*                numItems - number of items in the array
+*   Effects    : The distinct items of list are sorted to its start, and
+*                their counts are written to counts
+*   Returned   : The number of distinct items.
+***************************************************************************/
+static size_t UniqueSortRecursive(const unique_sort_t *us, void *list,
+    size_t *counts, size_t numItems)
+{
+    size_t half, low, high, lowEnd, highEnd, out;
+    size_t itemSize;
+    void *highList;
+    int result;
+
+    if (numItems <= sortTuning.insertionCutoff)
+    {
+        return UniqueInsertionSort(us, list, counts, numItems);
+    }
+
+    StatEnter();
+    itemSize = us->itemSize;
+    half = numItems / 2;
+    highList = VoidPtrOffset(list, half * itemSize);
+
+    lowEnd = UniqueSortRecursive(us, list, counts, half);
+    highEnd = UniqueSortRecursive(us, highList,
+        (NULL == counts) ? NULL : counts + half, numItems - half);
+
+    /* merge the distinct items of list[0 .. half) and list[half .. end) */
+    low = 0;
+    high = 0;
+    out = 0;
+
+    while ((low < lowEnd) && (high < highEnd))
+    {
+        result = CompareItems(us->compareFunc,
+            VoidPtrOffset(list, low * itemSize),
+            VoidPtrOffset(highList, high * itemSize));
+
+        if (result <= 0)
+        {
+            CopyItem(VoidPtrOffset(us->merged, out * itemSize),
+                VoidPtrOffset(list, low * itemSize), itemSize);
+
+            if (NULL != counts)
+            {
+                us->mergedCounts[out] = counts[low];
+
+                if (0 == result)
+                {
+                    us->mergedCounts[out] += counts[half + high];
+                }
+            }
+
+            if (0 == result)
+            {
+                high++;         /* drop the equal item from the high half */
+            }
+
+            low++;
+        }
+        else
+        {
+            CopyItem(VoidPtrOffset(us->merged, out * itemSize),
+                VoidPtrOffset(highList, high * itemSize), itemSize);
+
+            if (NULL != counts)
+            {
+                us->mergedCounts[out] = counts[half + high];
+            }
+
+            high++;
+        }
+
+        out++;
+    }
+
+    /* the rest of the low half */
+    CopyItems(VoidPtrOffset(us->merged, out * itemSize),
+        VoidPtrOffset(list, low * itemSize), lowEnd - low, itemSize);
+
+    if (NULL != counts)
+    {
+        memcpy(us->mergedCounts + out, counts + low,
+            (lowEnd - low) * sizeof(size_t));
+    }
+
+    out += lowEnd - low;
+
+    /* the rest of the high half */
+    CopyItems(VoidPtrOffset(us->merged, out * itemSize),
+        VoidPtrOffset(highList, high * itemSize), highEnd - high, itemSize);
+
+    if (NULL != counts)
+    {
+        memcpy(us->mergedCounts + out, counts + half + high,
+            (highEnd - high) * sizeof(size_t));
+    }
+
+    out += highEnd - high;
+
+    CopyItems(list, us->merged, out, itemSize);
+
+    if (NULL != counts)
+    {
+        memcpy(counts, us->mergedCounts, out * sizeof(size_t));
+    }
+
+    StatLeave();
+    return out;
+}
+
+/***************************************************************************
+*   Function   : UniqueInsertionSort
+*   Description: This function sorts a small list and removes its
+*                duplicates.  Each item is found in the distinct items
+*                sorted so far with a binary search.  If an equal item is
+*                found, its count goes up and the new item is dropped.
+*                Otherwise the new item is inserted.
+*   Parameters : us - buffers and parameters of the sort
+*                list - a pointer of an array of items to sort
+*                counts - counts of the items in list, NULL if not counting
+*                numItems - number of items in the array
+*   Effects    : The distinct items of list are sorted to its start, and
+*                their counts are written to counts
+*   Returned   : The number of distinct items.
+***************************************************************************/
+static size_t UniqueInsertionSort(const unique_sort_t *us, void *list,
+    size_t *counts, size_t numItems)
+{
+    size_t i, numUnique, low, high, mid, itemSize;
+    int result;
+    void *item;
+
+    if (0 == numItems)
+    {
+        return 0;
+    }
+
+    itemSize = us->itemSize;
+    numUnique = 1;
+
+    if (NULL != counts)
+    {
+        counts[0] = 1;
+    }
+
+    for (i = 1; i < numItems; i++)
+    {
+        item = VoidPtrOffset(list, i * itemSize);
+
+        /* find the first distinct item that isn't ordered before item */
+        low = 0;
+        high = numUnique;
+        result = 1;
+
+        while (low < high)
+        {
+            mid = low + ((high - low) / 2);
+            result = CompareItems(us->compareFunc, item,
+                VoidPtrOffset(list, mid * itemSize));
+
+            if (0 == result)
+            {
+                low = mid;
+                break;
+            }
+
+            if (result < 0)
+            {
+                high = mid;
+            }
+            else
+            {
+                low = mid + 1;
+            }
+        }
+
+        if (0 == result)
+        {
+            /* a duplicate */
+            if (NULL != counts)
+            {
+                counts[low]++;
+            }
+
+            continue;
+        }
+
+        /* insert item at list[low] */
+        CopyItem(us->temp, item, itemSize);
+        MoveItems(VoidPtrOffset(list, (low + 1) * itemSize),
+            VoidPtrOffset(list, low * itemSize), numUnique - low, itemSize);
+        CopyItem(VoidPtrOffset(list, low * itemSize), us->temp, itemSize);
+
+        if (NULL != counts)
+        {
+            memmove(counts + low + 1, counts + low,
+                (numUnique - low) * sizeof(size_t));
+            counts[low] = 1;
+        }
+
+        numUnique++;
+    }
+
+    return numUnique;
+}
+
+/***************************************************************************
+*   Function   : UniqueHeapSort
+*   Description: This function heap sorts a list and then removes its
+*                duplicates in place.  It needs no scratch memory, so
+*                SortUnique and SortCountRuns fall back to it when there
+*                isn't any.  Heap sort isn't stable, so the item kept from
+*                each group of equal items may be any one of them.
+*   Parameters : list - a pointer of an array of items to sort
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function (see SortUnique)
+*                counts - array of numItems counts, NULL if not counting
+*   Effects    : The distinct items of list are sorted to its start, and
+*                their counts are written to counts
+*   Returned   : The number of distinct items.
+***************************************************************************/
+static size_t UniqueHeapSort(void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), size_t *counts)
+{
+    size_t i, numUnique;
+    void *last;
+
+    if (0 == numItems)
+    {
+        return 0;
+    }
+
+    HeapSortCtx(NULL, list, numItems, itemSize, compareFunc);
+    numUnique = 1;
+
+    if (NULL != counts)
+    {
+        counts[0] = 1;
+    }
+
+    for (i = 1; i < numItems; i++)
+    {
+        last = VoidPtrOffset(list, (numUnique - 1) * itemSize);
+
+        if (0 == CompareItems(compareFunc, last,
+            VoidPtrOffset(list, i * itemSize)))
+        {
+            /* a duplicate */
+            if (NULL != counts)
+            {
+                counts[numUnique - 1]++;
+            }
+
+            continue;
+        }
+
+        if (numUnique != i)
+        {
+            CopyItem(VoidPtrOffset(list, numUnique * itemSize),
+                VoidPtrOffset(list, i * itemSize), itemSize);
+        }
+
+        if (NULL != counts)
+        {
+            counts[numUnique] = 1;
+        }
+
+        numUnique++;
+    }
+
+    return numUnique;
+}
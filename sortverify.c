@@ -0,0 +1,516 @@
+/***************************************************************************
+*                     Collection of Sorting Algorithms
+*
+*   File    : sortverify.c
+*   Purpose : This module implements checks of sort results that are cheap
+*             enough to leave on.  SortFindUnsorted finds the first item
+*             that is out of order, comparing lists of native numeric keys
+*             directly in blocks that the compiler can vectorize and
+*             splitting long lists among threads.  SortMultisetHash hashes
+*             a list without regard to order, so the hashes of a list
+*             before and after sorting match only if nothing was lost or
+*             duplicated.  SortIsSorted is a quick check that the sorts use
+*             to skip lists that are already sorted.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+* sort: An ANSI C collection of sort algorithms.
+*       I have implemented these algorithms out of personal interest.  They
+*       are not inteded to be the best or the fastest.  They are intended
+*       to be flexible, portable examples of techniques used to sort items.
+*
+* Copyright (C) 2026 by
+*       Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the sort library.
+*
+* The sort library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The sort library is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include "sort.h"
+#include "sortint.h"
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* numeric keys are compared this many at a time without branching */
+#define SCAN_BLOCK_ITEMS    64
+
+/* 32-bit FNV-1a hash parameters */
+#define FNV_OFFSET_BASIS    2166136261UL
+#define FNV_PRIME           16777619UL
+
+#define MASK_32             0xFFFFFFFFUL
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* a list being checked by several threads */
+typedef struct
+{
+    const void *list;           /* list being checked */
+    size_t numItems;            /* number of items in list */
+    size_t itemSize;            /* size of each item */
+    int (*compareFunc) (const void *, const void *);
+    sort_key_t keyType;         /* numeric key type, SORT_KEY_NONE if none */
+    unsigned int numThreads;    /* number of threads */
+    size_t *found;              /* first unsorted item found by each thread */
+    unsigned long *hashes;      /* hash of each thread's items */
+} verify_job_t;
+
+/***************************************************************************
+*                                 MACROS
+***************************************************************************/
+/***************************************************************************
+* Define a function that returns the first index in [first, last) of a key
+* that is less than the key before it, or last if there isn't one.  Each
+* block of keys is checked with a loop that has no branches so that it may
+* be vectorized, and only a block with a key out of order is searched.
+***************************************************************************/
+#define DEFINE_FIND_UNSORTED(name, type)                                \
+static size_t name(const void *list, size_t first, size_t last)         \
+{                                                                       \
+    const type *keys;                                                   \
+    size_t i, j, end;                                                   \
+    int outOfOrder;                                                     \
+                                                                        \
+    keys = (const type *)list;                                          \
+                                                                        \
+    for (i = first; i < last; i = end)                                  \
+    {                                                                   \
+        end = ((last - i) > SCAN_BLOCK_ITEMS) ?                         \
+            (i + SCAN_BLOCK_ITEMS) : last;                              \
+        outOfOrder = 0;                                                 \
+                                                                        \
+        for (j = i; j < end; j++)                                       \
+        {                                                               \
+            outOfOrder |= (keys[j - 1] > keys[j]);                      \
+        }                                                               \
+                                                                        \
+        if (outOfOrder)                                                 \
+        {                                                               \
+            for (j = i; !(keys[j - 1] > keys[j]); j++)                 \
+            {                                                           \
+                /* the block has a key out of order */                  \
+            }                                                           \
+                                                                        \
+            return j;                                                   \
+        }                                                               \
+    }                                                                   \
+                                                                        \
+    return last;                                                        \
+}
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static size_t FindUnsortedRange(const verify_job_t *job, size_t first,
+    size_t last);
+static void FindUnsortedThread(void *arg, unsigned int thread);
+static void HashThread(void *arg, unsigned int thread);
+static unsigned int LimitThreads(unsigned int numThreads, size_t numItems);
+static size_t NativeKeySize(sort_key_t keyType);
+
+/* block scans of native numeric keys */
+DEFINE_FIND_UNSORTED(FindUnsortedInt, int)
+DEFINE_FIND_UNSORTED(FindUnsortedUInt, unsigned int)
+DEFINE_FIND_UNSORTED(FindUnsortedLong, long)
+DEFINE_FIND_UNSORTED(FindUnsortedULong, unsigned long)
+DEFINE_FIND_UNSORTED(FindUnsortedFloat, float)
+DEFINE_FIND_UNSORTED(FindUnsortedDouble, double)
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : SortFindUnsorted
+*   Description: This function finds the first item of a list that is
+*                ordered before the item preceding it.  If keyType is a
+*                native numeric type and itemSize is the size of that
+*                type, the list is an array of keys that are compared
+*                directly in blocks; otherwise compareFunc is used.  Long
+*                lists are divided among threads, and each thread also
+*                checks the first item of its range against the last item
+*                of the range before it.
+*   Parameters : list - a pointer to an array of items
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*                keyType - type of the items, SORT_KEY_NONE to use
+*                          compareFunc
+*                numThreads - most threads to use, 0 for one per processor
+*   Effects    : NONE
+*   Returned   : Index of the first item out of order, numItems if the list
+*                is sorted.
+***************************************************************************/
+size_t SortFindUnsorted(const void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *), sort_key_t keyType,
+    unsigned int numThreads)
+{
+    verify_job_t job;
+    size_t found;
+    unsigned int i;
+
+    if (numItems <= 1)
+    {
+        return numItems;
+    }
+
+    if (itemSize != NativeKeySize(keyType))
+    {
+        keyType = SORT_KEY_NONE;    /* not an array of native keys */
+    }
+
+    job.list = list;
+    job.numItems = numItems;
+    job.itemSize = itemSize;
+    job.compareFunc = compareFunc;
+    job.keyType = keyType;
+    job.numThreads = LimitThreads(numThreads, numItems);
+    job.found = NULL;
+
+    if (job.numThreads > 1)
+    {
+        job.found = (size_t *)ScratchAlloc(job.numThreads * sizeof(size_t));
+    }
+
+    if (NULL == job.found)
+    {
+        found = FindUnsortedRange(&job, 1, numItems);
+        return (found < numItems) ? found : numItems;
+    }
+
+    SortRunThreads(job.numThreads, FindUnsortedThread, &job);
+
+    /* the first thread to find an item out of order found the first one */
+    found = numItems;
+
+    for (i = 0; i < job.numThreads; i++)
+    {
+        if (job.found[i] < numItems)
+        {
+            found = job.found[i];
+            break;
+        }
+    }
+
+    ScratchFree(job.found, job.numThreads * sizeof(size_t));
+    return found;
+}
+
+/***************************************************************************
+*   Function   : SortIsSorted
+*   Description: This function checks if a list is already sorted, one
+*                pair of items at a time on the calling thread.  It stops
+*                at the first pair out of order, so for most unsorted lists
+*                it costs a few comparisons, and for a sorted list it costs
+*                less than sorting.  The sorts use it to skip work.
+*   Parameters : list - a pointer to an array of items
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                compareFunc - a comparison function such that:
+*                   compareFunc(x, y) < 0  iff x precedes y
+*                   compareFunc(x, y) = 0  iff x and y are ordered the same
+*                   compareFunc(x, y) > 0  iff y precedes x
+*   Effects    : NONE
+*   Returned   : 1 if the list is sorted, otherwise 0.
+***************************************************************************/
+int SortIsSorted(const void *list, size_t numItems, size_t itemSize,
+    int (*compareFunc) (const void *, const void *))
+{
+    const char *item, *last;
+
+    if (numItems <= 1)
+    {
+        return TRUE;
+    }
+
+    last = (const char *)list + ((numItems - 1) * itemSize);
+
+    for (item = (const char *)list; item < last; item += itemSize)
+    {
+        if (CompareItems(compareFunc, item, item + itemSize) > 0)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/***************************************************************************
+*   Function   : SortMultisetHash
+*   Description: This function computes a hash of a list that doesn't
+*                depend on the order of its items.  Each item's bytes are
+*                hashed with FNV-1a, the hash is mixed, and the mixed
+*                hashes are added.  A list hashes the same before and after
+*                it is sorted, and losing or duplicating an item almost
+*                certainly changes the hash.  Items are compared byte for
+*                byte, so any padding bytes must be set the same way.
+*   Parameters : list - a pointer to an array of items
+*                numItems - number of items in the array
+*                itemSize - size of each item in the array
+*                numThreads - most threads to use, 0 for one per processor
+*   Effects    : NONE
+*   Returned   : The hash of the list.
+***************************************************************************/
+unsigned long SortMultisetHash(const void *list, size_t numItems,
+    size_t itemSize, unsigned int numThreads)
+{
+    verify_job_t job;
+    unsigned long hash;
+    unsigned int i;
+
+    job.list = list;
+    job.numItems = numItems;
+    job.itemSize = itemSize;
+    job.numThreads = LimitThreads(numThreads, numItems);
+    job.hashes = NULL;
+
+    if (job.numThreads > 1)
+    {
+        job.hashes = (unsigned long *)ScratchAlloc(job.numThreads *
+            sizeof(unsigned long));
+    }
+
+    if (NULL == job.hashes)
+    {
+        job.numThreads = 1;
+        job.hashes = &hash;
+        HashThread(&job, 0);
+        return hash;
+    }
+
+    SortRunThreads(job.numThreads, HashThread, &job);
+    hash = 0;
+
+    for (i = 0; i < job.numThreads; i++)
+    {
+        hash = (hash + job.hashes[i]) & MASK_32;
+    }
+
+    ScratchFree(job.hashes, job.numThreads * sizeof(unsigned long));
+    return hash;
+}
+
+/***************************************************************************
+*   Function   : FindUnsortedRange
+*   Description: This function finds the first item from list[first] up to
+*                list[last - 1] that is ordered before the item preceding
+*                it.
+*   Parameters : job - the list being checked
+*                first - first item to check (at least 1)
+*                last - item after the last item to check
+*   Effects    : NONE
+*   Returned   : Index of the first item out of order, last if there isn't
+*                one.
+***************************************************************************/
+static size_t FindUnsortedRange(const verify_job_t *job, size_t first,
+    size_t last)
+{
+    const char *item;
+    size_t i;
+
+    switch (job->keyType)
+    {
+        case SORT_KEY_INT:
+            return FindUnsortedInt(job->list, first, last);
+
+        case SORT_KEY_UINT:
+            return FindUnsortedUInt(job->list, first, last);
+
+        case SORT_KEY_LONG:
+            return FindUnsortedLong(job->list, first, last);
+
+        case SORT_KEY_ULONG:
+            return FindUnsortedULong(job->list, first, last);
+
+        case SORT_KEY_FLOAT:
+            return FindUnsortedFloat(job->list, first, last);
+
+        case SORT_KEY_DOUBLE:
+            return FindUnsortedDouble(job->list, first, last);
+
+        default:
+            break;
+    }
+
+    item = (const char *)job->list + (first * job->itemSize);
+
+    for (i = first; i < last; i++)
+    {
+        if (CompareItems(job->compareFunc, item - job->itemSize, item) > 0)
+        {
+            return i;
+        }
+
+        item += job->itemSize;
+    }
+
+    return last;
+}
+
+/***************************************************************************
+*   Function   : FindUnsortedThread
+*   Description: This function is called by each thread of
+*                SortFindUnsorted.  The items from 1 to numItems - 1 are
+*                divided evenly among the threads, and each item is
+*                checked against the one before it, so the first item of
+*                each thread's range is checked against the last item of
+*                the previous range.
+*   Parameters : arg - pointer to the verify_job_t
+*                thread - index of this thread
+*   Effects    : job->found[thread] is the first item out of order in the
+*                thread's range, numItems if there isn't one.
+*   Returned   : NONE
+***************************************************************************/
+static void FindUnsortedThread(void *arg, unsigned int thread)
+{
+    verify_job_t *job;
+    size_t first, last, span;
+
+    job = (verify_job_t *)arg;
+    span = (job->numItems - 1) / job->numThreads;
+    first = 1 + (thread * span);
+    last = (thread == (job->numThreads - 1)) ? job->numItems :
+        (first + span);
+
+    job->found[thread] = FindUnsortedRange(job, first, last);
+
+    if (job->found[thread] == last)
+    {
+        job->found[thread] = job->numItems;
+    }
+}
+
+/***************************************************************************
+*   Function   : HashThread
+*   Description: This function is called by each thread of
+*                SortMultisetHash to hash its share of the items.
+*   Parameters : arg - pointer to the verify_job_t
+*                thread - index of this thread
+*   Effects    : job->hashes[thread] is the sum of the thread's item hashes
+*   Returned   : NONE
+***************************************************************************/
+static void HashThread(void *arg, unsigned int thread)
+{
+    verify_job_t *job;
+    const unsigned char *item;
+    size_t first, last, span, i, j;
+    unsigned long hash, sum;
+
+    job = (verify_job_t *)arg;
+    span = job->numItems / job->numThreads;
+    first = thread * span;
+    last = (thread == (job->numThreads - 1)) ? job->numItems :
+        (first + span);
+
+    item = (const unsigned char *)job->list + (first * job->itemSize);
+    sum = 0;
+
+    for (i = first; i < last; i++)
+    {
+        hash = FNV_OFFSET_BASIS;
+
+        for (j = 0; j < job->itemSize; j++)
+        {
+            hash = ((hash ^ item[j]) * FNV_PRIME) & MASK_32;
+        }
+
+        /* mix the bits so sums of similar items don't cancel */
+        hash ^= hash >> 16;
+        hash = (hash * 0x85EBCA6BUL) & MASK_32;
+        hash ^= hash >> 13;
+        hash = (hash * 0xC2B2AE35UL) & MASK_32;
+        hash ^= hash >> 16;
+
+        sum = (sum + hash) & MASK_32;
+        item += job->itemSize;
+    }
+
+    job->hashes[thread] = sum;
+}
+
+/***************************************************************************
+*   Function   : LimitThreads
+*   Description: This function limits the number of threads used to check
+*                a list to the number that each get a grain of items.
+*   Parameters : numThreads - threads requested, 0 for one per processor
+*                numItems - number of items in the list
+*   Effects    : NONE
+*   Returned   : Number of threads to use (at least 1)
+***************************************************************************/
+static unsigned int LimitThreads(unsigned int numThreads, size_t numItems)
+{
+    if (0 == numThreads)
+    {
+        numThreads = SortDefaultThreads();
+    }
+
+    /* there's no point in threads that won't get a grain of work */
+    if ((numItems / sortTuning.parallelGrain) < numThreads)
+    {
+        numThreads = (unsigned int)(numItems / sortTuning.parallelGrain);
+
+        if (0 == numThreads)
+        {
+            numThreads = 1;
+        }
+    }
+
+    return numThreads;
+}
+
+/***************************************************************************
+*   Function   : NativeKeySize
+*   Description: This function returns the size of a numeric key type.
+*   Parameters : keyType - type of the key
+*   Effects    : NONE
+*   Returned   : Size of the key in bytes, 0 for SORT_KEY_NONE.
+***************************************************************************/
+static size_t NativeKeySize(sort_key_t keyType)
+{
+    switch (keyType)
+    {
+        case SORT_KEY_INT:
+            return sizeof(int);
+
+        case SORT_KEY_UINT:
+            return sizeof(unsigned int);
+
+        case SORT_KEY_LONG:
+            return sizeof(long);
+
+        case SORT_KEY_ULONG:
+            return sizeof(unsigned long);
+
+        case SORT_KEY_FLOAT:
+            return sizeof(float);
+
+        case SORT_KEY_DOUBLE:
+            return sizeof(double);
+
+        default:
+            return 0;
+    }
+}